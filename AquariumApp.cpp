@@ -0,0 +1,142 @@
+/**
+ * @file AquariumApp.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include "AquariumApp.h"
+#include <MainFrame.h>
+#include <VideoExporter.h>
+#include <ThreadPool.h>
+#include <wx/filename.h>
+
+/// Command line options
+static const wxCmdLineEntryDesc CommandLine[] = {
+    {wxCMD_LINE_OPTION, nullptr, "export", "render this tank file to a video with no window, then exit"},
+    {wxCMD_LINE_OPTION, nullptr, "output", "where --export writes: a .y4m file, or the start of PNG filenames"},
+    {wxCMD_LINE_OPTION, nullptr, "seconds", "simulated seconds to export (default 10)", wxCMD_LINE_VAL_DOUBLE},
+    {wxCMD_LINE_OPTION, nullptr, "fps", "frames per second to export (default 30)", wxCMD_LINE_VAL_NUMBER},
+    {wxCMD_LINE_OPTION, nullptr, "format", "png or y4m (default from the output's extension)"},
+    {wxCMD_LINE_NONE}
+};
+
+/**
+ * Initialize the application.
+ * @return True to run the application
+ */
+bool AquariumApp::OnInit()
+{
+    if (!wxApp::OnInit())
+    {
+        return false;
+    }
+
+    // Add image type handlers
+    wxInitAllImageHandlers();
+
+    if (!mExportTank.empty())
+    {
+        // OnRun returns this rather than starting the event loop
+        mExitCode = RunExport();
+        return true;
+    }
+
+    auto frame = new MainFrame();
+    frame->Initialize();
+    frame->Show(true);
+
+    return true;
+}
+
+/**
+ * Add our options to the command line parser
+ * @param parser Command line parser
+ */
+void AquariumApp::OnInitCmdLine(wxCmdLineParser &parser)
+{
+    wxApp::OnInitCmdLine(parser);
+    parser.SetDesc(CommandLine);
+}
+
+/**
+ * Read our options from the parsed command line
+ * @param parser Command line parser
+ * @return False to exit because the options are wrong
+ */
+bool AquariumApp::OnCmdLineParsed(wxCmdLineParser &parser)
+{
+    if (!wxApp::OnCmdLineParsed(parser))
+    {
+        return false;
+    }
+
+    parser.Found("export", &mExportTank);
+    parser.Found("output", &mExportOutput);
+    parser.Found("format", &mExportFormat);
+    parser.Found("seconds", &mExportSeconds);
+    parser.Found("fps", &mExportFrameRate);
+
+    if (!mExportTank.empty() && mExportOutput.empty())
+    {
+        wxMessageOutput::Get()->Printf(L"--export needs --output");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Run the application
+ * @return Exit status
+ */
+int AquariumApp::OnRun()
+{
+    if (!mExportTank.empty())
+    {
+        return mExitCode;
+    }
+
+    return wxApp::OnRun();
+}
+
+/**
+ * Render the tank file given with --export.
+ * @return Exit status: 0 if every frame was written, 1 if not
+ */
+int AquariumApp::RunExport()
+{
+    auto output = wxFileName(mExportOutput);
+    auto format = mExportFormat.Lower();
+    if (format.empty())
+    {
+        format = output.GetExt().Lower() == L"y4m" ? L"y4m" : L"png";
+    }
+
+    if ((format != L"png" && format != L"y4m") || mExportSeconds <= 0 || mExportFrameRate <= 0)
+    {
+        wxMessageOutput::Get()->Printf(L"Nothing to export: check --format, --seconds and --fps");
+        return 1;
+    }
+
+    VideoExporter exporter(ThreadPool::GetDefault());
+    exporter.SetFrameRate((int)mExportFrameRate);
+    if (format == L"y4m")
+    {
+        exporter.SetFormat(VideoExporter::Format::Y4m);
+    }
+    else
+    {
+        // A PNG sequence is named after the output, without its extension
+        output.ClearExt();
+    }
+
+    if (!exporter.ExportFile(mExportTank.ToStdWstring(), output.GetFullPath().ToStdString(), mExportSeconds))
+    {
+        wxMessageOutput::Get()->Printf(L"Export of %s failed after %ld frames", mExportTank, exporter.GetFrames());
+        return 1;
+    }
+
+    wxMessageOutput::Get()->Printf(L"Exported %ld frames at %.1f frames per second",
+            exporter.GetFrames(), exporter.GetFramesPerSecond());
+    return 0;
+}
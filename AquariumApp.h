@@ -0,0 +1,53 @@
+/**
+ * @file AquariumApp.h
+ * @author Ismail Abdi
+ *
+ * Main application class.
+ */
+
+#ifndef AQUARIUM_AQUARIUMAPP_H
+#define AQUARIUM_AQUARIUMAPP_H
+
+#include <wx/cmdline.h>
+
+/**
+ * Main application class.
+ *
+ * Normally opens the main window. Given --export, it renders a
+ * tank file to a video instead, with no window at all, and exits
+ * with a status saying whether it worked, so long renders can be
+ * run from a script or overnight.
+ */
+class AquariumApp : public wxApp {
+private:
+    /// Tank file to export, or empty to open the window
+    wxString mExportTank;
+
+    /// Where the export goes
+    wxString mExportOutput;
+
+    /// Export format name, "png" or "y4m", or empty to go by the output's extension
+    wxString mExportFormat;
+
+    /// Simulated seconds to export
+    double mExportSeconds = 10;
+
+    /// Frames per second of the export
+    long mExportFrameRate = 30;
+
+    /// Exit status of a command line export
+    int mExitCode = 0;
+
+    int RunExport();
+
+public:
+    bool OnInit() override;
+
+    void OnInitCmdLine(wxCmdLineParser &parser) override;
+
+    bool OnCmdLineParsed(wxCmdLineParser &parser) override;
+
+    int OnRun() override;
+};
+
+#endif //AQUARIUM_AQUARIUMAPP_H
@@ -0,0 +1,141 @@
+/**
+ * @file AlphaMask.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "AlphaMask.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor. Creates a fully transparent mask.
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+AlphaMask::AlphaMask(int width, int height) :
+    mWidth(width), mHeight(height), mStride((width + 63) / 64),
+    mBits((size_t)mStride * height, 0)
+{
+}
+
+/**
+ * Constructor. Builds the mask from an alpha channel.
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param alpha One alpha byte per pixel, row by row
+ */
+AlphaMask::AlphaMask(int width, int height, const unsigned char *alpha) : AlphaMask(width, height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *row = alpha + (size_t)y * width;
+        uint64_t *bits = &mBits[(size_t)y * mStride];
+        for (int x = 0; x < width; x++)
+        {
+            if (row[x] >= AlphaThreshold)
+            {
+                bits[x >> 6] |= uint64_t(1) << (x & 63);
+            }
+        }
+    }
+}
+
+/**
+ * Get the mask flipped left to right
+ * @return Mirrored mask
+ */
+AlphaMask AlphaMask::Mirror() const
+{
+    AlphaMask mirror(mWidth, mHeight);
+    for (int y = 0; y < mHeight; y++)
+    {
+        for (int x = 0; x < mWidth; x++)
+        {
+            if (IsOpaque(x, y))
+            {
+                mirror.Set(mWidth - 1 - x, y, true);
+            }
+        }
+    }
+
+    return mirror;
+}
+
+/**
+ * Count the opaque pixels
+ * @return Number of opaque pixels
+ */
+size_t AlphaMask::CountOpaque() const
+{
+    size_t count = 0;
+    for (auto word : mBits)
+    {
+        while (word != 0)
+        {
+            word &= word - 1;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Get 64 bits of a row starting at any bit position.
+ * Bits outside the mask read as transparent.
+ * @param y Row
+ * @param start X of the first bit, may be negative
+ * @return Bits start .. start + 63
+ */
+uint64_t AlphaMask::GetBits(int y, int start) const
+{
+    const uint64_t *row = &mBits[(size_t)y * mStride];
+
+    // Floor division so negative starts land in the word before
+    int word = start >= 0 ? start / 64 : -((-start + 63) / 64);
+    int shift = start - word * 64;
+
+    uint64_t low = (word >= 0 && word < mStride) ? row[word] : 0;
+    if (shift == 0)
+    {
+        return low;
+    }
+
+    uint64_t high = (word + 1 >= 0 && word + 1 < mStride) ? row[word + 1] : 0;
+    return (low >> shift) | (high << (64 - shift));
+}
+
+/**
+ * Do any opaque pixels of two masks overlap?
+ * @param other The other mask
+ * @param dx X of the other mask's left edge relative to this mask's
+ * @param dy Y of the other mask's top edge relative to this mask's
+ * @return True if at least one pixel is opaque in both
+ */
+bool AlphaMask::Overlaps(const AlphaMask &other, int dx, int dy) const
+{
+    int top = max(0, dy);
+    int bottom = min(mHeight, dy + other.mHeight);
+    int left = max(0, dx);
+    int right = min(mWidth, dx + other.mWidth);
+    if (top >= bottom || left >= right)
+    {
+        return false;
+    }
+
+    for (int y = top; y < bottom; y++)
+    {
+        const uint64_t *row = &mBits[(size_t)y * mStride];
+        for (int word = left / 64; word * 64 < right; word++)
+        {
+            if (row[word] & other.GetBits(y - dy, word * 64 - dx))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file AlphaMask.h
+ * @author Ismail Abdi
+ *
+ * Packed one bit per pixel opacity mask.
+ */
+
+#ifndef AQUARIUM_ALPHAMASK_H
+#define AQUARIUM_ALPHAMASK_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Packed one bit per pixel opacity mask.
+ *
+ * Each row is stored as 64-bit words, so testing a pixel is an
+ * index and a shift, and testing two masks for overlap compares
+ * 64 pixels at a time.
+ */
+class AlphaMask {
+private:
+    /// Width in pixels
+    int mWidth = 0;
+
+    /// Height in pixels
+    int mHeight = 0;
+
+    /// Words in each row
+    int mStride = 0;
+
+    /// The bits, row by row; bit x % 64 of word x / 64 is pixel x
+    std::vector<uint64_t> mBits;
+
+    uint64_t GetBits(int y, int start) const;
+
+public:
+    /// Alpha values at or above this are opaque (matches wxImage::IsTransparent)
+    static const int AlphaThreshold = 128;
+
+    AlphaMask() = default;
+
+    AlphaMask(int width, int height);
+
+    AlphaMask(int width, int height, const unsigned char *alpha);
+
+    /**
+     * Width of the mask
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Height of the mask
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Is a pixel opaque? Pixels outside the mask are not.
+     * @param x X location in pixels
+     * @param y Y location in pixels
+     * @return True if opaque
+     */
+    bool IsOpaque(int x, int y) const
+    {
+        if ((unsigned)x >= (unsigned)mWidth || (unsigned)y >= (unsigned)mHeight)
+        {
+            return false;
+        }
+
+        return (mBits[(size_t)y * mStride + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /**
+     * Set a pixel opaque or transparent
+     * @param x X location in pixels
+     * @param y Y location in pixels
+     * @param opaque True for opaque
+     */
+    void Set(int x, int y, bool opaque)
+    {
+        auto &word = mBits[(size_t)y * mStride + (x >> 6)];
+        uint64_t bit = uint64_t(1) << (x & 63);
+        word = opaque ? (word | bit) : (word & ~bit);
+    }
+
+    AlphaMask Mirror() const;
+
+    size_t CountOpaque() const;
+
+    bool Overlaps(const AlphaMask &other, int dx, int dy) const;
+
+    /**
+     * Memory used by the bits
+     * @return Size in bytes
+     */
+    size_t GetByteSize() const { return mBits.size() * sizeof(uint64_t); }
+};
+
+#endif //AQUARIUM_ALPHAMASK_H
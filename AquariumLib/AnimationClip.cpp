@@ -0,0 +1,83 @@
+/**
+ * @file AnimationClip.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "AnimationClip.h"
+#include "Sprite.h"
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Constructor. Nothing is decoded until it is drawn.
+ * @param sprites Cache the frames are loaded through
+ * @param filenames Image filename for each frame, in order
+ */
+AnimationClip::AnimationClip(std::shared_ptr<SpriteCache> sprites, const std::vector<std::wstring> &filenames) :
+    mSprites(sprites), mFilenames(filenames), mFrames(new atomic<Sprite *>[filenames.size()])
+{
+    for (size_t i = 0; i < mFilenames.size(); i++)
+    {
+        mFrames[i] = nullptr;
+    }
+}
+
+/**
+ * Work out which frame to show.
+ * @param position Position in the clip, in frames. Wraps around
+ * at the end of the clip.
+ * @return Frame index
+ */
+size_t AnimationClip::FrameAt(double position) const
+{
+    double count = (double)mFilenames.size();
+    double frame = floor(fmod(position, count));
+    if (frame < 0)
+    {
+        frame += count;
+    }
+
+    // fmod can round up to exactly count for tiny negative positions
+    return min((size_t)frame, mFilenames.size() - 1);
+}
+
+/**
+ * Get a frame, decoding it if this is the first time it is used.
+ *
+ * Once a frame is decoded this is a single atomic load.
+ *
+ * @param index Frame index
+ * @return The frame
+ */
+Sprite *AnimationClip::GetFrame(size_t index)
+{
+    auto frame = mFrames[index].load(memory_order_acquire);
+    if (frame != nullptr)
+    {
+        return frame;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    frame = mFrames[index].load(memory_order_relaxed);
+    if (frame == nullptr)
+    {
+        auto sprite = mSprites->Get(mFilenames[index]);
+        mDecoded.push_back(sprite);
+        frame = sprite.get();
+        mFrames[index].store(frame, memory_order_release);
+    }
+
+    return frame;
+}
+
+/**
+ * Number of frames decoded so far
+ * @return Decoded frame count
+ */
+size_t AnimationClip::GetDecodedCount()
+{
+    lock_guard<mutex> lock(mMutex);
+    return mDecoded.size();
+}
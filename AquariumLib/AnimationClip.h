@@ -0,0 +1,75 @@
+/**
+ * @file AnimationClip.h
+ * @author Ismail Abdi
+ *
+ * The frames of an animated species.
+ */
+
+#ifndef AQUARIUM_ANIMATIONCLIP_H
+#define AQUARIUM_ANIMATIONCLIP_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Sprite;
+class SpriteCache;
+
+/**
+ * The frames of an animated species.
+ *
+ * One clip is shared by every item of the species. Frames are
+ * decoded the first time they are drawn and kept for the life of
+ * the clip. Items don't store a current frame; they work it out
+ * from the simulation time when they draw, so animation adds
+ * nothing to the per-tick update.
+ */
+class AnimationClip {
+private:
+    /// Cache the frames are loaded through
+    std::shared_ptr<SpriteCache> mSprites;
+
+    /// Image filename for each frame
+    std::vector<std::wstring> mFilenames;
+
+    /// Each frame once it has been decoded, or nullptr
+    std::unique_ptr<std::atomic<Sprite *>[]> mFrames;
+
+    /// Keeps the decoded frames alive
+    std::vector<std::shared_ptr<Sprite>> mDecoded;
+
+    /// Protects mDecoded while a frame is decoded
+    std::mutex mMutex;
+
+public:
+    AnimationClip(std::shared_ptr<SpriteCache> sprites, const std::vector<std::wstring> &filenames);
+
+    /// Copy constructor (disabled)
+    AnimationClip(const AnimationClip &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AnimationClip &) = delete;
+
+    /**
+     * Number of frames in the clip
+     * @return Frame count
+     */
+    size_t GetFrameCount() const { return mFilenames.size(); }
+
+    /**
+     * Image filename for a frame
+     * @param index Frame index
+     * @return Filename
+     */
+    const std::wstring &GetFilename(size_t index) const { return mFilenames[index]; }
+
+    size_t FrameAt(double position) const;
+
+    Sprite *GetFrame(size_t index);
+
+    size_t GetDecodedCount();
+};
+
+#endif //AQUARIUM_ANIMATIONCLIP_H
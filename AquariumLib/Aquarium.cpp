@@ -6,11 +6,20 @@
 
 #include "pch.h"
 #include "Aquarium.h"
-#include "FishBeta.h"
-#include "DecorCastle.h"
-#include "FishNemo.h"
-#include "FishGoldeen.h"
+#include "Fish.h"
+#include "SpeciesRegistry.h"
+#include "Viewport.h"
+#include "SimulationRecorder.h"
+#include "StateHash.h"
+#include "ScaledBackground.h"
+#include "ThreadPool.h"
+#include "Metrics.h"
+#include "AquariumSnapshot.h"
 #include <memory>
+#include <chrono>
+#include <cmath>
+#include <wx/file.h>
+#include <wx/mstream.h>
 
 using namespace std;
 
@@ -22,6 +31,17 @@ const int InitialY = 200;
 // The offset to use when a fish is bumped
 const double NextFishOffset = 10.0;
 
+/// Items smaller than this on screen are drawn as a single point
+const double PointLodSize = 3;
+
+/// Items smaller than this on screen are drawn as a single point when detail is reduced
+const double ReducedPointLodSize = 24;
+
+/// Bytes of the list entries each item adds: the item list, its item group and the snapshot
+const size_t ItemListBytes = sizeof(std::shared_ptr<Item>) + sizeof(Item *) + sizeof(AquariumSnapshot::ItemState);
+
+const std::wstring Aquarium::BackgroundImage = L"images/background1.png";
+
 /**
  * Perform hit testing to see if a mouse click hit any item in the aquarium.
  * @param x X coordinate of the mouse click.
@@ -51,18 +71,102 @@ void Aquarium::MoveToEnd(std::shared_ptr<Item> item)
     // If found, erase it and push it to the back of the vector
     if (loc != mItems.end())
     {
+        if (mRecorder != nullptr)
+        {
+            mRecorder->Raise(loc - mItems.begin());
+        }
+
         mItems.erase(loc);   // Remove the item from its current location
         mItems.push_back(item);  // Add it to the end (topmost)
+        mGroups.Invalidate();
+        mRevision++;
     }
 }
 
+/**
+ * Take an item out of the aquarium.
+ * @param item The item to remove.
+ * @return True if the item was in the aquarium
+ */
+bool Aquarium::Remove(std::shared_ptr<Item> item)
+{
+    auto loc = std::find(mItems.begin(), mItems.end(), item);
+    if (loc == mItems.end())
+    {
+        return false;
+    }
+
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Remove(loc - mItems.begin());
+    }
+
+    mItemBytes -= (*loc)->GetByteSize() + MemoryUsage::SharedCountBytes;
+    mItems.erase(loc);
+    mGroups.Invalidate();
+    mRevision++;
+    return true;
+}
+
 /**
  * Aquarium Constructor
+ *
+ * The tank starts out the size of the background image.
  */
-Aquarium::Aquarium()
+Aquarium::Aquarium() : mSprites(SpriteCache::GetDefault()), mSpecies(SpeciesRegistry::GetDefault())
 {
-    mBackground = make_unique<wxBitmap>(
-            L"images/background1.png", wxBITMAP_TYPE_ANY);
+    auto background = mSprites->Get(BackgroundImage);
+    mBackground = make_shared<ScaledBackground>(background, ThreadPool::GetDefault());
+    mWidth = background->GetWidth();
+    mHeight = background->GetHeight();
+    mSpeciesVersion = mSpecies->GetVersion();
+    mRegistries = std::make_shared<std::vector<std::shared_ptr<const SpeciesRegistry>>>(1, mSpecies);
+    SetTank(0);
+}
+
+/**
+ * Set the tank the aquarium is shown in, which labels the
+ * metrics of its updates and draws so each tank can be told apart
+ * @param tank Tank number, from 1, or 0 to leave the metrics unlabelled
+ */
+void Aquarium::SetTank(size_t tank)
+{
+    auto metrics = Metrics::GetDefault();
+    auto labels = tank > 0 ? Metrics::Label("tank", to_string(tank)) : string();
+    mUpdates = &metrics->Counter("aquarium_updates_total", "Aquarium updates", labels);
+    mUpdateTime = &metrics->Histogram("aquarium_update_seconds", "Time to update an aquarium", Metrics::TimeBuckets, labels);
+    mDraws = &metrics->Counter("aquarium_draws_total", "Aquarium draws", labels);
+    mDrawTime = &metrics->Histogram("aquarium_draw_seconds", "Time to draw an aquarium", Metrics::TimeBuckets, labels);
+    mDrawn = &metrics->Counter("aquarium_items_drawn_total", "Items drawn", labels);
+    mCulled = &metrics->Counter("aquarium_items_culled_total", "Items skipped because they were out of view", labels);
+}
+
+/**
+ * Change the size of the tank.
+ *
+ * The background is stretched to fill it. Fish outside the new
+ * size swim back in on their next update. The size belongs to
+ * the window rather than the items, so it isn't saved in .aqua
+ * files.
+ *
+ * @param width Tank width in pixels
+ * @param height Tank height in pixels
+ */
+void Aquarium::SetSize(int width, int height)
+{
+    if (width == mWidth && height == mHeight)
+    {
+        return;
+    }
+
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Resize(width, height);
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mRevision++;
 }
 
 /**
@@ -71,7 +175,36 @@ Aquarium::Aquarium()
  */
 void Aquarium::OnDraw(wxDC *dc)
 {
-    dc->DrawBitmap(*mBackground, 0, 0);
+    auto size = dc->GetSize();
+
+    Viewport viewport;
+    viewport.SetSize(size.GetWidth(), size.GetHeight());
+    OnDraw(dc, viewport);
+}
+
+/**
+ * Draw the part of the aquarium shown in a viewport.
+ *
+ * Items entirely outside the view are skipped, items too small
+ * to see are drawn as a single point of their average colour and
+ * everything else is drawn from the best sized mip level.
+ *
+ * @param dc The device context to draw on.
+ * @param viewport The part of the aquarium to draw.
+ */
+void Aquarium::OnDraw(wxDC *dc, const Viewport &viewport)
+{
+    MetricTimer timer(*mDrawTime);
+    mDraws->Add();
+    uint64_t outside = 0;
+
+    double zoom = viewport.GetZoom();
+
+    // With detail reduced, small items don't get mip levels and bitmaps made for them
+    double pointLodSize = mReducedDetail ? ReducedPointLodSize : PointLodSize;
+
+    mProvisional = !mBackground->Draw(dc, viewport.ToScreenX(0), viewport.ToScreenY(0),
+            (int)lround(mWidth * zoom), (int)lround(mHeight * zoom));
 
     wxFont font(wxSize(0, 20),
             wxFONTFAMILY_SWISS,
@@ -81,20 +214,102 @@ void Aquarium::OnDraw(wxDC *dc)
     dc->SetTextForeground(wxColour(0, 64, 0));
     dc->DrawText(L"Under the Sea!", 10, 10);
 
-    for (auto item : mItems)
+    // The sprite whose colour the pen is currently set to
+    const Sprite *penSprite = nullptr;
+
+    for (auto &item : mItems)
     {
-        item->Draw(dc);
+        double halfWidth = item->GetWidth() / 2.0;
+        double halfHeight = item->GetHeight() / 2.0;
+        double x = item->GetX();
+        double y = item->GetY();
+        if (!viewport.IsVisible(x - halfWidth, y - halfHeight, x + halfWidth, y + halfHeight))
+        {
+            outside++;
+            continue;
+        }
+
+        if (!mProvisional && !item->GetFrame()->IsReady())
+        {
+            mProvisional = true;
+        }
+
+        if (max(halfWidth, halfHeight) * 2 * zoom < pointLodSize)
+        {
+            auto sprite = item->GetSprite().get();
+            if (sprite != penSprite)
+            {
+                dc->SetPen(wxPen(sprite->GetColour()));
+                penSprite = sprite;
+            }
+
+            dc->DrawPoint((int)viewport.ToScreenX(x), (int)viewport.ToScreenY(y));
+            continue;
+        }
+
+        // Items can set their own pen, so don't trust the cached one after
+        item->DrawLod(dc, viewport);
+        penSprite = nullptr;
     }
+
+    mDrawn->Add(mItems.size() - outside);
+    mCulled->Add(outside);
+}
+
+/**
+ * Wait until everything the next frame draws is decoded and scaled.
+ *
+ * The window never waits for images; it draws placeholders until
+ * they are ready. Frames rendered for export can't have
+ * placeholders in them, so they call this first.
+ */
+void Aquarium::WaitForImages()
+{
+    auto background = mBackground->GetSprite();
+    background->Decode();
+    if (mWidth != background->GetWidth() || mHeight != background->GetHeight())
+    {
+        if (mBackground->GetBitmap(mWidth, mHeight) == nullptr)
+        {
+            mBackground->Wait();
+        }
+    }
+
+    // Animated items draw the frame for the current time, which
+    // may not be the first one or any the asset loader decoded
+    for (auto &item : mItems)
+    {
+        item->GetSprite()->Decode();
+        item->GetFrame()->Decode();
+    }
+}
+
+/**
+ * Count an item that wasn't added because the aquarium was over its memory budget
+ */
+static void CountRefused()
+{
+    static auto &refused = Metrics::GetDefault()->Counter("aquarium_spawns_refused_total",
+            "Items not added because the aquarium was over its memory budget");
+    refused.Add();
 }
 
 /**
  * Add an item to the aquarium.
  * This function ensures that new items do not overlap with existing ones.
  * If an overlap is detected, the item is "bumped" downwards and to the right.
+ * Nothing is added once the aquarium has used up its memory budget.
  * @param item The item to add (e.g., a fish).
+ * @return False if the aquarium is over budget, so the item wasn't added
  */
-void Aquarium::Add(std::shared_ptr<Item> item)
+bool Aquarium::Add(std::shared_ptr<Item> item)
 {
+    if (IsOverBudget())
+    {
+        CountRefused();
+        return false;
+    }
+
     item->SetLocation(InitialX, InitialY);  // Set initial location
 
     // Check for overlaps and bump the item if necessary
@@ -117,6 +332,89 @@ void Aquarium::Add(std::shared_ptr<Item> item)
     } while (bumped);  // Repeat until no more bumps are needed
 
     mItems.push_back(item);  // Finally, add the item to the list
+    mItemBytes += item->GetByteSize() + MemoryUsage::SharedCountBytes;
+    mGroups.Invalidate();
+    mRevision++;
+}
+
+/**
+ * Use a different set of species for items created from now on.
+ * Items already in the aquarium keep the species they have.
+ * @param species Species registry
+ */
+void Aquarium::SetSpecies(std::shared_ptr<SpeciesRegistry> species)
+{
+    mSpecies = species;
+    mSpeciesVersion = species->GetVersion();
+
+    // Snapshots may hold the old list, so make a new one
+    auto registries = std::make_shared<std::vector<std::shared_ptr<const SpeciesRegistry>>>(*mRegistries);
+    registries->push_back(species);
+    mRegistries = registries;
+}
+
+/**
+ * Create an item from its type name.
+ * @param type Item type, as saved in .aqua files
+ * @return New item, or nullptr if the type is unknown
+ */
+std::shared_ptr<Item> Aquarium::CreateItem(const std::wstring &type)
+{
+    return mSpecies->Create(type, this);
+}
+
+/**
+ * Add a new item of some type to the aquarium.
+ *
+ * This is what the Add menus do, so it is recorded. Nothing is
+ * added once the aquarium has used up its memory budget.
+ *
+ * @param type Item type, as saved in .aqua files
+ * @return The new item, or nullptr if the type is unknown or the aquarium is over budget
+ */
+std::shared_ptr<Item> Aquarium::Spawn(const std::wstring &type)
+{
+    // Checked before the item is made, so a full tank costs nothing
+    if (IsOverBudget())
+    {
+        CountRefused();
+        return nullptr;
+    }
+
+    auto item = CreateItem(type);
+    if (item == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Spawn(type);
+    }
+
+    Add(item);
+    return item;
+}
+
+/**
+ * Move an item to a new location, as dragging does.
+ * @param item Item to move
+ * @param x New X location
+ * @param y New Y location
+ */
+void Aquarium::MoveItem(std::shared_ptr<Item> item, double x, double y)
+{
+    if (mRecorder != nullptr)
+    {
+        auto loc = std::find(mItems.begin(), mItems.end(), item);
+        if (loc != mItems.end())
+        {
+            mRecorder->Move(loc - mItems.begin(), x, y);
+        }
+    }
+
+    item->SetLocation(x, y);
+    mRevision++;
 }
 
 /**
@@ -139,30 +437,18 @@ const std::vector<std::shared_ptr<Item>>& Aquarium::GetItems() const
 /**
  * Save the aquarium as a .aqua XML file.
  *
- * Open an XML file and stream the aquarium data to it.
+ * Writes from an up to date snapshot, the same way another
+ * thread could save the published one.
  *
  * @param filename The filename of the file to save the aquarium to
+ * @return False if the file couldn't be written
  */
-void Aquarium::Save(const wxString &filename)
+bool Aquarium::Save(const wxString &filename)
 {
-    wxXmlDocument xmlDoc;
-
-    // Create the root node
-    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
-    xmlDoc.SetRoot(root);
-
-    // Iterate over all items and save them
-    for (auto item : mItems)
-    {
-        item->XmlSave(root);
-    }
-
-    // Save the XML document to the file
-    if (!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
-    {
-        wxMessageBox(L"Write to XML failed");
-        return;
-    }
+    size_t xmlBytes = 0;
+    bool saved = Publish()->Save(filename, &xmlBytes);
+    mXmlBytes = max(mXmlBytes, xmlBytes);
+    return saved;
 }
 
 
@@ -178,27 +464,82 @@ void Aquarium::Save(const wxString &filename)
  * Opens the XML file and reads the nodes, creating items as appropriate.
  *
  * @param filename The filename of the file to load the aquarium from.
+ * @return False if the file couldn't be read
  */
-void Aquarium::Load(const wxString &filename)
+bool Aquarium::Load(const wxString &filename)
 {
+    static auto &loads = Metrics::GetDefault()->Counter("aquarium_loads_total", "Aquarium files loaded");
+    static auto &failures = Metrics::GetDefault()->Counter("aquarium_load_failures_total", "Aquarium files that couldn't be loaded");
+    static auto &loadTime = Metrics::GetDefault()->Histogram("aquarium_load_seconds", "Time to load an aquarium file");
+    MetricTimer timer(loadTime);
+    loads.Add();
+
+    // Read the whole file so a recording can hold a copy of it
+    wxFile file;
+    std::string contents;
+    if (file.Open(filename))
+    {
+        contents.resize(file.Length());
+        if (file.Read(&contents[0], contents.size()) != (ssize_t)contents.size())
+        {
+            contents.clear();
+        }
+    }
+
+    if (contents.empty() || !LoadData(contents))
+    {
+        failures.Add();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Load the aquarium from the contents of a .aqua file.
+ *
+ * Shows nothing to the user, since this may be running for the
+ * control API or a replay; the interactive caller reports failures.
+ * A file that isn't an aquarium leaves the items as they were.
+ *
+ * The memory budget applies to loaded items as well. Once it is
+ * used up the rest of the file is left out, and GetLoadRefused
+ * says how many items were; the load still counts as a success.
+ *
+ * @param contents The XML text
+ * @return False if the text isn't an aquarium XML document
+ */
+bool Aquarium::LoadData(const std::string &contents)
+{
+    wxMemoryInputStream stream(contents.data(), contents.size());
     wxXmlDocument xmlDoc;
-    if (!xmlDoc.Load(filename))
+    if (!xmlDoc.Load(stream))
     {
-        wxMessageBox(L"Unable to load Aquarium file");
-        return;
+        return false;
     }
 
-    // Clear the current aquarium data
-    Clear();
+    mXmlBytes = max(mXmlBytes, contents.size() + MemoryUsage::XmlBytes(xmlDoc.GetRoot()));
 
     // Get the root node (should be <aqua>)
     auto root = xmlDoc.GetRoot();
     if (!root || root->GetName() != L"aqua")
     {
-        wxMessageBox(L"Invalid aquarium file");
-        return;
+        return false;
+    }
+
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Load(contents);
     }
 
+    // Clear the current aquarium data. This is part of the load,
+    // so it goes straight to the items rather than being recorded.
+    mItems.clear();
+    mItemBytes = 0;
+    mLoadRefused = 0;
+    mGroups.Invalidate();
+    mRevision++;
+
     // Traverse the children of the root node
     auto child = root->GetChildren();
     for (; child; child = child->GetNext())
@@ -209,6 +550,8 @@ void Aquarium::Load(const wxString &filename)
             XmlItem(child);
         }
     }
+
+    return true;
 }
 
 
@@ -217,8 +560,16 @@ void Aquarium::Load(const wxString &filename)
 
 void Aquarium::Clear()
 {
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Clear();
+    }
+
     // Clear the vector that holds all items (fish, decor, etc.)
     mItems.clear();
+    mItemBytes = 0;
+    mGroups.Invalidate();
+    mRevision++;
 }
 
 
@@ -228,51 +579,305 @@ void Aquarium::Clear()
  */
 void Aquarium::XmlItem(wxXmlNode *node)
 {
-    // A pointer for the item we are loading
-    std::shared_ptr<Item> item;
-
     // We have an item. What type?
     auto type = node->GetAttribute(L"type");
-    if (type == L"beta")
+    auto item = CreateItem(type.ToStdWstring());
+
+    // If an item was created, add it to the aquarium and load its attributes
+    if (item != nullptr)
+    {
+        if (!Add(item))
+        {
+            mLoadRefused++;
+            return;
+        }
+
+        item->XmlLoad(node);  // Load common attributes like x, y
+    }
+}
+
+
+/**
+ * Handle updates for animation.
+ * @param elapsed The time since the last update
+ */
+void Aquarium::Update(double elapsed)
+{
+    MetricTimer timer(*mUpdateTime);
+    mUpdates->Add();
+
+    // Changes from other threads go in before anything moves
+    mCommands.Drain([this](const std::function<void(Aquarium &)> &command) { command(*this); });
+
+    mTime += elapsed;
+
+    // Pick up tuned species once per tick rather than per fish
+    auto version = mSpecies->GetVersion();
+    if (version != mSpeciesVersion)
     {
-        item = std::make_shared<FishBeta>(this);
+        mSpeciesVersion = version;
+        for (auto &item : mItems)
+        {
+            auto species = item->GetSpecies();
+            auto tuned = species != nullptr ? mSpecies->Find(species->mName) : nullptr;
+            if (tuned != nullptr && tuned != species && SpeciesRegistry::IsTuning(*species, *tuned))
+            {
+                item->Retune(tuned);
+            }
+        }
+
+        // Scripted fish are grouped by the script of their species
+        mGroups.Invalidate();
+        mRevision++;
     }
-    else if (type == L"nemo")
+
+    if (mSchooling)
     {
-        item = std::make_shared<FishNemo>(this);
+        // Steer from positions at the start of the tick, before anyone moves
+        mSchoolFish.clear();
+        for (auto &item : mItems)
+        {
+            auto fish = dynamic_cast<Fish*>(item.get());
+            if (fish != nullptr)
+            {
+                mSchoolFish.push_back(fish);
+            }
+        }
+
+        mSchool.Steer(mSchoolFish, elapsed);
     }
-    else if (type == L"goldeen")
+
+    // A loop per class of item rather than a virtual call per item.
+    // The scripted fish are found again whenever the classes are.
+    if (mGroups.Update(mItems, elapsed))
     {
-        item = std::make_shared<FishGoldeen>(this);
+        mScripts.Group(mItems);
     }
-    else if (type == L"castle")
+
+    // Scripted fish are moved a whole species at a time
+    if (elapsed > 0)
     {
-        item = std::make_shared<DecorCastle>(this);
+        mScripts.Run(mTime, elapsed, mWidth, mHeight);
     }
 
-    // If an item was created, add it to the aquarium and load its attributes
-    if (item != nullptr)
+    // Items that don't animate look the same however much time passes
+    if (elapsed > 0 && IsAnimated())
     {
-        Add(item);
-        item->XmlLoad(node);  // Load common attributes like x, y
+        mRevision++;
+    }
+
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Tick(elapsed, GetStateHash());
     }
 }
 
+/**
+ * Publish a snapshot of the items for other threads to read.
+ *
+ * Snapshots are only taken when something wants one, not after
+ * every update, so call this when one is needed. If nothing has
+ * changed since the last snapshot, that one is still current and
+ * is returned without copying anything. Must be called on the
+ * thread that updates the aquarium, between updates.
+ *
+ * @return The current snapshot
+ */
+std::shared_ptr<const AquariumSnapshot> Aquarium::Publish()
+{
+    auto previous = atomic_load(&mSnapshot);
+    if (previous != nullptr && previous->GetRevision() == mRevision)
+    {
+        return previous;
+    }
+
+    auto snapshot = AquariumSnapshot::Take(*this, previous);
+    atomic_store(&mSnapshot, snapshot);
+    return snapshot;
+}
 
 /**
- * Handle updates for animation.
- * @param elapsed The time since the last update
+ * Get the snapshot last published. Safe to call on any thread,
+ * though not lock-free: see AquariumSnapshot.
+ * @return Snapshot, or nullptr if none has been published yet
  */
-void Aquarium::Update(double elapsed)
+std::shared_ptr<const AquariumSnapshot> Aquarium::GetSnapshot() const
+{
+    return atomic_load(&mSnapshot);
+}
+
+/**
+ * Estimate the memory the aquarium is using, by category.
+ *
+ * Pixels are those of the scaled background and of every sprite
+ * in the cache, which other aquariums may share. Call on the
+ * GUI thread, between updates.
+ *
+ * @param sprites False to leave out the sprite cache
+ * @return Bytes in use
+ */
+MemoryUsage Aquarium::GetMemoryUsage(bool sprites) const
+{
+    MemoryUsage usage;
+    usage.mPixels = GetBackgroundBytes();
+    if (sprites)
+    {
+        usage.mPixels += mSprites->GetByteSize();
+    }
+
+    usage.mItems = mItemBytes;
+    usage.mContainers = MemoryUsage::Capacity(mItems) + MemoryUsage::Capacity(mSchoolFish) +
+            mGroups.GetByteSize() + mSchool.GetByteSize();
+    auto snapshot = GetSnapshot();
+    if (snapshot != nullptr)
+    {
+        usage.mContainers += snapshot->GetByteSize();
+    }
+
+    usage.mXml = mXmlBytes;
+    return usage;
+}
+
+/**
+ * Memory used by the scaled copies of the background. Call on
+ * the GUI thread.
+ * @return Size in bytes
+ */
+size_t Aquarium::GetBackgroundBytes() const
+{
+    return mBackground->GetByteSize();
+}
+
+/**
+ * Get the memory counted against the budget: the item objects and
+ * an entry per item in each list of items.
+ *
+ * It is kept up to date as items are added and removed, so it
+ * costs nothing to check, and it depends only on what is in the
+ * aquarium. The same session always refuses the same spawns, however
+ * the images are loading and whatever the other tanks hold. Images
+ * are shared between tanks, so they are budgeted by the TankHost.
+ *
+ * @return Size in bytes
+ */
+size_t Aquarium::GetMemoryUsed() const
+{
+    return mItemBytes + mItems.size() * ItemListBytes;
+}
+
+/**
+ * Draw small items as points, so no mip levels or bitmaps are
+ * made for them, or go back to drawing them as images.
+ * @param reduced True to reduce detail
+ */
+void Aquarium::SetReducedDetail(bool reduced)
+{
+    if (reduced != mReducedDetail)
+    {
+        mReducedDetail = reduced;
+        mRevision++;
+    }
+}
+
+/**
+ * Hash everything the simulation changes.
+ *
+ * Items are hashed in drawing order, so the z-order is part
+ * of the state as well.
+ *
+ * @return Hash of the aquarium state
+ */
+uint64_t Aquarium::GetStateHash() const
+{
+    StateHash hash;
+    hash.Add((uint64_t)mWidth);
+    hash.Add((uint64_t)mHeight);
+    hash.Add(mTime);
+    hash.Add((uint64_t)mItems.size());
+    for (auto &item : mItems)
+    {
+        item->HashState(hash);
+    }
+
+    return hash.Get();
+}
+
+/**
+ * Turn schooling on or off
+ * @param schooling True if the fish should school together
+ */
+void Aquarium::SetSchooling(bool schooling)
+{
+    if (mRecorder != nullptr)
+    {
+        mRecorder->Schooling(schooling);
+    }
+
+    mSchooling = schooling;
+}
+
+/**
+ * Run the simulation forward as fast as possible without drawing.
+ *
+ * Updates in fixed steps so the result is the same as watching
+ * the aquarium for that long at a steady frame rate.
+ *
+ * @param seconds Simulated seconds to run for
+ * @param step Simulated seconds per update
+ * @return Simulated seconds per wall-clock second achieved
+ */
+double Aquarium::FastForward(double seconds, double step)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    double remaining = seconds;
+    while (remaining > 0)
+    {
+        double elapsed = remaining < step ? remaining : step;
+        Update(elapsed);
+        remaining -= elapsed;
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return wall > 0 ? seconds / wall : 0;
+}
+
+/**
+ * Does anything in the aquarium change as time passes?
+ * @return True if any item is animated
+ */
+bool Aquarium::IsAnimated() const
 {
-    for (auto item : mItems)
+    for (auto &item : mItems)
     {
-        item->Update(elapsed);  // Call the Update function on each item
+        if (item->IsAnimated())
+        {
+            return true;
+        }
     }
+
+    return false;
 }
 
 // Getter for the random number generator
 std::mt19937& Aquarium::GetRandom()
 {
     return mRandom;
+}
+
+/**
+ * Start a new session: restart the random number generator from
+ * a seed and the simulation time from 0.
+ *
+ * Everything random in the simulation comes from this generator,
+ * and scripts can read the time, so the same seed and inputs give
+ * the same session.
+ *
+ * @param seed Seed to start from
+ */
+void Aquarium::Seed(uint32_t seed)
+{
+    mSeed = seed;
+    mRandom.seed(seed);
+    mTime = 0;
 }
\ No newline at end of file
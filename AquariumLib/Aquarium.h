@@ -12,16 +12,50 @@
 #include <vector>   // For std::vector
 #include <wx/bitmap.h>  // For wxBitmap
 #include <random>
+#include <functional>
+#include "School.h"
+#include "Sprite.h"
+#include "CommandQueue.h"
+#include "ScriptRunner.h"
+#include "ItemGroup.h"
+#include "MemoryUsage.h"
 
 class Item;
+class Fish;
+class Viewport;
+class SimulationRecorder;
+class SpeciesRegistry;
+class ScaledBackground;
+class AquariumSnapshot;
+class MetricCounter;
+class MetricHistogram;
 
 /**
  * The main aquarium class.
  */
 class Aquarium {
 private:
-    /// Background image
-    std::unique_ptr<wxBitmap> mBackground;
+    /// Cache the item images are loaded through
+    std::shared_ptr<SpriteCache> mSprites;
+
+    /// Background image, scaled to fill the tank
+    std::shared_ptr<ScaledBackground> mBackground;
+
+    /// Width of the tank in pixels
+    int mWidth = 0;
+
+    /// Height of the tank in pixels
+    int mHeight = 0;
+
+    /// The kinds of item that can go in the aquarium
+    std::shared_ptr<SpeciesRegistry> mSpecies;
+
+    /// Every registry the items' species can be from: mSpecies and
+    /// any set before it. Snapshots share this to keep those species alive.
+    std::shared_ptr<const std::vector<std::shared_ptr<const SpeciesRegistry>>> mRegistries;
+
+    /// Species version the items last picked up parameters from
+    uint64_t mSpeciesVersion = 0;
 
     /// All of the items to populate our aquarium
     std::vector<std::shared_ptr<Item>> mItems;
@@ -33,30 +67,142 @@ private:
 	/// Random number generator
 	std::mt19937 mRandom;
 
+	/// Simulated seconds since the aquarium was created
+	double mTime = 0;
+
+	/// Seed the random number generator was last started from
+	uint32_t mSeed = std::mt19937::default_seed;
+
+	/// Recorder the session is being written to, if any
+	std::shared_ptr<SimulationRecorder> mRecorder;
+
+	/// Schooling behaviour for the fish
+	School mSchool;
+
+	/// True if the fish school together
+	bool mSchooling = false;
+
+	/// The fish steered by the last schooling pass
+	std::vector<Fish*> mSchoolFish;
+
+	/// The items sorted by class, for updating
+	ItemGroups mGroups;
+
+	/// Moves the fish whose species have behaviour scripts
+	ScriptRunner mScripts;
+
+	/// Counts changes to anything drawn
+	uint64_t mRevision = 0;
+
+	/// True if the last draw used stand-ins for images still loading
+	bool mProvisional = false;
+
+	/// Changes posted from other threads, made at the start of the next update
+	CommandQueue<std::function<void(Aquarium &)>> mCommands;
+
+	/// Called on the posting thread whenever a change is posted
+	std::function<void()> mOnPosted;
+
+	/// The latest snapshot. Only accessed with atomic_load and atomic_store,
+	/// which hold a library lock just long enough to copy the pointer.
+	std::shared_ptr<const AquariumSnapshot> mSnapshot;
+
+	/// Most memory the items may use before the aquarium refuses to add more, 0 for no limit
+	size_t mMemoryBudget = 0;
+
+	/// Bytes of the item objects, kept up to date as items are added and removed
+	size_t mItemBytes = 0;
+
+	/// True if small items are drawn as points to save image memory
+	bool mReducedDetail = false;
+
+	/// Size of the largest XML document saved or loaded so far
+	size_t mXmlBytes = 0;
+
+	/// Items the last load left out because the aquarium was over its memory budget
+	size_t mLoadRefused = 0;
+
+	/// Updates of this aquarium, labelled with its tank
+	MetricCounter *mUpdates = nullptr;
+
+	/// Time each update of this aquarium took
+	MetricHistogram *mUpdateTime = nullptr;
+
+	/// Draws of this aquarium
+	MetricCounter *mDraws = nullptr;
+
+	/// Time each draw of this aquarium took
+	MetricHistogram *mDrawTime = nullptr;
+
+	/// Items of this aquarium drawn
+	MetricCounter *mDrawn = nullptr;
+
+	/// Items of this aquarium skipped because they were out of view
+	MetricCounter *mCulled = nullptr;
+
 
 
 public:
+    /// Image drawn behind everything in the aquarium
+    static const std::wstring BackgroundImage;
+
     Aquarium();
 
+    void SetTank(size_t tank);
+
     void OnDraw(wxDC* graphics);
 
-	void Add(std::shared_ptr<Item> item);
+    void OnDraw(wxDC* graphics, const Viewport& viewport);
+
+    void WaitForImages();
+
+    /**
+     * Get the cache item images are loaded through
+     * @return Sprite cache
+     */
+    std::shared_ptr<SpriteCache> GetSprites() const { return mSprites; }
+
+    /**
+     * Get the kinds of item that can go in the aquarium
+     * @return Species registry
+     */
+    std::shared_ptr<SpeciesRegistry> GetSpecies() const { return mSpecies; }
+
+    void SetSpecies(std::shared_ptr<SpeciesRegistry> species);
+
+    /**
+     * Get every registry the items' species can be from
+     * @return Registries, shared so that holding them keeps the species alive
+     */
+    const std::shared_ptr<const std::vector<std::shared_ptr<const SpeciesRegistry>>> &GetRegistries() const { return mRegistries; }
+
+	bool Add(std::shared_ptr<Item> item);
+
+	std::shared_ptr<Item> CreateItem(const std::wstring &type);
+
+	std::shared_ptr<Item> Spawn(const std::wstring &type);
+
+	void MoveItem(std::shared_ptr<Item> item, double x, double y);
 
 	std::shared_ptr<Item> HitTest(int x, int y);\
 
 	/// Move an item to the end of the list (so it appears on top)
 	void MoveToEnd(std::shared_ptr<Item> item);
 
+	bool Remove(std::shared_ptr<Item> item);
+
 	/**
 	 * Get the list of items in the aquarium.
 	 * @return Vector of shared pointers to items.
 	 */
 	const std::vector<std::shared_ptr<Item>>& GetItems() const;
 
-	void Save(const wxString &filename);
+	bool Save(const wxString &filename);
 
 	/// Load the aquarium from an XML file
-	void Load(const wxString &filename);
+	bool Load(const wxString &filename);
+
+	bool LoadData(const std::string &contents);
 
 	/// Deletes all known items in the aquarium.
 	void Clear();
@@ -64,6 +210,108 @@ public:
 	/// Handle updates for animation
 	void Update(double elapsed);
 
+	/**
+	 * Ask for a change to be made at the start of the next update.
+	 *
+	 * This is the only thing other threads may call while the
+	 * simulation is running. The command is called on whichever
+	 * thread updates the aquarium, so it can use the aquarium
+	 * freely, and recorded changes like Spawn are recorded there.
+	 *
+	 *     aquarium->Post([](Aquarium &a) { a.Spawn(L"nemo"); });
+	 *
+	 * @param command Function to call with the aquarium
+	 */
+	void Post(std::function<void(Aquarium &)> command)
+	{
+		mCommands.Push(std::move(command));
+		if (mOnPosted)
+		{
+			mOnPosted();
+		}
+	}
+
+	/**
+	 * Set a function to call whenever a change is posted, so
+	 * whatever runs the updates can run one without waiting for
+	 * its next tick. It is called on the posting thread. Set it
+	 * before anything can post.
+	 * @param onPosted Function to call
+	 */
+	void SetOnPosted(std::function<void()> onPosted) { mOnPosted = onPosted; }
+
+	/**
+	 * Are there posted changes that haven't been made yet?
+	 * @return True if changes are waiting for the next update
+	 */
+	bool HasPosted() const { return !mCommands.IsEmpty(); }
+
+	std::shared_ptr<const AquariumSnapshot> Publish();
+
+	std::shared_ptr<const AquariumSnapshot> GetSnapshot() const;
+
+	double FastForward(double seconds, double step);
+
+	bool IsAnimated() const;
+
+	/**
+	 * Get a count that goes up whenever anything drawn changes:
+	 * an item added, removed, raised or moved, the tank resized,
+	 * or time passing with something animated in the tank.
+	 * Two draws at the same revision look the same.
+	 * @return Revision number
+	 */
+	uint64_t GetRevision() const { return mRevision; }
+
+	/**
+	 * Did the last draw use stand-ins for images that are
+	 * still loading? If so, drawing again will look different.
+	 * @return True if the last draw was provisional
+	 */
+	bool IsProvisional() const { return mProvisional; }
+
+	MemoryUsage GetMemoryUsage(bool sprites = true) const;
+
+	size_t GetBackgroundBytes() const;
+
+	size_t GetMemoryUsed() const;
+
+	/**
+	 * Set the most memory the items may use. Once it is used up,
+	 * no more are added, whether spawned or loaded from a file;
+	 * items already in the aquarium are kept.
+	 * @param bytes Budget in bytes, 0 for no limit
+	 */
+	void SetMemoryBudget(size_t bytes) { mMemoryBudget = bytes; }
+
+	/**
+	 * Get the most memory the items may use before the aquarium refuses to add more
+	 * @return Budget in bytes, 0 for no limit
+	 */
+	size_t GetMemoryBudget() const { return mMemoryBudget; }
+
+	/**
+	 * Have the items used up the memory budget? If so the
+	 * aquarium refuses to add any more.
+	 * @return True if there is a budget and it is used up
+	 */
+	bool IsOverBudget() const { return mMemoryBudget > 0 && GetMemoryUsed() >= mMemoryBudget; }
+
+	/**
+	 * Number of items the last load left out because the
+	 * aquarium was over its memory budget
+	 * @return Item count, 0 if the whole file was loaded
+	 */
+	size_t GetLoadRefused() const { return mLoadRefused; }
+
+	void SetReducedDetail(bool reduced);
+
+	/**
+	 * Are small items drawn as points to save image memory?
+	 * @return True if detail is reduced
+	 */
+	bool IsReducedDetail() const { return mReducedDetail; }
+
 
 	/**
 	 * Get the random number generator
@@ -71,18 +319,62 @@ public:
 	 */
 	std::mt19937 &GetRandom();
 
+	/**
+	 * Get the simulation time, which drives the animations
+	 * @return Simulated seconds since the aquarium was created
+	 */
+	double GetTime() const { return mTime; }
+
+	void Seed(uint32_t seed);
+
+	/**
+	 * Get the seed the random number generator was last started from
+	 * @return Random seed
+	 */
+	uint32_t GetSeed() const { return mSeed; }
+
+	/**
+	 * Record the session from here on
+	 * @param recorder Recorder to write to, or nullptr to stop recording
+	 */
+	void SetRecorder(std::shared_ptr<SimulationRecorder> recorder) { mRecorder = recorder; }
+
+	/**
+	 * Get the recorder the session is being written to
+	 * @return Recorder, or nullptr if not recording
+	 */
+	std::shared_ptr<SimulationRecorder> GetRecorder() const { return mRecorder; }
+
+	uint64_t GetStateHash() const;
+
+	void SetSchooling(bool schooling);
+
+	/**
+	 * Are the fish schooling?
+	 * @return True if schooling is on
+	 */
+	bool IsSchooling() const { return mSchooling; }
+
+	/**
+	 * Get the schooling behaviour
+	 * @return School object
+	 */
+	School &GetSchool() { return mSchool; }
+
+	void SetSize(int width, int height);
+
 	/**
 	 * Get the width of the aquarium
 	 * @return Aquarium width in pixels
 	 */
-	int GetWidth() const { return mBackground->GetWidth(); }
+	int GetWidth() const { return mWidth; }
 
 
 	/**
 	 * Get the height of the aquarium
 	 * @return Aquarium height in pixels
 	 */
-	int GetHeight() const { return mBackground->GetHeight(); }
+	int GetHeight() const { return mHeight; }
 };
 
 #endif //AQUARIUM_AQUARIUM_H
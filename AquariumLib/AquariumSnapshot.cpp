@@ -0,0 +1,178 @@
+/**
+ * @file AquariumSnapshot.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "AquariumSnapshot.h"
+#include "Aquarium.h"
+#include "Item.h"
+#include "SpeciesRegistry.h"
+#include "MemoryUsage.h"
+#include "Metrics.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Does an item still match the state it was copied with?
+ * @param item Item
+ * @param state State copied earlier
+ * @return True if nothing in the state has changed
+ */
+static bool Matches(const Item &item, const AquariumSnapshot::ItemState &state)
+{
+    return item.GetX() == state.mX && item.GetY() == state.mY &&
+            item.IsMirror() == state.mMirror && item.GetSpecies().get() == state.mSpecies;
+}
+
+/**
+ * Take a snapshot of an aquarium.
+ *
+ * Must be called on the thread that updates the aquarium.
+ * Chunks of the previous snapshot whose items haven't changed,
+ * or moved in the drawing order, are shared rather than copied.
+ *
+ * @param aquarium Aquarium to take a snapshot of
+ * @param previous The last snapshot taken of it, or nullptr
+ * @return The new snapshot
+ */
+std::shared_ptr<const AquariumSnapshot> AquariumSnapshot::Take(const Aquarium &aquarium,
+        const std::shared_ptr<const AquariumSnapshot> &previous)
+{
+    auto snapshot = make_shared<AquariumSnapshot>();
+    auto &items = aquarium.GetItems();
+    snapshot->mCount = items.size();
+    snapshot->mEpoch = previous != nullptr ? previous->mEpoch + 1 : 0;
+    snapshot->mRevision = aquarium.GetRevision();
+    snapshot->mWidth = aquarium.GetWidth();
+    snapshot->mHeight = aquarium.GetHeight();
+    snapshot->mRegistries = aquarium.GetRegistries();
+
+    for (size_t begin = 0; begin < items.size(); begin += ChunkSize)
+    {
+        size_t end = min(begin + ChunkSize, items.size());
+        size_t c = begin / ChunkSize;
+
+        if (previous != nullptr && c < previous->mChunks.size() && previous->mChunks[c]->size() == end - begin)
+        {
+            auto &old = *previous->mChunks[c];
+            bool same = true;
+            for (size_t i = begin; i < end && same; i++)
+            {
+                same = Matches(*items[i], old[i - begin]);
+            }
+
+            if (same)
+            {
+                snapshot->mChunks.push_back(previous->mChunks[c]);
+                snapshot->mShared++;
+                continue;
+            }
+        }
+
+        auto chunk = make_shared<Chunk>(end - begin);
+        for (size_t i = begin; i < end; i++)
+        {
+            (*chunk)[i - begin] = Capture(*items[i]);
+        }
+
+        snapshot->mChunks.push_back(chunk);
+    }
+
+    return snapshot;
+}
+
+/**
+ * Copy the state of one item
+ * @param item Item to copy
+ * @return The item's state
+ */
+AquariumSnapshot::ItemState AquariumSnapshot::Capture(const Item &item)
+{
+    ItemState state;
+    state.mSpecies = item.GetSpecies().get();
+    state.mX = item.GetX();
+    state.mY = item.GetY();
+    state.mMirror = item.IsMirror();
+    return state;
+}
+
+/**
+ * Write one item to a .aqua XML document. This is the only place
+ * the attributes of a saved item are written.
+ * @param parent The node the item is a child of
+ * @param state State of the item
+ * @return The item's node
+ */
+wxXmlNode *AquariumSnapshot::SaveItem(wxXmlNode *parent, const ItemState &state)
+{
+    auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
+    parent->AddChild(itemNode);
+
+    itemNode->AddAttribute(L"x", wxString::FromDouble(state.mX));
+    itemNode->AddAttribute(L"y", wxString::FromDouble(state.mY));
+    if (state.mSpecies != nullptr)
+    {
+        itemNode->AddAttribute(L"type", state.mSpecies->mName);
+    }
+
+    return itemNode;
+}
+
+/**
+ * Memory used by the snapshot and its chunks. Chunks shared
+ * with other snapshots are counted in full.
+ * @return Size in bytes
+ */
+size_t AquariumSnapshot::GetByteSize() const
+{
+    size_t bytes = sizeof(*this) + MemoryUsage::SharedCountBytes + MemoryUsage::Capacity(mChunks);
+    for (auto &chunk : mChunks)
+    {
+        bytes += sizeof(Chunk) + MemoryUsage::SharedCountBytes + MemoryUsage::Capacity(*chunk);
+    }
+
+    return bytes;
+}
+
+/**
+ * Save the snapshot as a .aqua XML file, the same as
+ * Aquarium::Save would. Safe to call on any thread.
+ * @param filename The filename of the file to save to
+ * @param xmlBytes If not nullptr, set to the size of the XML document built to save
+ * @return False if the file couldn't be written
+ */
+bool AquariumSnapshot::Save(const wxString &filename, size_t *xmlBytes) const
+{
+    static auto &saves = Metrics::GetDefault()->Counter("aquarium_saves_total", "Aquarium files saved");
+    static auto &failures = Metrics::GetDefault()->Counter("aquarium_save_failures_total", "Aquarium files that couldn't be saved");
+    static auto &saveTime = Metrics::GetDefault()->Histogram("aquarium_save_seconds", "Time to save an aquarium file");
+    MetricTimer timer(saveTime);
+    saves.Add();
+
+    wxXmlDocument xmlDoc;
+    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
+    xmlDoc.SetRoot(root);
+
+    for (auto &chunk : mChunks)
+    {
+        for (auto &state : *chunk)
+        {
+            SaveItem(root, state);
+        }
+    }
+
+    if (xmlBytes != nullptr)
+    {
+        *xmlBytes = MemoryUsage::XmlBytes(root);
+    }
+
+    if (!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
+    {
+        failures.Add();
+        return false;
+    }
+
+    return true;
+}
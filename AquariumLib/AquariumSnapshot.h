@@ -0,0 +1,161 @@
+/**
+ * @file AquariumSnapshot.h
+ * @author Ismail Abdi
+ *
+ * An immutable copy of the state of every item in an aquarium.
+ */
+
+#ifndef AQUARIUM_AQUARIUMSNAPSHOT_H
+#define AQUARIUM_AQUARIUMSNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Aquarium;
+class Item;
+class SpeciesRegistry;
+struct Species;
+
+/**
+ * An immutable copy of the state of every item in an aquarium.
+ *
+ * The aquarium publishes one when asked to, on the thread that
+ * updates it, if anything has changed since the last. Once
+ * published a snapshot never changes, so any thread holding one
+ * can read its items while the aquarium goes on updating, with no
+ * locking and no fear of a half-updated item. Snapshots are
+ * reference counted, so one is freed once the last reader lets go
+ * of it.
+ *
+ * Getting hold of the latest snapshot is not lock-free. The
+ * aquarium swaps it with std::atomic_load and std::atomic_store on
+ * the shared_ptr, which libstdc++ and MSVC implement with a small
+ * table of spinlocks or mutexes. Each is held only for the
+ * reference count update, never while a snapshot is taken or read.
+ *
+ * Items are copied in fixed size chunks. Taking a snapshot only
+ * copies the chunks with an item that changed; the others are
+ * shared with the previous snapshot. A tank of fish copies most
+ * chunks each time, but the decor, and any tank that is
+ * paused, costs almost nothing.
+ *
+ * Items refer to their species with a plain pointer, so taking a
+ * snapshot doesn't touch the reference counts the species share
+ * with every other tank. The snapshot holds the aquarium's list of
+ * species registries instead, which keeps every species alive.
+ */
+class AquariumSnapshot {
+public:
+    /// Items in each chunk
+    static const size_t ChunkSize = 64;
+
+    /// The state of one item
+    struct ItemState {
+        /// Species of the item, or nullptr if it has none. Kept
+        /// alive by the snapshot's registries.
+        const Species *mSpecies = nullptr;
+
+        /// X location in pixels
+        double mX = 0;
+
+        /// Y location in pixels
+        double mY = 0;
+
+        /// True if the image is mirrored
+        bool mMirror = false;
+    };
+
+    /// A run of ChunkSize items, or fewer for the last
+    using Chunk = std::vector<ItemState>;
+
+private:
+    /// The items, in drawing order
+    std::vector<std::shared_ptr<const Chunk>> mChunks;
+
+    /// Number of items
+    size_t mCount = 0;
+
+    /// Number of snapshots taken of the aquarium before this one
+    uint64_t mEpoch = 0;
+
+    /// Aquarium revision this is a snapshot of
+    uint64_t mRevision = 0;
+
+    /// Tank width in pixels
+    int mWidth = 0;
+
+    /// Tank height in pixels
+    int mHeight = 0;
+
+    /// Chunks shared with the previous snapshot
+    size_t mShared = 0;
+
+    /// The registries the species of the items come from
+    std::shared_ptr<const std::vector<std::shared_ptr<const SpeciesRegistry>>> mRegistries;
+
+public:
+    AquariumSnapshot() {}
+
+    static std::shared_ptr<const AquariumSnapshot> Take(const Aquarium &aquarium,
+            const std::shared_ptr<const AquariumSnapshot> &previous);
+
+    static ItemState Capture(const Item &item);
+
+    static wxXmlNode *SaveItem(wxXmlNode *parent, const ItemState &state);
+
+    /**
+     * Number of items
+     * @return Item count
+     */
+    size_t GetCount() const { return mCount; }
+
+    /**
+     * Get the state of an item
+     * @param index Item index, in drawing order
+     * @return Item state
+     */
+    const ItemState &GetItem(size_t index) const { return (*mChunks[index / ChunkSize])[index % ChunkSize]; }
+
+    /**
+     * Get the chunks the items are stored in
+     * @return Chunks, in drawing order
+     */
+    const std::vector<std::shared_ptr<const Chunk>> &GetChunks() const { return mChunks; }
+
+    /**
+     * Get the number of snapshots taken of the aquarium before this one
+     * @return Epoch, from 0
+     */
+    uint64_t GetEpoch() const { return mEpoch; }
+
+    /**
+     * Get the aquarium revision this is a snapshot of
+     * @return Revision number
+     */
+    uint64_t GetRevision() const { return mRevision; }
+
+    /**
+     * Get the tank width
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the tank height
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Number of chunks shared with the previous snapshot rather than copied
+     * @return Chunk count
+     */
+    size_t GetSharedChunks() const { return mShared; }
+
+    size_t GetByteSize() const;
+
+    bool Save(const wxString &filename, size_t *xmlBytes = nullptr) const;
+};
+
+#endif //AQUARIUM_AQUARIUMSNAPSHOT_H
@@ -5,27 +5,58 @@
 #include "pch.h"
 
 #include "AquariumView.h"
-#include "FishBeta.h"
-#include "FishNemo.h"
-#include  "FishGoldeen.h"
-#include "DecorCastle.h"
+#include "TankHost.h"
+#include "SpeciesRegistry.h"
+#include "SimulationRecorder.h"
+#include "SimulationReplayer.h"
+#include "FrameRingWriter.h"
+#include "VideoExporter.h"
+#include "ThreadPool.h"
 #include <wx/dcbuffer.h>
+#include <wx/dcmemory.h>
+#include <wx/filename.h>
+#include <wx/progdlg.h>
 #include "ids.h"  // Include IDs for menu items
 #include <memory>
 #include <wx/log.h>
 
 using namespace std;
 
-/// Frame duration in milliseconds
-const int FrameDuration = 30;
+/// Zoom factor for one menu step or one wheel notch
+const double ZoomStep = 1.25;
+
+/// Simulated seconds per update when fast-forwarding
+const double FastForwardStep = 1.0 / 30;
+
+/// Frames kept in the shared memory ring when publishing frames
+const uint32_t PublishedFrameSlots = 4;
+
+/// Frames per second of exported video
+const int ExportFrameRate = 30;
+
+const double AquariumView::Speeds[] = {0.25, 0.5, 1, 2, 4, 8, 16, 32};
+
+const int AquariumView::SpeedCount = sizeof(AquariumView::Speeds) / sizeof(AquariumView::Speeds[0]);
 
 
 /**
  * Initialize the aquarium view class.
+ *
+ * The view shows one tank of a host. The host updates the tanks;
+ * the view draws its tank and handles the menus for it. Menu events
+ * are passed to the view by the frame when its tank is the one
+ * being shown.
+ *
  * @param parent The parent window for this class
+ * @param host Host the tank is in
+ * @param tank Index of the tank to show
  */
-void AquariumView::Initialize(wxFrame* parent)
+void AquariumView::Initialize(wxWindow* parent, std::shared_ptr<TankHost> host, size_t tank)
 {
+    mHost = host;
+    mTank = tank;
+    mAquarium = host->GetAquarium(tank);
+
     // Set up the window
     Create(parent, wxID_ANY);
 
@@ -40,23 +71,45 @@ void AquariumView::Initialize(wxFrame* parent)
     Bind(wxEVT_LEFT_UP, &AquariumView::OnLeftUp, this);
     Bind(wxEVT_MOTION, &AquariumView::OnMouseMove, this);
 
-    // Bind the menu options to handlers
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishBetaFish, this, IDM_ADDFISHBETA);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishNemo, this, IDM_ADDFISHNEMO);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishGoldeen, this, IDM_ADDFISHGOLDEEN);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddDecorCastle, this, IDM_ADDDECORCASTLE);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this, wxID_SAVEAS);  // Save as menu
-
-	mTimer.SetOwner(this);
-	mTimer.Start(FrameDuration);
+    // Bind the mouse events for panning and zooming
+    Bind(wxEVT_RIGHT_DOWN, &AquariumView::OnRightDown, this);
+    Bind(wxEVT_RIGHT_UP, &AquariumView::OnRightUp, this);
+    Bind(wxEVT_MOUSEWHEEL, &AquariumView::OnMouseWheel, this);
 
-	// Bind the timer event for the OnTimer handler
-	Bind(wxEVT_TIMER, &AquariumView::OnTimer, this);
+    // The tank grows and shrinks with the window
+    Bind(wxEVT_SIZE, &AquariumView::OnSize, this);
 
-	// Start the stopwatch for tracking time
+    // Bind the menu options to handlers
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddSpecies, this, IDM_ADDSPECIES, IDM_ADDSPECIESLAST);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSchooling, this, IDM_SCHOOLING);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomIn, this, IDM_ZOOMIN);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomOut, this, IDM_ZOOMOUT);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomReset, this, IDM_ZOOMRESET);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnPause, this, IDM_PAUSE);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnStep, this, IDM_STEP);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSpeed, this, IDM_SPEED, IDM_SPEEDLAST);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFastForward, this, IDM_FASTFORWARD);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnRecord, this, IDM_RECORD);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnStopRecording, this, IDM_STOPRECORDING);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnReplay, this, IDM_REPLAY);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnExportVideo, this, IDM_EXPORTVIDEO);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this, wxID_SAVEAS);  // Save as menu
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileOpen, this, wxID_OPEN);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnPublishFrames, this, IDM_PUBLISHFRAMES);
+
+	// Start the stopwatch for timing the first paint
 	mStopWatch.Start();
 }
 
+/**
+ * Get the clock our tank runs on
+ * @return Simulation clock
+ */
+SimulationClock &AquariumView::GetClock()
+{
+    return mHost->GetClock(mTank);
+}
+
 /**
  * Paint event, draws the window.
  * @param event Paint event object
@@ -65,66 +118,157 @@ void AquariumView::OnPaint(wxPaintEvent& event)
 {
     wxAutoBufferedPaintDC dc(this);  // Create a buffered device context
 
-	// Compute the time that has elapsed
-	// since the last call to OnPaint.
-	auto newTime = mStopWatch.Time();
-	auto elapsed = (double)(newTime - mTime) * 0.001;
-	mTime = newTime;
+    // The host has already updated the aquarium for this frame
+    auto size = GetClientSize();
+    if (mFrameRing == nullptr)
+    {
+        Render(&dc, size);
+    }
+    else
+    {
+        // Draw into a bitmap we can read back, publish it, then show it
+        wxBitmap frame(size);
+        wxMemoryDC frameDC(frame);
+        Render(&frameDC, size);
+        frameDC.SelectObject(wxNullBitmap);
+
+        // A window stretched over more than one display can outgrow the slots
+        auto image = frame.ConvertToImage();
+        if (!mFrameRing->Publish(image.GetData(), image.GetWidth(), image.GetHeight(), image.GetWidth() * 3) &&
+                !mFrameTooBig)
+        {
+            mFrameTooBig = true;
+            wxLogStatus(L"Frames of %dx%d are too big to publish; make the window smaller than the display",
+                    image.GetWidth(), image.GetHeight());
+        }
+        dc.DrawBitmap(frame, 0, 0);
+    }
 
+    mPaintedRevision = mAquarium->GetRevision();
+    if (!mPainted)
+    {
+        mPainted = true;
+        wxLogStatus(L"First paint after %ld ms", mStopWatch.Time());
+    }
+}
 
-	// Update the aquarium state based on elapsed time
-	mAquarium.Update(elapsed);
+/**
+ * Would painting the window now look any different?
+ *
+ * Changes to the view itself, like zooming or resizing, repaint
+ * the window as they happen. This is for changes to the aquarium.
+ *
+ * @return True if the aquarium has changed since the last paint
+ */
+bool AquariumView::IsStale() const
+{
+    return !mPainted || mAquarium->GetRevision() != mPaintedRevision || mAquarium->IsProvisional();
+}
 
+/**
+ * Draw the part of the aquarium we are looking at
+ * @param dc Device context to draw on
+ * @param size Size of the window
+ */
+void AquariumView::Render(wxDC* dc, const wxSize& size)
+{
     wxBrush background(*wxWHITE);  // Set the background to white
-    dc.SetBackground(background);
-    dc.Clear();  // Clear the window with the background
+    dc->SetBackground(background);
+    dc->Clear();  // Clear the window with the background
 
-    // Draw the aquarium and all its items
-    mAquarium.OnDraw(&dc);
+    mViewport.SetSize(size.GetWidth(), size.GetHeight());
+    mAquarium->OnDraw(dc, mViewport);
 }
 
 /**
- * Menu handler for Add Fish > Beta Fish
+ * Menu handler for View > Publish Frames.
+ *
+ * While this is on, every frame drawn is also published to a
+ * shared memory ring named after the tank, for a compositor on
+ * the same machine to read. See FrameRing for the layout. The
+ * slots hold a frame the size of the display, and larger frames
+ * are dropped.
+ *
  * @param event The wxCommandEvent triggered by the menu
  */
-void AquariumView::OnAddFishBetaFish(wxCommandEvent& event)
+void AquariumView::OnPublishFrames(wxCommandEvent& event)
 {
-    auto fish = std::make_shared<FishBeta>(&mAquarium);  // Create a new Beta fish
-    mAquarium.Add(fish);  // Add the fish to the aquarium
-    Refresh();  // Refresh the view to display the new fish
+    if (!event.IsChecked())
+    {
+        mFrameRing = nullptr;
+        return;
+    }
+
+    // Room for a frame the size of the whole display
+    auto display = wxGetDisplaySize();
+    auto ring = std::make_unique<FrameRingWriter>();
+    auto name = wxString::Format(L"/aquarium-tank-%d", (int)mTank + 1);
+    if (!ring->Create(name.ToStdString(), PublishedFrameSlots, (uint32_t)(display.GetWidth() * display.GetHeight() * 3)))
+    {
+        wxMessageBox(L"Unable to create the shared memory for the frames");
+
+        // We aren't publishing, so the menu shouldn't say we are
+        auto frame = dynamic_cast<wxFrame *>(wxGetTopLevelParent(this));
+        if (frame != nullptr && frame->GetMenuBar() != nullptr)
+        {
+            frame->GetMenuBar()->Check(IDM_PUBLISHFRAMES, false);
+        }
+        return;
+    }
+
+    mFrameRing = std::move(ring);
+    mFrameTooBig = false;
+    wxLogStatus(L"Publishing frames to %s", name);
 }
 
 /**
- * Menu handler for Add Fish > Nemo Fish
+ * Menu handler for the Add Fish and Add Decor menus
  * @param event The wxCommandEvent triggered by the menu
  */
-void AquariumView::OnAddFishNemo(wxCommandEvent& event)
+void AquariumView::OnAddSpecies(wxCommandEvent& event)
 {
-    auto fish = std::make_shared<FishNemo>(&mAquarium);  // Create a new Nemo fish
-    mAquarium.Add(fish);  // Add the fish to the aquarium
-    Refresh();  // Refresh the view to display the new fish
+    auto &species = mAquarium->GetSpecies()->GetSpecies();
+    size_t index = event.GetId() - IDM_ADDSPECIES;
+    if (index < species.size())
+    {
+        // Create the item and add it to the aquarium
+        if (mAquarium->Spawn(species[index]->mName) == nullptr && mAquarium->IsOverBudget())
+        {
+            wxLogStatus(L"The aquarium has used up its memory budget");
+            return;
+        }
+
+        Refresh();  // Refresh the view to display the new item
+    }
 }
 
 /**
- * Menu handler for Add Fish > Goldeen Fish
- * @param event The wxCommandEvent triggered by the menu
+ * Handle the window being resized.
+ *
+ * At 1:1 zoom the tank fills the window. The background is
+ * rescaled to match once, rather than on every frame.
+ *
+ * @param event Size event
  */
-void AquariumView::OnAddFishGoldeen(wxCommandEvent& event)
+void AquariumView::OnSize(wxSizeEvent& event)
 {
-    auto fish = std::make_shared<FishGoldeen>(&mAquarium);  // Create a new Goldeen fish
-    mAquarium.Add(fish);  // Add the fish to the aquarium
-    Refresh();  // Refresh the view to display the new fish
+    auto size = GetClientSize();
+    if (size.GetWidth() > 0 && size.GetHeight() > 0)
+    {
+        mAquarium->SetSize(size.GetWidth(), size.GetHeight());
+    }
+
+    Refresh();
+    event.Skip();
 }
 
 /**
- * Menu handler for Add Decor > Castle
+ * Menu handler for Behavior > Schooling
  * @param event The wxCommandEvent triggered by the menu
  */
-void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
+void AquariumView::OnSchooling(wxCommandEvent& event)
 {
-    auto decor = std::make_shared<DecorCastle>(&mAquarium);  // Create a new castle decor
-    mAquarium.Add(decor);  // Add the decor to the aquarium
-    Refresh();  // Refresh the view to display the new decor
+    mAquarium->SetSchooling(event.IsChecked());
 }
 
 /**
@@ -134,12 +278,13 @@ void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
 void AquariumView::OnLeftDown(wxMouseEvent& event)
 {
     // Perform a hit test to see if we clicked on an item
-    mGrabbedItem = mAquarium.HitTest(event.GetX(), event.GetY());
+    mGrabbedItem = mAquarium->HitTest((int)mViewport.ToAquariumX(event.GetX()),
+                                     (int)mViewport.ToAquariumY(event.GetY()));
 
     // If we clicked on an item, bring it to the top
     if (mGrabbedItem != nullptr)
     {
-        mAquarium.MoveToEnd(mGrabbedItem);  // Move the item to the end of the list
+        mAquarium->MoveToEnd(mGrabbedItem);  // Move the item to the end of the list
     }
 }
 
@@ -158,12 +303,29 @@ void AquariumView::OnLeftUp(wxMouseEvent& event)
  */
 void AquariumView::OnMouseMove(wxMouseEvent& event)
 {
+    // Dragging with the right button moves the view
+    if (mPanning)
+    {
+        if (event.RightIsDown())
+        {
+            mViewport.Pan(event.GetX() - mPanX, event.GetY() - mPanY);
+            mPanX = event.GetX();
+            mPanY = event.GetY();
+        }
+        else
+        {
+            mPanning = false;
+        }
+        Refresh();
+    }
+
     // If an item is being dragged
     if (mGrabbedItem != nullptr)
     {
         if (event.LeftIsDown())  // Move the item if the left mouse button is pressed
         {
-            mGrabbedItem->SetLocation(event.GetX(), event.GetY());  // Set the new location of the grabbed item
+            // Set the new location of the grabbed item
+            mAquarium->MoveItem(mGrabbedItem, mViewport.ToAquariumX(event.GetX()), mViewport.ToAquariumY(event.GetY()));
         }
         else
         {
@@ -173,6 +335,319 @@ void AquariumView::OnMouseMove(wxMouseEvent& event)
     }
 }
 
+/**
+ * Handle the right mouse button down event, which starts panning.
+ * @param event Mouse event
+ */
+void AquariumView::OnRightDown(wxMouseEvent& event)
+{
+    mPanning = true;
+    mPanX = event.GetX();
+    mPanY = event.GetY();
+}
+
+/**
+ * Handle the right mouse button up event, which ends panning.
+ * @param event Mouse event
+ */
+void AquariumView::OnRightUp(wxMouseEvent& event)
+{
+    OnMouseMove(event);
+    mPanning = false;
+}
+
+/**
+ * Handle the mouse wheel, zooming about the mouse location.
+ * @param event Mouse event
+ */
+void AquariumView::OnMouseWheel(wxMouseEvent& event)
+{
+    double notches = (double)event.GetWheelRotation() / event.GetWheelDelta();
+    mViewport.SetZoom(mViewport.GetZoom() * pow(ZoomStep, notches), event.GetX(), event.GetY());
+    Refresh();
+}
+
+/**
+ * Menu handler for View > Zoom In
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnZoomIn(wxCommandEvent& event)
+{
+    mViewport.SetZoom(mViewport.GetZoom() * ZoomStep, mViewport.GetWidth() / 2.0, mViewport.GetHeight() / 2.0);
+    Refresh();
+}
+
+/**
+ * Menu handler for View > Zoom Out
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnZoomOut(wxCommandEvent& event)
+{
+    mViewport.SetZoom(mViewport.GetZoom() / ZoomStep, mViewport.GetWidth() / 2.0, mViewport.GetHeight() / 2.0);
+    Refresh();
+}
+
+/**
+ * Menu handler for View > Actual Size
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnZoomReset(wxCommandEvent& event)
+{
+    mViewport.Reset();
+    Refresh();
+}
+
+/**
+ * Menu handler for Simulation > Pause
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnPause(wxCommandEvent& event)
+{
+    GetClock().SetPaused(event.IsChecked());
+}
+
+/**
+ * Menu handler for Simulation > Step, which advances
+ * a paused aquarium by one frame.
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnStep(wxCommandEvent& event)
+{
+    GetClock().Step();
+    Refresh();
+}
+
+/**
+ * Menu handler for the Simulation > Speed entries
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnSpeed(wxCommandEvent& event)
+{
+    int index = event.GetId() - IDM_SPEED;
+    if (index >= 0 && index < SpeedCount)
+    {
+        GetClock().SetSpeed(Speeds[index]);
+    }
+}
+
+/**
+ * Menu handler for Simulation > Fast Forward.
+ *
+ * Runs the aquarium forward by a number of minutes without
+ * drawing, then reports how fast that went.
+ *
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnFastForward(wxCommandEvent& event)
+{
+    long minutes = wxGetNumberFromUser(L"Minutes of simulated time to skip ahead:",
+            L"Minutes", L"Fast Forward", 10, 1, 24 * 60, this);
+    if (minutes <= 0)
+    {
+        return;
+    }
+
+    double rate = mAquarium->FastForward(minutes * 60.0, FastForwardStep);
+
+    // Don't count the time we spent fast-forwarding as a frame
+    mHost->ResetTime();
+    Refresh();
+
+    wxMessageBox(wxString::Format(L"Simulated %ld minutes at %.0f simulated seconds per second",
+            minutes, rate), L"Fast Forward", wxOK, this);
+}
+
+/**
+ * Menu handler for Simulation > Record Session.
+ *
+ * A trace has to start from a state it can rebuild, and .aqua
+ * files don't hold fish speeds, so recording starts a new empty
+ * session with a fresh random seed.
+ *
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnRecord(wxCommandEvent& event)
+{
+    wxFileDialog recordFileDialog(this, L"Record Session", L"", L"",
+            L"Aquarium Traces (*.aqtr)|*.aqtr", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (recordFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    // The tank is only cleared once we know the trace can be written
+    uint32_t seed = std::random_device()();
+    auto recorder = std::make_shared<SimulationRecorder>();
+    if (!recorder->Open(recordFileDialog.GetPath().ToStdString(), seed))
+    {
+        wxMessageBox(L"Unable to create trace file");
+        return;
+    }
+
+    mAquarium->SetRecorder(nullptr);
+    mAquarium->Clear();
+    mAquarium->Seed(seed);
+
+    // Start the trace with the current tank size and schooling setting
+    recorder->Resize(mAquarium->GetWidth(), mAquarium->GetHeight());
+    mAquarium->SetRecorder(recorder);
+    mAquarium->SetSchooling(mAquarium->IsSchooling());
+    Refresh();
+}
+
+/**
+ * Menu handler for Simulation > Stop Recording
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnStopRecording(wxCommandEvent& event)
+{
+    auto recorder = mAquarium->GetRecorder();
+    if (recorder == nullptr)
+    {
+        return;
+    }
+
+    mAquarium->SetRecorder(nullptr);
+    recorder->Close();
+
+    wxMessageBox(wxString::Format(L"Recorded %ld ticks", recorder->GetTicks()),
+            L"Record Session", wxOK, this);
+}
+
+/**
+ * Menu handler for Simulation > Replay Session.
+ *
+ * Replays the trace into a separate aquarium that is never drawn,
+ * then reports whether every tick matched the recording.
+ *
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnReplay(wxCommandEvent& event)
+{
+    wxFileDialog replayFileDialog(this, L"Replay Session", L"", L"",
+            L"Aquarium Traces (*.aqtr)|*.aqtr", wxFD_OPEN);
+    if (replayFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    SimulationReplayer replayer;
+    if (!replayer.Open(replayFileDialog.GetPath().ToStdString()))
+    {
+        if (replayer.IsUnsupportedVersion())
+        {
+            wxMessageBox(wxString::Format(L"Trace is format version %d, which this version can't replay (it reads %d)",
+                    (int)replayer.GetVersion(), (int)SimulationRecorder::Version), L"Replay Session", wxOK, this);
+        }
+        else
+        {
+            wxMessageBox(L"Unable to load trace file");
+        }
+        return;
+    }
+
+    Aquarium aquarium;
+    if (replayer.Replay(aquarium))
+    {
+        wxMessageBox(wxString::Format(L"Replayed %ld ticks, all matched", replayer.GetTicks()),
+                L"Replay Session", wxOK, this);
+    }
+    else if (replayer.GetFirstMismatch() >= 0)
+    {
+        wxMessageBox(wxString::Format(L"Replay diverged from the recording at tick %ld",
+                replayer.GetFirstMismatch()), L"Replay Session", wxOK, this);
+    }
+    else if (replayer.GetUnknownRecord() != 0)
+    {
+        wxMessageBox(wxString::Format(L"Trace has a record of unknown type %d after tick %ld",
+                replayer.GetUnknownRecord(), replayer.GetTicks()), L"Replay Session", wxOK, this);
+    }
+    else
+    {
+        wxMessageBox(wxString::Format(L"Trace is damaged after tick %ld", replayer.GetTicks()),
+                L"Replay Session", wxOK, this);
+    }
+
+    // Don't count the time we spent replaying as a frame
+    mHost->ResetTime();
+}
+
+/**
+ * Menu handler for Simulation > Export Video.
+ *
+ * Runs the aquarium forward for a number of seconds, rendering
+ * every frame offscreen at the tank size, and writes them as a
+ * PNG sequence or a Y4M video. Like Fast Forward, the tank is
+ * left that far ahead when it finishes.
+ *
+ * A day of frames takes a while, so the export shows its progress
+ * and can be cancelled. The progress dialog keeps the event loop
+ * running, so the other tanks, the frame pacer and the control
+ * queue carry on; this tank is held so the host leaves it to the
+ * exporter until it is done.
+ *
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void AquariumView::OnExportVideo(wxCommandEvent& event)
+{
+    wxFileDialog exportFileDialog(this, L"Export Video", L"", L"",
+            L"PNG Sequence (*.png)|*.png|Y4M Video (*.y4m)|*.y4m", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (exportFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    long seconds = wxGetNumberFromUser(L"Seconds of simulated time to export:",
+            L"Seconds", L"Export Video", 10, 1, 24 * 60 * 60, this);
+    if (seconds <= 0)
+    {
+        return;
+    }
+
+    VideoExporter exporter(ThreadPool::GetDefault());
+    exporter.SetFrameRate(ExportFrameRate);
+
+    // A PNG sequence is named after the file chosen, without its extension
+    wxFileName path(exportFileDialog.GetPath());
+    if (exportFileDialog.GetFilterIndex() == 0)
+    {
+        path.ClearExt();
+    }
+    else
+    {
+        exporter.SetFormat(VideoExporter::Format::Y4m);
+    }
+
+    long frames = seconds * ExportFrameRate;
+    wxProgressDialog progress(L"Export Video", L"Exporting...", (int)frames, this,
+            wxPD_CAN_ABORT | wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME);
+    exporter.SetOnProgress([&progress](long frame, long frames) {
+        return progress.Update((int)frame, wxString::Format(L"Frame %ld of %ld", frame, frames));
+    });
+
+    mHost->SetHeld(mTank, true);
+    bool ok = exporter.Export(*mAquarium, path.GetFullPath().ToStdString(), frames);
+    mHost->SetHeld(mTank, false);
+    Refresh();
+
+    if (exporter.IsCancelled())
+    {
+        wxLogStatus(L"Export cancelled after %ld frames", exporter.GetFrames());
+        return;
+    }
+
+    if (!ok)
+    {
+        wxMessageBox(wxString::Format(L"Export failed after %ld frames", exporter.GetFrames()));
+        return;
+    }
+
+    wxMessageBox(wxString::Format(L"Exported %ld frames at %.1f frames per second (%.0f%% of the time drawing)",
+            exporter.GetFrames(), exporter.GetFramesPerSecond(),
+            exporter.GetTotalTime() > 0 ? exporter.GetRenderTime() * 100 / exporter.GetTotalTime() : 0),
+            L"Export Video", wxOK, this);
+}
+
 /**
  * Save the aquarium to a file.
  * @param event The wxCommandEvent triggered by the menu
@@ -193,7 +668,10 @@ void AquariumView::OnFileSaveAs(wxCommandEvent& event)
 	auto filename = saveFileDialog.GetPath();
 
 	// Call the Save function of Aquarium to handle saving the file
-	mAquarium.Save(filename);
+	if (!mAquarium->Save(filename))
+	{
+		wxMessageBox(L"Write to XML failed");
+	}
 }
 /**
  * Save the aquarium to the specified filename.
@@ -220,18 +698,16 @@ void AquariumView::OnFileOpen(wxCommandEvent& event)
 	}
 
 	auto filename = loadFileDialog.GetPath();
-	mAquarium.Load(filename);
+	if (!mAquarium->Load(filename))
+	{
+		wxMessageBox(L"Unable to load Aquarium file");
+	}
+	else if (mAquarium->GetLoadRefused() > 0)
+	{
+		wxMessageBox(wxString::Format(L"The tank is over its memory budget, so %d items were left out",
+				(int)mAquarium->GetLoadRefused()));
+	}
 
 	// Trigger a refresh to redraw the view after loading the aquarium
 	Refresh();
 }
-
-
-/**
- * Handle the timer event for animation.
- * @param event Timer event object
- */
-void AquariumView::OnTimer(wxTimerEvent &event)
-{
-	Refresh();  // Repaint the window every time the timer event is triggered
-}
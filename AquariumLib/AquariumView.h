@@ -9,9 +9,13 @@
 #define AQUARIUM_AQUARIUMVIEW_H
 
 #include "Aquarium.h"
+#include "Viewport.h"
+#include "SimulationClock.h"
+#include "FrameRingWriter.h"
 #include <wx/window.h>
 
 
+class TankHost;
 
 /**
  * View class for our aquarium
@@ -20,37 +24,113 @@ class AquariumView : public wxWindow {
 private:
 	void OnPaint(wxPaintEvent &event);  // Event handler for painting the view
 
+	/// Host that updates the aquarium
+	std::shared_ptr<TankHost> mHost;
+
+	/// Index of our tank in the host
+	size_t mTank = 0;
+
 	/// The aquarium we are viewing
-	Aquarium mAquarium;
+	std::shared_ptr<Aquarium> mAquarium;
+
+	/// The part of the aquarium we are showing
+	Viewport mViewport;
+
+	/// True while the right button is dragging the view around
+	bool mPanning = false;
+
+	/// Last mouse X while panning
+	int mPanX = 0;
+
+	/// Last mouse Y while panning
+	int mPanY = 0;
 
-	/// Menu handlers for adding fish and decor
-	void OnAddFishBetaFish(wxCommandEvent& event);
-	void OnAddFishNemo(wxCommandEvent& event);
-	void OnAddFishGoldeen(wxCommandEvent& event);
-	void OnAddDecorCastle(wxCommandEvent& event);  // Moved to private section (already declared in public)
+	/// Menu handler for adding fish and decor
+	void OnAddSpecies(wxCommandEvent& event);
+
+	/// Menu handler for Behavior > Schooling
+	void OnSchooling(wxCommandEvent& event);
 
 	/// Mouse event handlers for dragging items
 	void OnLeftDown(wxMouseEvent &event);
 	void OnLeftUp(wxMouseEvent &event);
 	void OnMouseMove(wxMouseEvent &event);
 
-	std::shared_ptr<Item> mGrabbedItem;  // The item being dragged, if any
+	/// Mouse event handlers for panning and zooming the view
+	void OnRightDown(wxMouseEvent &event);
+	void OnRightUp(wxMouseEvent &event);
+	void OnMouseWheel(wxMouseEvent &event);
 
-	/// The timer that allows for animation
-	wxTimer mTimer;
+	/// Resizes the tank to fill the window
+	void OnSize(wxSizeEvent &event);
 
-	/// Handle the timer event for animation
-	void OnTimer(wxTimerEvent& event);  // Declare OnTimer event handler here
+	/// Menu handlers for the View menu
+	void OnZoomIn(wxCommandEvent& event);
+	void OnZoomOut(wxCommandEvent& event);
+	void OnZoomReset(wxCommandEvent& event);
 
-	/// Stopwatch used to measure elapsed time
+	std::shared_ptr<Item> mGrabbedItem;  // The item being dragged, if any
+
+	/// Stopwatch used to time the first paint
 	wxStopWatch mStopWatch;
 
+	/// True once the window has been painted
+	bool mPainted = false;
+
+	/// Aquarium revision the window was last painted at
+	uint64_t mPaintedRevision = 0;
 
-	/// The last stopwatch time
-	long mTime = 0;
+	/// Ring the frames are published to, or nullptr if they aren't
+	std::unique_ptr<FrameRingWriter> mFrameRing;
+
+	/// True once a frame too big for the ring has been reported
+	bool mFrameTooBig = false;
+
+	void Render(wxDC *dc, const wxSize &size);
+
+	/// Menu handler for View > Publish Frames
+	void OnPublishFrames(wxCommandEvent& event);
+
+	SimulationClock &GetClock();
+
+	/// Menu handlers for the Simulation menu
+	void OnPause(wxCommandEvent& event);
+	void OnStep(wxCommandEvent& event);
+	void OnSpeed(wxCommandEvent& event);
+	void OnFastForward(wxCommandEvent& event);
+	void OnRecord(wxCommandEvent& event);
+	void OnStopRecording(wxCommandEvent& event);
+	void OnReplay(wxCommandEvent& event);
+	void OnExportVideo(wxCommandEvent& event);
 
 public:
-	void Initialize(wxFrame *parent);  // Initialization method
+	/// Speed multipliers offered by the Simulation menu, in menu order
+	static const double Speeds[];
+
+	/// Number of entries in Speeds
+	static const int SpeedCount;
+
+	void Initialize(wxWindow *parent, std::shared_ptr<TankHost> host, size_t tank);  // Initialization method
+
+	/**
+	 * Get the aquarium we are viewing
+	 * @return Aquarium
+	 */
+	std::shared_ptr<Aquarium> GetAquarium() const { return mAquarium; }
+
+	/**
+	 * Get the index of our tank in the host
+	 * @return Tank index
+	 */
+	size_t GetTank() const { return mTank; }
+
+	/**
+	 * Are the frames being published to shared memory?
+	 * @return True if publishing frames
+	 */
+	bool IsPublishingFrames() const { return mFrameRing != nullptr; }
+
+	bool IsStale() const;
 
 	/// File handling
 	void OnFileSaveAs(wxCommandEvent& event);  // Public save handler
@@ -0,0 +1,128 @@
+/**
+ * @file AssetLoader.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "AssetLoader.h"
+#include "Aquarium.h"
+#include "SpeciesRegistry.h"
+#include "Sprite.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param sprites Cache to load the sprites into
+ * @param pool Pool to decode the images on
+ */
+AssetLoader::AssetLoader(std::shared_ptr<SpriteCache> sprites, std::shared_ptr<ThreadPool> pool) :
+    mSprites(sprites), mPool(pool)
+{
+}
+
+/**
+ * Destructor. Waits for any images still being decoded, since
+ * the decoding tasks report back to this loader.
+ */
+AssetLoader::~AssetLoader()
+{
+    Wait();
+}
+
+/**
+ * Queue images to be decoded.
+ *
+ * Images already in the cache are left alone. The sprites are
+ * in the cache when this returns, but may not be decoded yet.
+ *
+ * @param filenames The image files
+ */
+void AssetLoader::Load(const std::vector<std::wstring> &filenames)
+{
+    for (auto &filename : filenames)
+    {
+        auto sprite = mSprites->Preload(filename);
+        if (sprite->IsReady())
+        {
+            continue;
+        }
+
+        {
+            lock_guard<mutex> lock(mMutex);
+            if (mPending++ == 0 && mStart == chrono::steady_clock::time_point())
+            {
+                mStart = chrono::steady_clock::now();
+            }
+        }
+
+        mPool->Submit([this, sprite] {
+            sprite->Decode();
+
+            lock_guard<mutex> lock(mMutex);
+            if (--mPending == 0)
+            {
+                mFinish = chrono::steady_clock::now();
+                mDone.notify_all();
+            }
+        });
+    }
+}
+
+/**
+ * Queue the background and the image of every species.
+ *
+ * The background goes first since it is by far the largest.
+ *
+ * @param registry Species to load the images of
+ */
+void AssetLoader::Load(const SpeciesRegistry &registry)
+{
+    vector<wstring> filenames = {Aquarium::BackgroundImage};
+    for (auto &species : registry.GetSpecies())
+    {
+        filenames.push_back(species->mImage);
+        for (auto &frame : species->mFrames)
+        {
+            filenames.push_back(frame);
+        }
+    }
+
+    Load(filenames);
+}
+
+/**
+ * Number of images still to be decoded
+ * @return Pending image count
+ */
+size_t AssetLoader::GetPending()
+{
+    lock_guard<mutex> lock(mMutex);
+    return mPending;
+}
+
+/**
+ * Wait for every queued image to be decoded
+ */
+void AssetLoader::Wait()
+{
+    unique_lock<mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mPending == 0; });
+}
+
+/**
+ * How long the images took to load
+ * @return Seconds from the first image being queued to the last one
+ * being decoded, or 0 if they aren't all decoded yet
+ */
+double AssetLoader::GetLoadTime()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mPending > 0 || mStart == chrono::steady_clock::time_point())
+    {
+        return 0;
+    }
+
+    return chrono::duration<double>(mFinish - mStart).count();
+}
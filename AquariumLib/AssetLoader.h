@@ -0,0 +1,82 @@
+/**
+ * @file AssetLoader.h
+ * @author Ismail Abdi
+ *
+ * Decodes images on worker threads at startup.
+ */
+
+#ifndef AQUARIUM_ASSETLOADER_H
+#define AQUARIUM_ASSETLOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class SpriteCache;
+class SpeciesRegistry;
+class ThreadPool;
+
+/**
+ * Decodes images on worker threads at startup.
+ *
+ * Each image is added to the sprite cache straight away, undecoded,
+ * and a task to decode it is queued on the thread pool. Anything
+ * that gets one of these sprites before it is decoded draws a
+ * placeholder instead of waiting, so the window can be shown and
+ * painted while the images are still loading.
+ */
+class AssetLoader {
+private:
+    /// Cache the sprites are loaded into
+    std::shared_ptr<SpriteCache> mSprites;
+
+    /// Pool the images are decoded on
+    std::shared_ptr<ThreadPool> mPool;
+
+    /// Number of images queued and not decoded yet
+    size_t mPending = 0;
+
+    /// When the first image was queued
+    std::chrono::steady_clock::time_point mStart;
+
+    /// When the last image finished decoding
+    std::chrono::steady_clock::time_point mFinish;
+
+    /// Protects mPending and mFinish
+    std::mutex mMutex;
+
+    /// Signalled when the last pending image is decoded
+    std::condition_variable mDone;
+
+public:
+    AssetLoader(std::shared_ptr<SpriteCache> sprites, std::shared_ptr<ThreadPool> pool);
+
+    virtual ~AssetLoader();
+
+    /// Copy constructor (disabled)
+    AssetLoader(const AssetLoader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AssetLoader &) = delete;
+
+    void Load(const std::vector<std::wstring> &filenames);
+
+    void Load(const SpeciesRegistry &registry);
+
+    size_t GetPending();
+
+    /**
+     * Has everything queued been decoded?
+     * @return True if nothing is left to decode
+     */
+    bool IsDone() { return GetPending() == 0; }
+
+    void Wait();
+
+    double GetLoadTime();
+};
+
+#endif //AQUARIUM_ASSETLOADER_H
@@ -0,0 +1,650 @@
+/**
+ * @file BehaviorScript.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "BehaviorScript.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+#include <cwctype>
+#include <map>
+
+using namespace std;
+
+/// Names of the built in variables, in Variable order
+static const wchar_t *const VariableNames[] = {
+    L"t", L"dt", L"x", L"y", L"vx", L"vy", L"dx", L"dy", L"w", L"h",
+    L"n", L"nx", L"ny", L"nvx", L"nvy", L"amplitude", L"frequency", L"acceleration"};
+
+/// Most variables or constants a script can have
+const size_t MaxArguments = 65535;
+
+/**
+ * Turns the text of a script into bytecode.
+ *
+ * A recursive descent parser that emits stack machine code as it
+ * goes, tracking how deep the stack gets. Stops at the first error.
+ */
+class BehaviorScript::Compiler {
+private:
+    /// The text being compiled
+    const wstring &mSource;
+
+    /// Position in the text
+    size_t mPos = 0;
+
+    /// The script being built
+    BehaviorScript &mScript;
+
+    /// The first error, or empty if there isn't one
+    wstring mError;
+
+    /// Variable index of each name
+    map<wstring, size_t> mNames;
+
+    /// True for each variable that can be read
+    vector<bool> mReadable;
+
+    /// Current stack depth
+    size_t mDepth = 0;
+
+public:
+    /**
+     * Constructor
+     * @param source Text of the script
+     * @param script Script to compile into
+     */
+    Compiler(const wstring &source, BehaviorScript &script) : mSource(source), mScript(script)
+    {
+        for (size_t i = 0; i < BuiltinCount; i++)
+        {
+            mNames[VariableNames[i]] = i;
+        }
+        mReadable.assign(BuiltinCount, true);
+    }
+
+    /**
+     * Compile the whole script
+     * @return Error message, or empty if it compiled
+     */
+    wstring Compile()
+    {
+        while (mError.empty())
+        {
+            SkipSpace(true);
+            if (mPos >= mSource.size())
+            {
+                break;
+            }
+
+            Statement();
+            SkipSpace(false);
+            if (mPos < mSource.size() && mSource[mPos] != L';' && mSource[mPos] != L'\n')
+            {
+                Fail(L"expected ; or a new line");
+            }
+        }
+
+        return mError;
+    }
+
+private:
+    /**
+     * Note an error, if there isn't one already
+     * @param message What went wrong
+     */
+    void Fail(const wstring &message)
+    {
+        if (mError.empty())
+        {
+            mError = message + L" at character " + to_wstring(mPos + 1);
+        }
+    }
+
+    /**
+     * Add an instruction
+     * @param op Operation
+     * @param argument Variable or constant index
+     * @param pushed Change in stack depth
+     */
+    void Emit(Op op, size_t argument, int pushed)
+    {
+        mScript.mCode.push_back({op, (uint16_t)argument});
+        mDepth += pushed;
+        mScript.mStackDepth = max(mScript.mStackDepth, mDepth);
+    }
+
+    /**
+     * Skip spaces and comments, which run from # to the end of the line
+     * @param newLines True to skip statement separators too
+     */
+    void SkipSpace(bool newLines)
+    {
+        while (mPos < mSource.size())
+        {
+            auto c = mSource[mPos];
+            if (c == L'#')
+            {
+                while (mPos < mSource.size() && mSource[mPos] != L'\n')
+                {
+                    mPos++;
+                }
+            }
+            else if (c == L' ' || c == L'\t' || c == L'\r' || (newLines && (c == L'\n' || c == L';')))
+            {
+                mPos++;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Skip past a piece of punctuation if it is next
+     * @param text The punctuation
+     * @return True if it was there
+     */
+    bool Accept(const wchar_t *text)
+    {
+        SkipSpace(false);
+        auto length = wcslen(text);
+        if (mSource.compare(mPos, length, text) != 0)
+        {
+            return false;
+        }
+
+        mPos += length;
+        return true;
+    }
+
+    /**
+     * Require a piece of punctuation
+     * @param text The punctuation
+     */
+    void Expect(const wchar_t *text)
+    {
+        if (!Accept(text))
+        {
+            Fail(wstring(L"expected ") + text);
+        }
+    }
+
+    /**
+     * Read a name if one is next
+     * @return The name, or empty if there isn't one
+     */
+    wstring Name()
+    {
+        SkipSpace(false);
+        size_t start = mPos;
+        while (mPos < mSource.size() && (iswalnum(mSource[mPos]) || mSource[mPos] == L'_') &&
+                (mPos > start || !iswdigit(mSource[mPos])))
+        {
+            mPos++;
+        }
+
+        return mSource.substr(start, mPos - start);
+    }
+
+    /**
+     * Compile an assignment: name = expression
+     */
+    void Statement()
+    {
+        auto name = Name();
+        if (name.empty())
+        {
+            Fail(L"expected a variable to assign to");
+            return;
+        }
+
+        auto found = mNames.find(name);
+        if (found != mNames.end() && found->second < BuiltinCount &&
+                (found->second < SpeedX || found->second > MoveY))
+        {
+            Fail(name + L" can't be assigned to");
+            return;
+        }
+
+        Expect(L"=");
+        Expression();
+
+        // Only readable once it has been assigned
+        size_t variable;
+        if (found != mNames.end())
+        {
+            variable = found->second;
+        }
+        else
+        {
+            variable = mScript.mVariables++;
+            if (variable >= MaxArguments)
+            {
+                Fail(L"too many variables");
+                return;
+            }
+            mNames[name] = variable;
+            mReadable.push_back(false);
+        }
+
+        mReadable[variable] = true;
+        Emit(Op::Store, variable, -1);
+    }
+
+    /**
+     * Compile an expression, with an optional c ? a : b
+     */
+    void Expression()
+    {
+        Comparison();
+        if (Accept(L"?"))
+        {
+            Expression();
+            Expect(L":");
+            Expression();
+            Emit(Op::Select, 0, -2);
+        }
+    }
+
+    /**
+     * Compile a comparison, or just an arithmetic expression
+     */
+    void Comparison()
+    {
+        Additive();
+
+        // Two character operators first, so <= isn't read as <
+        static const pair<const wchar_t *, Op> operators[] = {
+            {L"<=", Op::LessEqual}, {L">=", Op::GreaterEqual}, {L"==", Op::Equal}, {L"!=", Op::NotEqual},
+            {L"<", Op::Less}, {L">", Op::Greater}};
+        for (auto &op : operators)
+        {
+            if (Accept(op.first))
+            {
+                Additive();
+                Emit(op.second, 0, -1);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Compile additions and subtractions
+     */
+    void Additive()
+    {
+        Term();
+        while (mError.empty())
+        {
+            if (Accept(L"+"))
+            {
+                Term();
+                Emit(Op::Add, 0, -1);
+            }
+            else if (Accept(L"-"))
+            {
+                Term();
+                Emit(Op::Subtract, 0, -1);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Compile multiplications and divisions
+     */
+    void Term()
+    {
+        Unary();
+        while (mError.empty())
+        {
+            if (Accept(L"*"))
+            {
+                Unary();
+                Emit(Op::Multiply, 0, -1);
+            }
+            else if (Accept(L"/"))
+            {
+                Unary();
+                Emit(Op::Divide, 0, -1);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Compile a negation, or a primary expression
+     */
+    void Unary()
+    {
+        if (Accept(L"-"))
+        {
+            Unary();
+            Emit(Op::Negate, 0, 0);
+            return;
+        }
+
+        Primary();
+    }
+
+    /**
+     * Compile a number, variable, function call or parenthesised expression
+     */
+    void Primary()
+    {
+        SkipSpace(false);
+        if (mPos >= mSource.size())
+        {
+            Fail(L"expected a value");
+            return;
+        }
+
+        if (Accept(L"("))
+        {
+            Expression();
+            Expect(L")");
+            return;
+        }
+
+        if (iswdigit(mSource[mPos]) || mSource[mPos] == L'.')
+        {
+            auto start = mSource.c_str() + mPos;
+            wchar_t *end = nullptr;
+            double value = wcstod(start, &end);
+            if (end == start)
+            {
+                Fail(L"expected a number");
+                return;
+            }
+            mPos += end - start;
+
+            if (mScript.mConstants.size() >= MaxArguments)
+            {
+                Fail(L"too many constants");
+                return;
+            }
+            mScript.mConstants.push_back(value);
+            Emit(Op::Constant, mScript.mConstants.size() - 1, 1);
+            return;
+        }
+
+        auto name = Name();
+        if (name.empty())
+        {
+            Fail(L"expected a value");
+            return;
+        }
+
+        if (Accept(L"("))
+        {
+            Call(name);
+            return;
+        }
+
+        auto found = mNames.find(name);
+        if (found == mNames.end() || !mReadable[found->second])
+        {
+            Fail(L"unknown name " + name);
+            return;
+        }
+
+        if (found->second >= Neighbors && found->second <= NeighborSpeedY)
+        {
+            mScript.mUsesNeighbors = true;
+        }
+        Emit(Op::Load, found->second, 1);
+    }
+
+    /**
+     * Compile a function call, after the opening parenthesis
+     * @param name Function name
+     */
+    void Call(const wstring &name)
+    {
+        static const struct {
+            const wchar_t *mName;
+            Op mOp;
+            int mArguments;
+        } functions[] = {
+            {L"sin", Op::Sin, 1}, {L"cos", Op::Cos, 1}, {L"abs", Op::Abs, 1}, {L"sqrt", Op::Sqrt, 1},
+            {L"min", Op::Min, 2}, {L"max", Op::Max, 2}, {L"clamp", Op::Clamp, 3}};
+
+        for (auto &function : functions)
+        {
+            if (name == function.mName)
+            {
+                for (int i = 0; i < function.mArguments; i++)
+                {
+                    if (i > 0)
+                    {
+                        Expect(L",");
+                    }
+                    Expression();
+                }
+                Expect(L")");
+                Emit(function.mOp, 0, 1 - function.mArguments);
+                return;
+            }
+        }
+
+        Fail(L"unknown function " + name);
+    }
+};
+
+/**
+ * Compile a script
+ * @param source Text of the script
+ * @param error Output: what was wrong with it, if it didn't compile
+ * @return The compiled script, or nullptr if it didn't compile
+ */
+std::shared_ptr<const BehaviorScript> BehaviorScript::Compile(const std::wstring &source, std::wstring &error)
+{
+    auto script = make_shared<BehaviorScript>();
+    Compiler compiler(source, *script);
+    error = compiler.Compile();
+    if (!error.empty())
+    {
+        return nullptr;
+    }
+
+    return script;
+}
+
+/**
+ * Size a batch for some number of fish. The built in variables
+ * are then filled in through Batch::Column before calling Run.
+ * @param batch Batch to size
+ * @param count Number of fish
+ */
+void BehaviorScript::Prepare(Batch &batch, size_t count) const
+{
+    batch.mCount = count;
+    batch.mVariables.resize(mVariables * count);
+    batch.mStack.resize(max(mStackDepth, (size_t)1) * count);
+}
+
+/**
+ * Run the script on a batch of fish prepared with Prepare
+ * @param batch Batch to run on. The variables are updated in place.
+ */
+void BehaviorScript::Run(Batch &batch) const
+{
+    size_t n = batch.mCount;
+    double *variables = batch.mVariables.data();
+    double *stack = batch.mStack.data();
+    size_t top = 0;
+
+    // Column of a stack slot
+    auto slot = [stack, n](size_t index) { return stack + index * n; };
+
+    for (auto &instruction : mCode)
+    {
+        switch (instruction.mOp)
+        {
+        case Op::Load:
+        {
+            auto from = variables + instruction.mArgument * n;
+            copy(from, from + n, slot(top++));
+            break;
+        }
+
+        case Op::Constant:
+        {
+            auto to = slot(top++);
+            fill(to, to + n, mConstants[instruction.mArgument]);
+            break;
+        }
+
+        case Op::Store:
+        {
+            auto from = slot(--top);
+            copy(from, from + n, variables + instruction.mArgument * n);
+            break;
+        }
+
+        case Op::Add:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] += b[i]; }
+            break;
+        }
+
+        case Op::Subtract:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] -= b[i]; }
+            break;
+        }
+
+        case Op::Multiply:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] *= b[i]; }
+            break;
+        }
+
+        case Op::Divide:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] /= b[i]; }
+            break;
+        }
+
+        case Op::Negate:
+        {
+            auto a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = -a[i]; }
+            break;
+        }
+
+        case Op::Less:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] < b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::LessEqual:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] <= b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::Greater:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] > b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::GreaterEqual:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] >= b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::Equal:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] == b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::NotEqual:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = a[i] != b[i] ? 1 : 0; }
+            break;
+        }
+
+        case Op::Select:
+        {
+            auto no = slot(--top), yes = slot(--top), condition = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { condition[i] = condition[i] != 0 ? yes[i] : no[i]; }
+            break;
+        }
+
+        case Op::Sin:
+        {
+            auto a = slot(top - 1);
+            FastSin(a, a, n);
+            break;
+        }
+
+        case Op::Cos:
+        {
+            auto a = slot(top - 1);
+            FastCos(a, a, n);
+            break;
+        }
+
+        case Op::Abs:
+        {
+            auto a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = fabs(a[i]); }
+            break;
+        }
+
+        case Op::Sqrt:
+        {
+            auto a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = sqrt(a[i]); }
+            break;
+        }
+
+        case Op::Min:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = min(a[i], b[i]); }
+            break;
+        }
+
+        case Op::Max:
+        {
+            auto b = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = max(a[i], b[i]); }
+            break;
+        }
+
+        case Op::Clamp:
+        {
+            auto high = slot(--top), low = slot(--top), a = slot(top - 1);
+            for (size_t i = 0; i < n; i++) { a[i] = min(max(a[i], low[i]), high[i]); }
+            break;
+        }
+        }
+    }
+}
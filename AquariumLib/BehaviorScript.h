@@ -0,0 +1,166 @@
+/**
+ * @file BehaviorScript.h
+ * @author Ismail Abdi
+ *
+ * A small language for writing fish behaviours in the species file.
+ */
+
+#ifndef AQUARIUM_BEHAVIORSCRIPT_H
+#define AQUARIUM_BEHAVIORSCRIPT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * A small language for writing fish behaviours in the species file.
+ *
+ * A script is a list of assignments, separated by semicolons or
+ * new lines, run once per fish per update:
+ *
+ *     dy = amplitude * sin(frequency * x * 0.01) * dt
+ *     vx = n > 0 ? vx + (nvx - vx) * dt : vx
+ *
+ * Expressions have the usual arithmetic, comparisons (which give
+ * 1 or 0), `c ? a : b`, and the functions sin, cos, abs, sqrt,
+ * min, max and clamp. sin and cos are FastSin and FastCos, which
+ * are within 1e-11 of the exact values. A script reads the built in variables below
+ * and can assign to vx, vy, dx and dy. Any other name it assigns
+ * to is a variable of its own, which must be assigned before it
+ * is read. After the script, the fish's speed is limited as
+ * usual and it moves by vx and vy times dt plus dx and dy.
+ *
+ * Scripts are compiled once into bytecode for a stack machine.
+ * The interpreter doesn't run a fish at a time: each instruction
+ * is applied to a whole batch of fish before the next, with every
+ * variable and stack slot held as a column with one value per
+ * fish. The dispatch cost is paid once per instruction per batch
+ * rather than per fish, and the inner loops are plain loops over
+ * arrays that the compiler can vectorize.
+ */
+class BehaviorScript {
+public:
+    /// The built in variables, in column order
+    enum Variable {
+        Time,           ///< t, simulated seconds
+        Elapsed,        ///< dt, seconds since the last update
+        X,              ///< x, location in pixels
+        Y,              ///< y, location in pixels
+        SpeedX,         ///< vx, speed in pixels per second
+        SpeedY,         ///< vy, speed in pixels per second
+        MoveX,          ///< dx, extra distance to move this update, 0 to start with
+        MoveY,          ///< dy, extra distance to move this update, 0 to start with
+        Width,          ///< w, tank width in pixels
+        Height,         ///< h, tank height in pixels
+        Neighbors,      ///< n, fish of the same species within the school radius
+        NeighborX,      ///< nx, X offset to the neighbours' centre
+        NeighborY,      ///< ny, Y offset to the neighbours' centre
+        NeighborSpeedX, ///< nvx, neighbours' mean X speed
+        NeighborSpeedY, ///< nvy, neighbours' mean Y speed
+        Amplitude,      ///< amplitude, the species' wave amplitude
+        Frequency,      ///< frequency, the species' wave frequency
+        Acceleration,   ///< acceleration, the species' acceleration
+        BuiltinCount    ///< Number of built in variables
+    };
+
+    /**
+     * The values a script runs on for a batch of fish.
+     *
+     * Each variable is a column of values, one per fish. Keep a
+     * batch around between updates and it stops allocating once
+     * it has grown to the largest batch.
+     */
+    class Batch {
+    private:
+        /// Number of fish
+        size_t mCount = 0;
+
+        /// The variable columns, one after another
+        std::vector<double> mVariables;
+
+        /// The stack columns, one after another
+        std::vector<double> mStack;
+
+        friend class BehaviorScript;
+
+    public:
+        /**
+         * Number of fish in the batch
+         * @return Fish count
+         */
+        size_t GetCount() const { return mCount; }
+
+        /**
+         * Get the column of a variable
+         * @param variable Variable index
+         * @return One value per fish
+         */
+        double *Column(size_t variable) { return &mVariables[variable * mCount]; }
+    };
+
+private:
+    /// Bytecode operations
+    enum class Op : uint8_t {
+        Load, Constant, Store,
+        Add, Subtract, Multiply, Divide, Negate,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, Select,
+        Sin, Cos, Abs, Sqrt, Min, Max, Clamp
+    };
+
+    /// One bytecode instruction
+    struct Instruction {
+        /// Operation
+        Op mOp;
+
+        /// Variable for Load and Store, constant index for Constant
+        uint16_t mArgument;
+    };
+
+    /// The bytecode
+    std::vector<Instruction> mCode;
+
+    /// Constants the bytecode uses
+    std::vector<double> mConstants;
+
+    /// Number of variables, built in and the script's own
+    size_t mVariables = BuiltinCount;
+
+    /// Deepest the stack gets
+    size_t mStackDepth = 0;
+
+    /// True if the script reads any of the neighbour variables
+    bool mUsesNeighbors = false;
+
+    class Compiler;
+
+public:
+    BehaviorScript() {}
+
+    static std::shared_ptr<const BehaviorScript> Compile(const std::wstring &source, std::wstring &error);
+
+    /**
+     * Number of variables, built in and the script's own
+     * @return Variable count
+     */
+    size_t GetVariableCount() const { return mVariables; }
+
+    /**
+     * Does the script read n, nx, ny, nvx or nvy? If not
+     * there's no need to find the neighbours.
+     * @return True if it needs the neighbours
+     */
+    bool UsesNeighbors() const { return mUsesNeighbors; }
+
+    /**
+     * Number of bytecode instructions
+     * @return Instruction count
+     */
+    size_t GetSize() const { return mCode.size(); }
+
+    void Prepare(Batch &batch, size_t count) const;
+
+    void Run(Batch &batch) const;
+};
+
+#endif //AQUARIUM_BEHAVIORSCRIPT_H
@@ -0,0 +1,124 @@
+/**
+ * @file CommandQueue.h
+ * @author Ismail Abdi
+ *
+ * Lock-free queue for handing changes to the thread that makes them.
+ */
+
+#ifndef AQUARIUM_COMMANDQUEUE_H
+#define AQUARIUM_COMMANDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Lock-free queue for handing changes to the thread that makes them.
+ *
+ * Any number of threads can push; one thread at a time drains.
+ * Pushing is a single compare-and-swap onto a linked stack, and
+ * draining swaps the whole stack out at once and reverses it, so
+ * commands come out in the order they were pushed. No thread ever
+ * waits for another, and because the consumer only ever takes the
+ * entire stack there is no ABA problem to guard against.
+ *
+ * Each push allocates one node. Commands are rare next to the
+ * frames that drain them, so that is cheaper than the cache line
+ * traffic of a preallocated ring.
+ *
+ * @tparam T Type of command
+ */
+template <class T>
+class CommandQueue {
+private:
+    /// One queued command
+    struct Node {
+        /// The command
+        T mCommand;
+
+        /// The command pushed before this one
+        Node *mNext = nullptr;
+    };
+
+    /// The most recently pushed command, or nullptr if the queue is empty
+    std::atomic<Node *> mHead{nullptr};
+
+public:
+    CommandQueue() {}
+
+    /**
+     * Destructor. Discards any commands still queued.
+     */
+    ~CommandQueue()
+    {
+        auto node = mHead.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr)
+        {
+            auto next = node->mNext;
+            delete node;
+            node = next;
+        }
+    }
+
+    /// Copy constructor (disabled)
+    CommandQueue(const CommandQueue &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const CommandQueue &) = delete;
+
+    /**
+     * Queue a command. Safe to call from any thread.
+     * @param command Command to queue
+     */
+    void Push(T command)
+    {
+        auto node = new Node{std::move(command)};
+        node->mNext = mHead.load(std::memory_order_relaxed);
+        while (!mHead.compare_exchange_weak(node->mNext, node,
+                std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * Take every queued command and hand each to a function,
+     * oldest first. Only one thread may drain at a time.
+     * @param handle Called with each command
+     * @return Number of commands handled
+     */
+    template <class Handler>
+    size_t Drain(Handler handle)
+    {
+        auto node = mHead.exchange(nullptr, std::memory_order_acquire);
+
+        // The stack is newest first; turn it round
+        Node *oldest = nullptr;
+        while (node != nullptr)
+        {
+            auto next = node->mNext;
+            node->mNext = oldest;
+            oldest = node;
+            node = next;
+        }
+
+        size_t count = 0;
+        while (oldest != nullptr)
+        {
+            auto next = oldest->mNext;
+            handle(oldest->mCommand);
+            delete oldest;
+            oldest = next;
+            count++;
+        }
+
+        return count;
+    }
+
+    /**
+     * Is anything queued? Only a hint while other threads push.
+     * @return True if there are no commands waiting
+     */
+    bool IsEmpty() const { return mHead.load(std::memory_order_relaxed) == nullptr; }
+};
+
+#endif //AQUARIUM_COMMANDQUEUE_H
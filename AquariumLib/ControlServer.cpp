@@ -0,0 +1,849 @@
+/**
+ * @file ControlServer.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "ControlServer.h"
+#include "TankHost.h"
+#include "Aquarium.h"
+#include "Item.h"
+#include "SpeciesRegistry.h"
+#include "Metrics.h"
+#include "AquariumSnapshot.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+/// A socket as the system calls take it
+using SocketHandle = SOCKET;
+#else
+/// A socket as the system calls take it
+using SocketHandle = int;
+#endif
+
+using namespace std;
+
+/// Number of recent ticks the percentiles are worked out from
+const size_t SampleCount = 256;
+
+/// Longest request we will read, in bytes
+const size_t MaxRequest = 8192;
+
+/// Seconds a client has to send its request
+const int RequestTimeout = 2;
+
+/// Milliseconds the server thread waits for a connection before checking for Stop
+const int AcceptTimeout = 100;
+
+/**
+ * Close a socket
+ * @param socket Socket to close
+ */
+static void CloseSocket(intptr_t socket)
+{
+#ifdef _WIN32
+    closesocket((SocketHandle)socket);
+#else
+    close((SocketHandle)socket);
+#endif
+}
+
+/**
+ * Decode the %XX escapes and + signs in part of a URL
+ * @param text Text to decode
+ * @return Decoded text
+ */
+static string UrlDecode(const string &text)
+{
+    string decoded;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] == '+')
+        {
+            decoded += ' ';
+        }
+        else if (text[i] == '%' && i + 2 < text.size() && isxdigit((unsigned char)text[i + 1]) &&
+                isxdigit((unsigned char)text[i + 2]))
+        {
+            decoded += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        }
+        else
+        {
+            decoded += text[i];
+        }
+    }
+
+    return decoded;
+}
+
+/**
+ * Escape a string for a JSON document
+ * @param text UTF-8 text
+ * @return Quoted and escaped string
+ */
+static string JsonString(const string &text)
+{
+    string json = "\"";
+    for (auto c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            json += '\\';
+            json += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            json += escape;
+        }
+        else
+        {
+            json += c;
+        }
+    }
+
+    return json + "\"";
+}
+
+/**
+ * Convert text from the API to a wide string
+ * @param text UTF-8 text
+ * @return Wide string
+ */
+static wstring FromUtf8(const string &text)
+{
+    return wxString::FromUTF8(text.data(), text.size()).ToStdWstring();
+}
+
+/**
+ * Convert a wide string to UTF-8 for the API
+ * @param text Wide string
+ * @return UTF-8 text
+ */
+static string ToUtf8(const wstring &text)
+{
+    return string(wxString(text).ToUTF8().data());
+}
+
+/**
+ * Format a number for a JSON document
+ * @param value Number
+ * @return Text of the number
+ */
+static string JsonNumber(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+/**
+ * Format percentiles for a JSON document
+ * @param percentiles Percentiles
+ * @return JSON object
+ */
+static string JsonPercentiles(const ControlServer::Percentiles &percentiles)
+{
+    return "{\"p50\":" + JsonNumber(percentiles.mP50) + ",\"p95\":" + JsonNumber(percentiles.mP95) +
+            ",\"p99\":" + JsonNumber(percentiles.mP99) + "}";
+}
+
+/**
+ * Make the body of an error response
+ * @param message What went wrong
+ * @return JSON object
+ */
+static string JsonError(const string &message)
+{
+    return "{\"error\":" + JsonString(message) + "}";
+}
+
+/**
+ * Constructor. Serves the process-wide metrics.
+ */
+ControlServer::ControlServer() : ControlServer(Metrics::GetDefault())
+{
+}
+
+/**
+ * Constructor
+ * @param metrics Metrics to serve at /metrics
+ */
+ControlServer::ControlServer(std::shared_ptr<Metrics> metrics) :
+    mMetrics(metrics), mLastSample(chrono::steady_clock::now())
+{
+}
+
+/**
+ * Destructor. Stops the server thread.
+ */
+ControlServer::~ControlServer()
+{
+    Stop();
+}
+
+/**
+ * Start listening on the loopback interface
+ * @param port Port to listen on, or 0 for any free port
+ * @return False if the port couldn't be opened
+ */
+bool ControlServer::Start(int port)
+{
+    if (IsRunning())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        return false;
+    }
+#endif
+
+    auto listener = socket(AF_INET, SOCK_STREAM, 0);
+    if ((intptr_t)listener == -1)
+    {
+        return false;
+    }
+
+#ifndef _WIN32
+    // Let a restarted program take the port straight back
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    socklen_t length = sizeof(address);
+    if (::bind(listener, (sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 8) != 0 ||
+            getsockname(listener, (sockaddr *)&address, &length) != 0)
+    {
+        CloseSocket((intptr_t)listener);
+        return false;
+    }
+
+    mListener = (intptr_t)listener;
+    mPort = ntohs(address.sin_port);
+    mStopping = false;
+    mThread = thread([this] { Serve(); });
+    return true;
+}
+
+/**
+ * Stop the server and wait for its thread to exit
+ */
+void ControlServer::Stop()
+{
+    if (!IsRunning())
+    {
+        return;
+    }
+
+    mStopping = true;
+    mThread.join();
+    CloseSocket(mListener);
+    mListener = -1;
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+/**
+ * Body of the server thread. Answers one connection at a time
+ * until Stop is called.
+ */
+void ControlServer::Serve()
+{
+    auto listener = (SocketHandle)mListener;
+    while (!mStopping)
+    {
+        // Wait a short while so Stop is noticed
+        fd_set ready;
+        FD_ZERO(&ready);
+        FD_SET(listener, &ready);
+        timeval timeout = {0, AcceptTimeout * 1000};
+        if (select((int)listener + 1, &ready, nullptr, nullptr, &timeout) <= 0)
+        {
+            continue;
+        }
+
+        auto client = accept(listener, nullptr, nullptr);
+        if ((intptr_t)client == -1)
+        {
+            continue;
+        }
+
+        Handle((intptr_t)client);
+        CloseSocket((intptr_t)client);
+    }
+}
+
+/**
+ * Read a request from a client and send the response
+ * @param connection Connected socket
+ */
+void ControlServer::Handle(std::intptr_t connection)
+{
+    auto client = (SocketHandle)connection;
+
+#ifdef _WIN32
+    DWORD timeout = RequestTimeout * 1000;
+#else
+    timeval timeout = {RequestTimeout, 0};
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+
+    // We only need the request line, but read the headers so the
+    // client isn't reset while it is still sending them
+    string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == string::npos && request.size() < MaxRequest)
+    {
+        auto received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+
+        request.append(buffer, received);
+    }
+
+    string body;
+    string type = "application/json";
+    int status;
+    auto end = request.find("\r\n");
+    auto space1 = request.find(' ');
+    auto space2 = space1 == string::npos ? string::npos : request.find(' ', space1 + 1);
+    if (end == string::npos || space2 == string::npos || space2 > end)
+    {
+        status = 400;
+        body = JsonError("bad request");
+    }
+    else
+    {
+        status = Respond(request.substr(0, space1), request.substr(space1 + 1, space2 - space1 - 1), body, type);
+    }
+
+    const char *reason = status == 200 ? "OK" : status == 202 ? "Accepted" : status == 404 ? "Not Found" :
+            status == 405 ? "Method Not Allowed" : "Bad Request";
+    char header[200];
+    snprintf(header, sizeof(header),
+            "HTTP/1.0 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+            status, reason, type.c_str(), body.size());
+
+    auto response = string(header) + body;
+    size_t sent = 0;
+    while (sent < response.size())
+    {
+        auto count = send(client, response.data() + sent, (int)(response.size() - sent), 0);
+        if (count <= 0)
+        {
+            break;
+        }
+
+        sent += count;
+    }
+
+    mRequests++;
+}
+
+/**
+ * Work out the response to a request
+ * @param method HTTP method
+ * @param target Request target, the path and query
+ * @param body Output: body of the response
+ * @param type Output: content type of the body, if it isn't JSON
+ * @return HTTP status code
+ */
+int ControlServer::Respond(const std::string &method, const std::string &target, std::string &body, std::string &type)
+{
+    auto question = target.find('?');
+    auto path = target.substr(0, question);
+
+    map<string, string> query;
+    if (question != string::npos)
+    {
+        auto rest = target.substr(question + 1);
+        size_t start = 0;
+        while (start <= rest.size())
+        {
+            auto amp = rest.find('&', start);
+            auto pair = rest.substr(start, amp == string::npos ? string::npos : amp - start);
+            auto equals = pair.find('=');
+            if (!pair.empty())
+            {
+                query[UrlDecode(pair.substr(0, equals))] =
+                        equals == string::npos ? "" : UrlDecode(pair.substr(equals + 1));
+            }
+
+            if (amp == string::npos)
+            {
+                break;
+            }
+            start = amp + 1;
+        }
+    }
+
+    if (path == "/metrics")
+    {
+        if (method != "GET")
+        {
+            body = JsonError("use GET");
+            return 405;
+        }
+
+        type = "text/plain; version=0.0.4";
+        body = mMetrics->ToPrometheus();
+        return 200;
+    }
+
+    auto status = GetStatus();
+    if (path == "/status")
+    {
+        if (method != "GET")
+        {
+            body = JsonError("use GET");
+            return 405;
+        }
+
+        body = status != nullptr ? ToJson(*status) : ToJson(Status());
+        return 200;
+    }
+
+    // Everything else is /tanks/N or /tanks/N/action
+    const string prefix = "/tanks/";
+    if (path.compare(0, prefix.size(), prefix) != 0)
+    {
+        body = JsonError("no such resource");
+        return 404;
+    }
+
+    auto slash = path.find('/', prefix.size());
+    auto number = path.substr(prefix.size(), slash == string::npos ? string::npos : slash - prefix.size());
+    char *numberEnd = nullptr;
+    long tank = strtol(number.c_str(), &numberEnd, 10);
+    size_t tanks = status != nullptr ? status->mTanks.size() : 0;
+    if (number.empty() || *numberEnd != '\0' || tank < 1 || (size_t)tank > tanks)
+    {
+        body = JsonError("no such tank");
+        return 404;
+    }
+
+    if (slash == string::npos)
+    {
+        if (method != "GET")
+        {
+            body = JsonError("use GET");
+            return 405;
+        }
+
+        body = ToJson(status->mTanks[tank - 1], tank - 1);
+        return 200;
+    }
+
+    // Items are read from the published snapshot, without involving the GUI thread
+    if (path.substr(slash + 1) == "items")
+    {
+        if (method != "GET")
+        {
+            body = JsonError("use GET");
+            return 405;
+        }
+
+        body = ToJson(*status->mTanks[tank - 1].mSnapshot);
+        return 200;
+    }
+
+    if (method != "POST")
+    {
+        body = JsonError("use POST");
+        return 405;
+    }
+
+    return Queue(path.substr(slash + 1), tank - 1, query, body);
+}
+
+/**
+ * Queue a change for the GUI thread to make
+ * @param action What to do, the last part of the path
+ * @param tank Tank index, from 0
+ * @param query Query parameters
+ * @param body Output: JSON body of the response
+ * @return HTTP status code
+ */
+int ControlServer::Queue(const std::string &action, size_t tank, const std::map<std::string, std::string> &query,
+        std::string &body)
+{
+    auto get = [&query](const string &name) {
+        auto found = query.find(name);
+        return found == query.end() ? string() : found->second;
+    };
+
+    Command command;
+    command.mTank = tank;
+    if (action == "spawn" || action == "remove")
+    {
+        command.mType = action == "spawn" ? Command::Type::Spawn : Command::Type::Remove;
+        command.mSpecies = FromUtf8(get("species"));
+        auto count = get("count");
+        command.mCount = count.empty() ? 1 : strtol(count.c_str(), nullptr, 10);
+        if ((command.mType == Command::Type::Spawn && command.mSpecies.empty()) || command.mCount < 1)
+        {
+            body = JsonError("spawn needs a species, and the count must be at least 1");
+            return 400;
+        }
+    }
+    else if (action == "clear")
+    {
+        command.mType = Command::Type::Clear;
+    }
+    else if (action == "load" || action == "save")
+    {
+        command.mType = action == "load" ? Command::Type::Load : Command::Type::Save;
+        command.mFilename = FromUtf8(get("file"));
+        if (command.mFilename.empty())
+        {
+            body = JsonError("a file is needed");
+            return 400;
+        }
+    }
+    else if (action == "pause")
+    {
+        command.mType = Command::Type::Pause;
+        auto on = get("on");
+        command.mValue = on.empty() || on == "1" || on == "true" ? 1 : 0;
+    }
+    else if (action == "speed")
+    {
+        command.mType = Command::Type::Speed;
+        command.mValue = strtod(get("value").c_str(), nullptr);
+        if (command.mValue <= 0)
+        {
+            body = JsonError("the speed must be above 0");
+            return 400;
+        }
+    }
+    else
+    {
+        body = JsonError("no such action");
+        return 404;
+    }
+
+    mCommands.Push(command);
+    if (mOnQueued)
+    {
+        mOnQueued();
+    }
+
+    body = "{\"queued\":true}";
+    return 202;
+}
+
+/**
+ * Record the time of a tick and of each tank's update. Called by
+ * the GUI thread after every tick.
+ * @param host Host that was just ticked
+ */
+void ControlServer::Sample(const TankHost &host)
+{
+    auto now = chrono::steady_clock::now();
+    double frame = chrono::duration<double>(now - mLastSample).count();
+    mLastSample = now;
+
+    size_t slot = mSamples % SampleCount;
+    if (mFrameTimes.size() < SampleCount)
+    {
+        mFrameTimes.push_back(frame);
+    }
+    else
+    {
+        mFrameTimes[slot] = frame;
+    }
+
+    mUpdateTimes.resize(host.GetCount());
+    for (size_t i = 0; i < host.GetCount(); i++)
+    {
+        auto &times = mUpdateTimes[i];
+        if (times.size() < SampleCount)
+        {
+            times.push_back(host.GetLastCpuTime(i));
+        }
+        else
+        {
+            times[slot] = host.GetLastCpuTime(i);
+        }
+    }
+
+    mSamples++;
+}
+
+/**
+ * Publish the status of every tank for the server thread to report.
+ * Called by the GUI thread. This walks every item, so it is called
+ * every so often rather than on every tick.
+ * @param host Host to report on
+ */
+void ControlServer::Publish(TankHost &host)
+{
+    auto status = make_shared<Status>();
+    status->mFrame = Measure(mFrameTimes);
+    for (size_t i = 0; i < host.GetCount(); i++)
+    {
+        auto aquarium = host.GetAquarium(i);
+        auto &clock = host.GetClock(i);
+
+        TankStatus tank;
+        tank.mTime = aquarium->GetTime();
+        tank.mPaused = clock.IsPaused();
+        tank.mSpeed = clock.GetSpeed();
+        tank.mWidth = aquarium->GetWidth();
+        tank.mHeight = aquarium->GetHeight();
+        // Counted from the snapshot, which the server thread can read as
+        // well. Taking it here means tanks nobody asks about aren't copied.
+        tank.mSnapshot = aquarium->Publish();
+
+        tank.mItems = tank.mSnapshot->GetCount();
+        for (auto &chunk : tank.mSnapshot->GetChunks())
+        {
+            for (auto &state : *chunk)
+            {
+                tank.mSpecies[state.mSpecies != nullptr ? state.mSpecies->mName : L""]++;
+            }
+        }
+
+        if (i < mUpdateTimes.size())
+        {
+            tank.mUpdate = Measure(mUpdateTimes[i]);
+        }
+
+        status->mTanks.push_back(move(tank));
+    }
+
+    atomic_store(&mStatus, shared_ptr<const Status>(status));
+}
+
+/**
+ * Get the status last published
+ * @return Status, or nullptr if nothing has been published
+ */
+std::shared_ptr<const ControlServer::Status> ControlServer::GetStatus() const
+{
+    return atomic_load(&mStatus);
+}
+
+/**
+ * Make the changes that have been queued. Called by the GUI
+ * thread at the start of a tick.
+ * @param host Host the changes are made to
+ * @return Number of changes made
+ */
+size_t ControlServer::Apply(TankHost &host)
+{
+    return mCommands.Drain([this, &host](const Command &command) { Execute(host, command); });
+}
+
+/**
+ * Make one change asked for through the API
+ * @param host Host the change is made to
+ * @param command The change
+ */
+void ControlServer::Execute(TankHost &host, const Command &command)
+{
+    if (command.mTank >= host.GetCount())
+    {
+        return;
+    }
+
+    auto aquarium = host.GetAquarium(command.mTank);
+    switch (command.mType)
+    {
+    case Command::Type::Spawn:
+        for (long i = 0; i < command.mCount; i++)
+        {
+            // An unknown species or a tank over its memory budget won't take any more
+            if (aquarium->Spawn(command.mSpecies) == nullptr)
+            {
+                break;
+            }
+        }
+        break;
+
+    case Command::Type::Remove:
+    {
+        // Take the topmost matching items first
+        long removed = 0;
+        auto items = aquarium->GetItems();
+        for (auto item = items.rbegin(); item != items.rend() && removed < command.mCount; ++item)
+        {
+            auto species = (*item)->GetSpecies();
+            if (command.mSpecies.empty() || (species != nullptr && species->mName == command.mSpecies))
+            {
+                aquarium->Remove(*item);
+                removed++;
+            }
+        }
+        break;
+    }
+
+    case Command::Type::Clear:
+        aquarium->Clear();
+        break;
+
+    case Command::Type::Load:
+        if (!aquarium->Load(command.mFilename))
+        {
+            wxLogStatus(L"Unable to load %s", command.mFilename);
+        }
+        else if (aquarium->GetLoadRefused() > 0)
+        {
+            wxLogStatus(L"Tank %d is over its memory budget, so %d items of %s were left out",
+                    (int)command.mTank + 1, (int)aquarium->GetLoadRefused(), command.mFilename);
+        }
+        break;
+
+    case Command::Type::Save:
+    {
+        // Written from a snapshot on the pool, so the tanks go on
+        // updating while a big one is saved
+        auto snapshot = aquarium->Publish();
+        auto saves = mSaves;
+        auto filename = command.mFilename;
+        saves->mPending++;
+        host.GetPool()->Submit([snapshot, saves, filename] {
+            {
+                lock_guard<mutex> lock(saves->mMutex);
+                if (!snapshot->Save(filename))
+                {
+                    wxLogStatus(L"Unable to save %s", filename);
+                }
+            }
+            saves->mPending--;
+        });
+        break;
+    }
+
+    case Command::Type::Pause:
+        host.GetClock(command.mTank).SetPaused(command.mValue != 0);
+        break;
+
+    case Command::Type::Speed:
+        host.GetClock(command.mTank).SetSpeed(command.mValue);
+        break;
+    }
+}
+
+/**
+ * Work out the percentiles of a set of times.
+ *
+ * Uses the nearest rank: the Pth percentile is the smallest time
+ * that at least P percent of the times are no bigger than.
+ *
+ * @param times Times in seconds
+ * @return Percentiles in milliseconds, all 0 if there are no times
+ */
+ControlServer::Percentiles ControlServer::Measure(std::vector<double> times)
+{
+    Percentiles percentiles;
+    if (times.empty())
+    {
+        return percentiles;
+    }
+
+    sort(times.begin(), times.end());
+    // Rank worked out in whole numbers, so 0.95 * 100 can't round up to 96
+    auto at = [&times](size_t percent) {
+        size_t rank = max<size_t>((percent * times.size() + 99) / 100, 1);
+        return times[rank - 1] * 1000;
+    };
+
+    percentiles.mP50 = at(50);
+    percentiles.mP95 = at(95);
+    percentiles.mP99 = at(99);
+    return percentiles;
+}
+
+/**
+ * Write the status of a tank as JSON
+ * @param tank Status of the tank
+ * @param index Tank index, from 0
+ * @return JSON object
+ */
+std::string ControlServer::ToJson(const TankStatus &tank, size_t index)
+{
+    string species;
+    for (auto &count : tank.mSpecies)
+    {
+        species += (species.empty() ? "" : ",") + JsonString(ToUtf8(count.first)) + ":" + to_string(count.second);
+    }
+
+    return "{\"tank\":" + to_string(index + 1) +
+            ",\"time\":" + JsonNumber(tank.mTime) +
+            ",\"paused\":" + (tank.mPaused ? "true" : "false") +
+            ",\"speed\":" + JsonNumber(tank.mSpeed) +
+            ",\"width\":" + to_string(tank.mWidth) +
+            ",\"height\":" + to_string(tank.mHeight) +
+            ",\"items\":" + to_string(tank.mItems) +
+            ",\"species\":{" + species + "}" +
+            ",\"update_ms\":" + JsonPercentiles(tank.mUpdate) + "}";
+}
+
+/**
+ * Write the status of everything as JSON
+ * @param status Status
+ * @return JSON object
+ */
+std::string ControlServer::ToJson(const Status &status)
+{
+    string tanks;
+    for (size_t i = 0; i < status.mTanks.size(); i++)
+    {
+        tanks += (i == 0 ? "" : ",") + ToJson(status.mTanks[i], i);
+    }
+
+    return "{\"frame_ms\":" + JsonPercentiles(status.mFrame) + ",\"tanks\":[" + tanks + "]}";
+}
+
+/**
+ * Write the items in a snapshot as JSON
+ * @param snapshot Snapshot of a tank
+ * @return JSON object
+ */
+std::string ControlServer::ToJson(const AquariumSnapshot &snapshot)
+{
+    string items;
+    for (auto &chunk : snapshot.GetChunks())
+    {
+        for (auto &state : *chunk)
+        {
+            items += (items.empty() ? "{" : ",{");
+            items += "\"type\":" + JsonString(state.mSpecies != nullptr ? ToUtf8(state.mSpecies->mName) : "") +
+                    ",\"x\":" + JsonNumber(state.mX) +
+                    ",\"y\":" + JsonNumber(state.mY) +
+                    ",\"mirror\":" + (state.mMirror ? "true" : "false") + "}";
+        }
+    }
+
+    return "{\"epoch\":" + to_string(snapshot.GetEpoch()) + ",\"items\":[" + items + "]}";
+}
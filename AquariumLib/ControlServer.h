@@ -0,0 +1,264 @@
+/**
+ * @file ControlServer.h
+ * @author Ismail Abdi
+ *
+ * A small HTTP server for querying and controlling the tanks.
+ */
+
+#ifndef AQUARIUM_CONTROLSERVER_H
+#define AQUARIUM_CONTROLSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "CommandQueue.h"
+
+class TankHost;
+class Metrics;
+class AquariumSnapshot;
+
+/**
+ * A small HTTP server for querying and controlling the tanks.
+ *
+ * It listens on the loopback interface only and answers with JSON:
+ *
+ *     GET  /status                    every tank and the frame times
+ *     GET  /metrics                   the Metrics registry, in the Prometheus text format
+ *     GET  /tanks/N                   one tank
+ *     GET  /tanks/N/items             every item in one tank
+ *     POST /tanks/N/spawn?species=S&count=C
+ *     POST /tanks/N/remove?species=S&count=C
+ *     POST /tanks/N/clear
+ *     POST /tanks/N/load?file=F
+ *     POST /tanks/N/save?file=F
+ *     POST /tanks/N/pause?on=1
+ *     POST /tanks/N/speed?value=V
+ *
+ * Tanks are numbered from 1, as they are on the tabs.
+ *
+ * Requests are served on a thread of the server's own, which never
+ * touches an aquarium. The GUI thread publishes a snapshot of the
+ * status every so often, and the server thread picks up the latest
+ * with std::atomic_load. That takes a library lock for as long as
+ * it takes to copy the pointer, never while the status is built or
+ * read, so polling doesn't hold up the animation.
+ * Changes are pushed onto a lock-free queue and made by the GUI
+ * thread at the start of its next tick, so POSTs answer 202 Accepted.
+ * A save takes a snapshot of the tank then, and the file is written
+ * on the thread pool while the tanks go on updating.
+ */
+class ControlServer {
+public:
+    /// Percentiles of a set of times, in milliseconds
+    struct Percentiles {
+        /// Median
+        double mP50 = 0;
+
+        /// 95th percentile
+        double mP95 = 0;
+
+        /// 99th percentile
+        double mP99 = 0;
+    };
+
+    /// What the server reports about one tank
+    struct TankStatus {
+        /// Simulated seconds
+        double mTime = 0;
+
+        /// True if the tank's clock is paused
+        bool mPaused = false;
+
+        /// Simulated seconds per wall-clock second
+        double mSpeed = 1;
+
+        /// Tank width in pixels
+        int mWidth = 0;
+
+        /// Tank height in pixels
+        int mHeight = 0;
+
+        /// Number of items in the tank
+        size_t mItems = 0;
+
+        /// Number of items of each species, by type name
+        std::map<std::wstring, size_t> mSpecies;
+
+        /// CPU time of recent updates of this tank
+        Percentiles mUpdate;
+
+        /// The items, as the aquarium last published them
+        std::shared_ptr<const AquariumSnapshot> mSnapshot;
+    };
+
+    /// Everything the server reports, as published by the GUI thread
+    struct Status {
+        /// Each tank, in order
+        std::vector<TankStatus> mTanks;
+
+        /// Wall-clock time between recent ticks
+        Percentiles mFrame;
+    };
+
+    /// A change asked for through the API
+    struct Command {
+        /// Kinds of change
+        enum class Type {Spawn, Remove, Clear, Load, Save, Pause, Speed};
+
+        /// Kind of change
+        Type mType = Type::Clear;
+
+        /// Tank index, from 0
+        size_t mTank = 0;
+
+        /// Species for Spawn and Remove. Remove with no species removes anything.
+        std::wstring mSpecies;
+
+        /// Number of items for Spawn and Remove
+        long mCount = 1;
+
+        /// File for Load and Save
+        std::wstring mFilename;
+
+        /// On (non-zero) or off for Pause, the speed for Speed
+        double mValue = 0;
+    };
+
+private:
+    /// Saves asked for through the API, which run on the thread pool
+    struct Saves {
+        /// Held while writing, so two saves never write a file at once
+        std::mutex mMutex;
+
+        /// Saves queued or running
+        std::atomic<int> mPending{0};
+    };
+
+    /// Thread that serves the requests
+    std::thread mThread;
+
+    /// Set to ask the server thread to exit
+    std::atomic<bool> mStopping{false};
+
+    /// Listening socket, or -1
+    std::intptr_t mListener = -1;
+
+    /// Port we are listening on
+    int mPort = 0;
+
+    /// The latest status. Only accessed with atomic_load and atomic_store,
+    /// which hold a library lock just long enough to copy the pointer.
+    std::shared_ptr<const Status> mStatus;
+
+    /// Changes waiting for the GUI thread
+    CommandQueue<Command> mCommands;
+
+    /// Number of requests answered
+    std::atomic<long> mRequests{0};
+
+    /// Metrics served at /metrics
+    std::shared_ptr<Metrics> mMetrics;
+
+    /// Called on the server thread whenever a change is queued
+    std::function<void()> mOnQueued;
+
+    /// Saves in progress. Shared with the saves so they can outlive the server.
+    std::shared_ptr<Saves> mSaves = std::make_shared<Saves>();
+
+    /// Recent update times of each tank in seconds, used as rings. GUI thread only.
+    std::vector<std::vector<double>> mUpdateTimes;
+
+    /// Recent times between ticks in seconds, used as a ring. GUI thread only.
+    std::vector<double> mFrameTimes;
+
+    /// Number of samples taken. GUI thread only.
+    size_t mSamples = 0;
+
+    /// When Sample was last called. GUI thread only.
+    std::chrono::steady_clock::time_point mLastSample;
+
+    void Serve();
+
+    void Handle(std::intptr_t connection);
+
+    int Respond(const std::string &method, const std::string &target, std::string &body, std::string &type);
+
+    int Queue(const std::string &action, size_t tank, const std::map<std::string, std::string> &query, std::string &body);
+
+    void Execute(TankHost &host, const Command &command);
+
+public:
+    ControlServer();
+
+    explicit ControlServer(std::shared_ptr<Metrics> metrics);
+
+    virtual ~ControlServer();
+
+    /// Copy constructor (disabled)
+    ControlServer(const ControlServer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ControlServer &) = delete;
+
+    /**
+     * Set a function to call whenever a change is queued, so the
+     * GUI thread can pick it up without waiting for its next tick.
+     * It is called on the server thread. Set it before Start.
+     * @param onQueued Function to call
+     */
+    void SetOnQueued(std::function<void()> onQueued) { mOnQueued = onQueued; }
+
+    bool Start(int port);
+
+    void Stop();
+
+    /**
+     * Is the server listening?
+     * @return True if it has been started
+     */
+    bool IsRunning() const { return mListener != -1; }
+
+    /**
+     * Get the port the server is listening on
+     * @return Port number
+     */
+    int GetPort() const { return mPort; }
+
+    /**
+     * Number of requests answered so far
+     * @return Request count
+     */
+    long GetRequests() const { return mRequests; }
+
+    /**
+     * Are any saves asked for through the API still being written?
+     * @return True if a save is queued or running
+     */
+    bool IsSaving() const { return mSaves->mPending > 0; }
+
+    void Sample(const TankHost &host);
+
+    void Publish(TankHost &host);
+
+    std::shared_ptr<const Status> GetStatus() const;
+
+    size_t Apply(TankHost &host);
+
+    static Percentiles Measure(std::vector<double> times);
+
+    static std::string ToJson(const TankStatus &tank, size_t index);
+
+    static std::string ToJson(const Status &status);
+
+    static std::string ToJson(const AquariumSnapshot &snapshot);
+};
+
+#endif //AQUARIUM_CONTROLSERVER_H
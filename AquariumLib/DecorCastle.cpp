@@ -5,6 +5,8 @@
 
 #include "pch.h"
 #include "DecorCastle.h"
+#include "Aquarium.h"
+#include "SpeciesRegistry.h"
 
 /// DecorCastle image file
 const std::wstring DecorCastleImageName = L"images/castle.png";
@@ -13,19 +15,35 @@ const std::wstring DecorCastleImageName = L"images/castle.png";
  * Constructor
  * @param aquarium The aquarium this item is a part of
  */
-DecorCastle::DecorCastle(Aquarium* aquarium) : Item(aquarium, DecorCastleImageName)
+DecorCastle::DecorCastle(Aquarium* aquarium) : DecorCastle(aquarium, aquarium->GetSpecies()->Find(L"castle"))
 {
- // The base class constructor will load the image and handle all necessary initialization
 }
 
-
-wxXmlNode* DecorCastle::XmlSave(wxXmlNode* node)
+/**
+ * Constructor
+ * @param aquarium The aquarium this item is a part of
+ * @param species The species this item is
+ */
+DecorCastle::DecorCastle(Aquarium* aquarium, std::shared_ptr<const Species> species) : Item(aquarium, species)
 {
- // Call the base class's XmlSave to save x and y
- auto itemNode = Item::XmlSave(node);
+ // The base class constructor will load the image and handle all necessary initialization
+}
 
- // Add the 'type' attribute specific to DecorCastle
- itemNode->AddAttribute(L"type", L"castle");
+/**
+ * Register the decor behaviour and the castle species
+ * @param registry Registry to add to
+ */
+void DecorCastle::Register(SpeciesRegistry &registry)
+{
+ registry.AddBehavior(L"decor", [](Aquarium *aquarium, std::shared_ptr<const Species> species) {
+  return std::make_shared<DecorCastle>(aquarium, species);
+ });
 
- return itemNode;  // Return the updated node
+ Species species;
+ species.mName = L"castle";
+ species.mLabel = L"&Castle Decor";
+ species.mImage = DecorCastleImageName;
+ species.mBehavior = L"decor";
+ species.mDecor = true;
+ registry.Add(species);
 }
\ No newline at end of file
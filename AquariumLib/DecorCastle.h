@@ -10,20 +10,21 @@
 
 #include "Item.h"
 
+class SpeciesRegistry;
 
-
+/**
+ * Decor that sits still, like the castle. Also used for
+ * decor species from the species data file.
+ */
 class DecorCastle: public Item {
 private:
 
 public:
  DecorCastle(Aquarium* aquarium);
 
- /**
-     * Save this decor item to an XML node
-     * @param node The parent node we are going to be a child of
-     * @return wxXmlNode* that represents this decor in XML
-     */
- wxXmlNode* XmlSave(wxXmlNode* node) override;
+ DecorCastle(Aquarium* aquarium, std::shared_ptr<const Species> species);
+
+ static void Register(SpeciesRegistry &registry);
 
 };
 
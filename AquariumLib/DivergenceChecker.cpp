@@ -0,0 +1,89 @@
+/**
+ * @file DivergenceChecker.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "DivergenceChecker.h"
+#include "Aquarium.h"
+#include "Item.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param reference Aquarium taking the reference path
+ * @param candidate Aquarium taking the path being checked
+ */
+DivergenceChecker::DivergenceChecker(Aquarium &reference, Aquarium &candidate) :
+    mReference(reference), mCandidate(candidate)
+{
+}
+
+/**
+ * Compare the aquariums as they are now.
+ *
+ * Only the state hashes are compared unless they differ, so
+ * this is cheap enough to call every tick.
+ *
+ * @return True if the aquariums match
+ */
+bool DivergenceChecker::Check()
+{
+    if (mReference.GetStateHash() == mCandidate.GetStateHash())
+    {
+        return true;
+    }
+
+    if (!HasDiverged())
+    {
+        mTick = mTicks;
+
+        auto &reference = mReference.GetItems();
+        auto &candidate = mCandidate.GetItems();
+        size_t count = min(reference.size(), candidate.size());
+        mItem = (long)count;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (reference[i]->GetStateHash() != candidate[i]->GetStateHash())
+            {
+                mItem = (long)i;
+                break;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Update both aquariums in lock step, checking every tick.
+ *
+ * The starting state is checked first. Stops at the first
+ * tick that doesn't match.
+ *
+ * @param ticks Number of updates to run
+ * @param elapsed Simulated seconds per update
+ * @return True if every tick matched
+ */
+bool DivergenceChecker::Run(long ticks, double elapsed)
+{
+    if (HasDiverged() || (mTicks == 0 && !Check()))
+    {
+        return false;
+    }
+
+    for (long i = 0; i < ticks; i++)
+    {
+        mReference.Update(elapsed);
+        mCandidate.Update(elapsed);
+        mTicks++;
+
+        if (!Check())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
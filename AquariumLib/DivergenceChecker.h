@@ -0,0 +1,83 @@
+/**
+ * @file DivergenceChecker.h
+ * @author Ismail Abdi
+ *
+ * Runs two aquariums side by side and finds where they stop matching.
+ */
+
+#ifndef AQUARIUM_DIVERGENCECHECKER_H
+#define AQUARIUM_DIVERGENCECHECKER_H
+
+class Aquarium;
+
+/**
+ * Runs two aquariums side by side and finds where they stop matching.
+ *
+ * Used to prove an optimised update path behaves exactly like the
+ * reference one. Set both aquariums up with the same seed and items,
+ * configure one to take the optimised path, then Run them. The state
+ * hashes are compared every tick and, on the first mismatch, each
+ * item is hashed to find which one differs.
+ */
+class DivergenceChecker {
+private:
+    /// Aquarium taking the reference path
+    Aquarium &mReference;
+
+    /// Aquarium taking the path being checked
+    Aquarium &mCandidate;
+
+    /// Ticks run so far
+    long mTicks = 0;
+
+    /// First tick that didn't match, or -1
+    long mTick = -1;
+
+    /// Index of the first item that didn't match, or -1
+    long mItem = -1;
+
+public:
+    DivergenceChecker(Aquarium &reference, Aquarium &candidate);
+
+    /// Default constructor (disabled)
+    DivergenceChecker() = delete;
+
+    /// Copy constructor (disabled)
+    DivergenceChecker(const DivergenceChecker &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const DivergenceChecker &) = delete;
+
+    bool Check();
+
+    bool Run(long ticks, double elapsed);
+
+    /**
+     * Has a mismatch been found?
+     * @return True if the aquariums diverged
+     */
+    bool HasDiverged() const { return mTick >= 0; }
+
+    /**
+     * Number of ticks run so far
+     * @return Tick count
+     */
+    long GetTicks() const { return mTicks; }
+
+    /**
+     * First tick whose state didn't match. Tick 0 is the state
+     * before any updates, tick n the state after n updates.
+     * @return Tick, or -1 if everything matched
+     */
+    long GetTick() const { return mTick; }
+
+    /**
+     * First item, in z-order, whose state didn't match. If the
+     * aquariums hold different numbers of items this is the first
+     * index only one of them has.
+     * @return Item index, or -1 if everything matched
+     */
+    long GetItem() const { return mItem; }
+};
+
+#endif //AQUARIUM_DIVERGENCECHECKER_H
@@ -4,71 +4,177 @@
  */
 
 #include "pch.h"
+#include <algorithm>
 #include "Fish.h"
+#include "FishT.h"
 #include "Aquarium.h"
+#include "School.h"
+#include "StateHash.h"
+#include "SpeciesRegistry.h"
 
 
 
-// Maximum speed in the X direction in pixels per second
-const double MaxSpeedX = 50;
+/// Distance in pixels fish keep from the edges of the aquarium
+const double EdgeMargin = 10;
 
-// Minimum speed in the X direction in pixels per second
-const double MinSpeedX = 20;
-
-Fish::Fish(Aquarium *aquarium, const std::wstring &filename) : Item(aquarium, filename)
+/**
+ * Fold a coordinate back into [low, high] as if it had bounced
+ * off the ends of the range, however far past them it went.
+ * @param value Coordinate to fold, updated in place
+ * @param low Lower end of the range
+ * @param high Upper end of the range
+ * @return True if it bounced an odd number of times (direction is reversed)
+ */
+static bool Reflect(double &value, double low, double high)
 {
- std::uniform_real_distribution<> distribution(MinSpeedX, MaxSpeedX);
- mSpeedX = distribution(aquarium->GetRandom());
- mSpeedY = 0;
+ if (value >= low && value <= high)
+ {
+  return false;
+ }
+
+ double range = high - low;
+ if (range <= 0)
+ {
+  // No room to move at all
+  value = (low + high) / 2;
+  return false;
+ }
+
+ double period = 2 * range;
+ double t = fmod(value - low, period);
+ if (t < 0)
+ {
+  t += period;
+ }
+
+ if (t <= range)
+ {
+  value = low + t;
+  return false;
+ }
+
+ value = high - (t - range);
+ return true;
 }
 
 /**
- * Handle updates in time of our fish
+ * Constructor
  *
- * This is called before we draw and allows us to
- * move our fish. We add our speed times the amount
- * of time that has elapsed.
- * @param elapsed Time elapsed since the class call
+ * Starts the fish at a random speed in the range its species swims.
+ * @param aquarium The aquarium we are in
+ * @param species The species this fish is
+ */
+Fish::Fish(Aquarium *aquarium, std::shared_ptr<const Species> species) : Item(aquarium, species)
+{
+ Fish::OnSpeciesChanged();
+
+ std::uniform_real_distribution<> distributionX(species->mMinSpeedX, species->mMaxSpeedX);
+ std::uniform_real_distribution<> distributionY(species->mMinSpeedY, species->mMaxSpeedY);
+ mSpeedX = distributionX(aquarium->GetRandom());
+ mSpeedY = distributionY(aquarium->GetRandom());
+}
+
+/**
+ * Pick up new speed limits after the species has been tuned
+ */
+void Fish::OnSpeciesChanged()
+{
+ mSpeedLimitX = GetSpecies()->mSpeedLimitX;
+ mSpeedLimitY = GetSpecies()->mSpeedLimitY;
+}
+
+/**
+ * Register the plain fish behaviour, used by species from the data file
+ * @param registry Registry to add to
+ */
+void Fish::Register(SpeciesRegistry &registry)
+{
+ registry.AddBehavior(L"fish", FishT<SwimMotion>::Create);
+}
+
+/**
+ * Find one of the built in species
+ * @param aquarium Aquarium whose species to look in
+ * @param name Species name
+ * @return The species
+ */
+std::shared_ptr<const Species> Fish::FindSpecies(Aquarium *aquarium, const std::wstring &name)
+{
+ return aquarium->GetSpecies()->Find(name);
+}
+
+/**
+ * Get the random number generator of our aquarium
+ * @return Random number generator
+ */
+std::mt19937 &Fish::GetRandom()
+{
+ return GetAquarium()->GetRandom();
+}
+
+/**
+ * Start swimming up or down at a random speed, for
+ * a fish that isn't moving vertically
  */
-void Fish::Update(double elapsed)
+void Fish::PickSpeedY()
 {
- // Move the fish based on elapsed time and speed
- SetLocation(GetX() + mSpeedX * elapsed,
-             GetY() + mSpeedY * elapsed);
+ std::uniform_real_distribution<> distributionY(-30, 30); // Vertical speed between -30 and 30
+ mSpeedY = distributionY(GetAquarium()->GetRandom());
+}
 
+/**
+ * Move the fish, bouncing off the edges of the aquarium.
+ *
+ * The whole path is swept, so however large the step the fish
+ * ends up inside the aquarium at the position it would have
+ * reached by bouncing, with its speed reversed for each bounce.
+ * The image is only mirrored when the direction actually changes.
+ *
+ * @param dx Distance to move in the X direction in pixels
+ * @param dy Distance to move in the Y direction in pixels
+ */
+void Fish::Move(double dx, double dy)
+{
  // Get the aquarium width and height, and fish dimensions
- double fishWidth = mItemBitmap->GetWidth();
- double fishHeight = mItemBitmap->GetHeight();
+ double fishWidth = GetWidth();
+ double fishHeight = GetHeight();
  double aquariumWidth = GetAquarium()->GetWidth();
  double aquariumHeight = GetAquarium()->GetHeight();
 
- // Reverse direction when the fish reaches within 10 pixels of the right edge
- if (mSpeedX > 0 && GetX() >= aquariumWidth - 10 - fishWidth / 2)
+ double left = EdgeMargin + fishWidth / 2;
+ double right = aquariumWidth - EdgeMargin - fishWidth / 2;
+ double top = EdgeMargin + fishHeight / 2;
+ double bottom = aquariumHeight - EdgeMargin - fishHeight / 2;
+
+ // A fish dropped outside the bounds starts from the nearest edge
+ double x = GetX();
+ double y = GetY();
+ if (right >= left)
  {
-  mSpeedX = -mSpeedX;
-  SetMirror(true); // Mirror when the fish turns left
+  x = std::clamp(x, left, right);
  }
- // Reverse direction when the fish reaches within 10 pixels of the left edge
- else if (mSpeedX < 0 && GetX() <= 10 + fishWidth / 2)
+ if (bottom >= top)
  {
-  mSpeedX = -mSpeedX;
-  SetMirror(false); // Unmirror when the fish turns right
+  y = std::clamp(y, top, bottom);
  }
 
- // Adjust vertical movement with random Y speed
- if (mSpeedY == 0)
+ x += dx;
+ y += dy;
+
+ if (Reflect(x, left, right))
  {
-  // Set an initial random Y speed
-  std::uniform_real_distribution<> distributionY(-30, 30); // Vertical speed between -30 and 30
-  mSpeedY = distributionY(GetAquarium()->GetRandom());
+  mSpeedX = -mSpeedX;
  }
 
- // Ensure the fish stays within the top and bottom boundaries
- if (GetY() <= 10 + fishHeight / 2 || GetY() >= aquariumHeight - 10 - fishHeight / 2)
+ if (Reflect(y, top, bottom))
  {
-  // Reverse vertical direction if we hit the top or bottom of the aquarium
   mSpeedY = -mSpeedY;
  }
+
+ SetLocation(x, y);
+
+ // Face whichever way we are actually swimming
+ SetMirror(mSpeedX < 0);
 }
 
 void Fish::SetSpeed(double speedX, double speedY)
@@ -77,4 +183,24 @@ void Fish::SetSpeed(double speedX, double speedY)
  mSpeedY = speedY;
 }
 
+/**
+ * Get the schooling parameters for this kind of fish
+ * @return Parameters shared by all fish of this species
+ */
+const SchoolParameters& Fish::GetSchoolParameters() const
+{
+ return GetSpecies()->mSchool;
+}
+
+/**
+ * Add the fish's position and speed to a state hash
+ * @param hash Hash to add to
+ */
+void Fish::HashState(StateHash &hash) const
+{
+ Item::HashState(hash);
+ hash.Add(mSpeedX);
+ hash.Add(mSpeedY);
+}
+
 
@@ -8,8 +8,15 @@
 #ifndef FISH_H
 #define FISH_H
 
+#include <algorithm>
+#include <random>
 #include "Item.h"
 
+struct SchoolParameters;
+class StateHash;
+struct Species;
+class SpeciesRegistry;
+
 
 /**
  * Base class for a fish
@@ -27,26 +34,110 @@ public:
  /// Assignment operator
  void operator=(const Fish&) = delete;
 
- /// Handle updates in time of our fish
- void Update(double elapsed);
+ Fish(Aquarium* aquarium, std::shared_ptr<const Species> species);
+
+ static void Register(SpeciesRegistry &registry);
+
+ /**
+  * Handle updates in time of our fish
+  * @param elapsed Time elapsed since the last update
+  */
+ void Update(double elapsed) override { Swim(elapsed); }
 
  ///  Set the speed of the fish in both X and Y directions
  void SetSpeed(double speedX, double speedY);
 
+ /**
+  * Get the speed in the X direction
+  * @return X speed in pixels per second
+  */
+ double GetSpeedX() const { return mSpeedX; }
 
-protected:
  /**
-  * Constructor
-  * @param aquarium The aquarium we are in
-  * @param filename Filename for the image we use
+  * Get the speed in the Y direction
+  * @return Y speed in pixels per second
   */
- Fish(Aquarium* aquarium, const std::wstring& filename);
+ double GetSpeedY() const { return mSpeedY; }
 
+ /**
+  * Get the largest X speed this fish may swim
+  * @return X speed limit in pixels per second
+  */
+ double GetSpeedLimitX() const { return mSpeedLimitX; }
+
+ /**
+  * Get the largest Y speed this fish may swim
+  * @return Y speed limit in pixels per second
+  */
+ double GetSpeedLimitY() const { return mSpeedLimitY; }
+
+ virtual const SchoolParameters& GetSchoolParameters() const;
+
+ void HashState(StateHash &hash) const override;
+
+ void OnSpeciesChanged() override;
+
+ /**
+  * Fish are always swimming
+  * @return True
+  */
+ bool IsAnimated() const override { return true; }
+
+ /**
+  * Memory used by this fish object
+  * @return Size in bytes
+  */
+ size_t GetByteSize() const override { return sizeof(Fish); }
+
+
+protected:
  /// Fish speed in the X direction in pixels per second
  double mSpeedX = 0;
 
  /// Fish speed in the Y direction in pixels per second
  double mSpeedY = 0;
+
+ /// Largest X speed this fish may swim in pixels per second
+ double mSpeedLimitX;
+
+ /// Largest Y speed this fish may swim in pixels per second
+ double mSpeedLimitY;
+
+ void Move(double dx, double dy);
+
+ void PickSpeedY();
+
+ std::mt19937 &GetRandom();
+
+ static std::shared_ptr<const Species> FindSpecies(Aquarium *aquarium, const std::wstring &name);
+
+ /**
+  * Swim for a while at our speed
+  *
+  * This is what a plain fish does every update. We add our
+  * speed times the amount of time that has elapsed, keeping
+  * within the speed limits of our species.
+  * @param elapsed Time elapsed since the last update
+  */
+ void Swim(double elapsed)
+ {
+  if (!(elapsed > 0))
+  {
+   return;
+  }
+
+  if (mSpeedY == 0)
+  {
+   PickSpeedY();
+  }
+
+  // Keep the speed within what this species can swim
+  mSpeedX = std::clamp(mSpeedX, -mSpeedLimitX, mSpeedLimitX);
+  mSpeedY = std::clamp(mSpeedY, -mSpeedLimitY, mSpeedLimitY);
+
+  // Move the fish based on elapsed time and speed
+  Move(mSpeedX * elapsed, mSpeedY * elapsed);
+ }
 };
 
 
@@ -5,7 +5,6 @@
 
 #include "pch.h"
 #include "FishBeta.h"
-#include "Aquarium.h"
 
 
 using namespace std;
@@ -13,43 +12,32 @@ using namespace std;
 /// Fish filename
 const wstring FishBetaImageName = L"images/beta.png";
 
-/**
- * Constructor
- * @param aquarium Aquarium this fish is a member of
- */
-FishBeta::FishBeta(Aquarium* aquarium) : Fish(aquarium, FishBetaImageName)
-{
- // FishBeta has a medium speed range
- std::uniform_real_distribution<> distributionX(20, 50);  // Medium speed range
- std::uniform_real_distribution<> distributionY(-20, 20);  // Small vertical range
- SetSpeed(distributionX(aquarium->GetRandom()), distributionY(aquarium->GetRandom()));
-}
+/// Fastest a Beta can swim horizontally in pixels per second
+const double FishBetaSpeedLimitX = 120;
 
+/// Fastest a Beta can swim vertically in pixels per second
+const double FishBetaSpeedLimitY = 30;
+
+/// How quickly a Beta speeds up in pixels per second squared
+const double FishBetaAcceleration = 8.0;
+
+/// Schooling parameters. Betas keep a tight, slow school
+const SchoolParameters FishBetaSchoolParameters = {120, 50, 120, 1.2, 0.6};
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return The XML node representing the fish
+ * Fill in the built in Beta species
+ * @param species Species to fill in
  */
-wxXmlNode* FishBeta::XmlSave(wxXmlNode* node)
+void BetaMotion::Define(Species &species)
 {
- // Call the base class's XmlSave to save x and y
- auto itemNode = Item::XmlSave(node);
-
- // Add the 'type' attribute specific to FishBeta
- itemNode->AddAttribute(L"type", L"beta");
-
- return itemNode;  // Return the updated node
+ species.mLabel = L"&Beta Fish";
+ species.mImage = FishBetaImageName;
+ species.mMinSpeedX = 20;     // Medium speed range
+ species.mMaxSpeedX = 50;
+ species.mMinSpeedY = -20;    // Small vertical range
+ species.mMaxSpeedY = 20;
+ species.mSpeedLimitX = FishBetaSpeedLimitX;
+ species.mSpeedLimitY = FishBetaSpeedLimitY;
+ species.mAcceleration = FishBetaAcceleration;
+ species.mSchool = FishBetaSchoolParameters;
 }
-
-
-
-void FishBeta::Update(double elapsed)
-{
- // Increase speed gradually
- double acceleration = 8.0;
- mSpeedX += acceleration * elapsed;
-
- // Call base class Update to handle movement
- Fish::Update(elapsed);
-}
\ No newline at end of file
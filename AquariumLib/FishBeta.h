@@ -8,33 +8,46 @@
 #ifndef FISHBETA_H
 #define FISHBETA_H
 
-#include "Fish.h"
+#include <algorithm>
+#include <cmath>
+#include "FishT.h"
 
 /**
- * Class for a fish of type Beta
+ * Motion policy for a Beta, which speeds up gradually in
+ * whichever direction it is swimming until it reaches its
+ * speed limit.
  */
-class FishBeta : public Fish {
-private:
-
-public:
-	/// Default constructor (disabled)
-	FishBeta() = delete;
-
-	/// Copy constructor (disabled)
-	FishBeta(const FishBeta &) = delete;
-
-	/// Assignment operator
-	void operator=(const FishBeta &) = delete;
-
-	FishBeta(Aquarium* aquarium);
-
-	/// Save this fish to an XML node.
-	wxXmlNode* XmlSave(wxXmlNode* node) override;
-
-	void Update(double elapsed);
-
+struct BetaMotion : public SwimMotion {
+	/// Behaviour and built in species name
+	static constexpr const wchar_t *Behavior = L"beta";
+
+	/// How quickly this fish speeds up in pixels per second squared
+	double mAcceleration = 0;
+
+	/**
+	 * Pick up the new acceleration after the species has been tuned
+	 * @param species The species
+	 */
+	void Tune(const Species &species) { mAcceleration = species.mAcceleration; }
+
+	/**
+	 * Increase speed gradually, capped so it can't grow forever
+	 * @param speedX X speed in pixels per second, updated in place
+	 * @param elapsed Time elapsed since the last update
+	 * @param limitX Largest X speed
+	 */
+	void Accelerate(double &speedX, double elapsed, double limitX) const
+	{
+		double speed = std::min(fabs(speedX) + mAcceleration * elapsed, limitX);
+		speedX = speedX < 0 ? -speed : speed;
+	}
+
+	static void Define(Species &species);
 };
 
+/// Class for a fish of type Beta
+using FishBeta = FishT<BetaMotion>;
+
 
 
 
@@ -6,46 +6,34 @@
 
 #include "pch.h"
 #include "FishGoldeen.h"
-#include "Aquarium.h"
 
 using namespace std;
 
 /// Fish filename
 const wstring FishGoldeenImageName = L"images/goldeen.png";
 
-/**
- * Constructor
- * @param aquarium Aquarium this fish is a member of
- */
-FishGoldeen::FishGoldeen(Aquarium *aquarium) : Fish(aquarium, FishGoldeenImageName)
-{
- // Increase the speed to make it super fast
- std::uniform_real_distribution<> distributionX(100, 200); // Higher speed range
- mSpeedX = distributionX(GetAquarium()->GetRandom());
-
- // Keep some variation for Y speed
- std::uniform_real_distribution<> distributionY(-50, 50);
- mSpeedY = distributionY(GetAquarium()->GetRandom());
-
-
-}
+/// Fastest a Goldeen can swim horizontally in pixels per second
+const double FishGoldeenSpeedLimitX = 200;
 
+/// Fastest a Goldeen can swim vertically in pixels per second
+const double FishGoldeenSpeedLimitY = 50;
 
+/// Schooling parameters. Goldeens are fast and spread out, so they look further and cohere less
+const SchoolParameters FishGoldeenSchoolParameters = {200, 80, 150, 0.8, 0.2};
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that represents this fish in XML
+ * Fill in the built in Goldeen species
+ * @param species Species to fill in
  */
-wxXmlNode* FishGoldeen::XmlSave(wxXmlNode* node)
+void GoldeenMotion::Define(Species &species)
 {
- // Call the base class's XmlSave to save x and y
- auto itemNode = Item::XmlSave(node);
-
- // Add the 'type' attribute specific to FishGoldeen
- itemNode->AddAttribute(L"type", L"goldeen");
-
- return itemNode;  // Return the updated node
+ species.mLabel = L"&Goldeen Fish";
+ species.mImage = FishGoldeenImageName;
+ species.mMinSpeedX = 100;    // Higher speed range, to make it super fast
+ species.mMaxSpeedX = 200;
+ species.mMinSpeedY = -50;    // Keep some variation for Y speed
+ species.mMaxSpeedY = 50;
+ species.mSpeedLimitX = FishGoldeenSpeedLimitX;
+ species.mSpeedLimitY = FishGoldeenSpeedLimitY;
+ species.mSchool = FishGoldeenSchoolParameters;
 }
-
-
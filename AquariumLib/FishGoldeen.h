@@ -9,28 +9,22 @@
 #define FISHGOLDEEN_H
 
 
-#include "Fish.h"
+#include "FishT.h"
 
 
 /**
- * A class that represents a Goldeen fish in the aquarium.
+ * Motion policy for a Goldeen, which swims like a plain fish, only faster
  */
-class FishGoldeen : public Fish {
-private:
-
-
-public:
- /// Constructor
- FishGoldeen(Aquarium* aquarium);
-
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-
-
-
-
+struct GoldeenMotion : public SwimMotion {
+ /// Behaviour and built in species name
+ static constexpr const wchar_t *Behavior = L"goldeen";
 
+ static void Define(Species &species);
 };
 
+/// A class that represents a Goldeen fish in the aquarium.
+using FishGoldeen = FishT<GoldeenMotion>;
+
 
 
 #endif //FISHGOLDEEN_H
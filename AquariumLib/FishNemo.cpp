@@ -5,61 +5,42 @@
  
 #include "pch.h"
 #include "FishNemo.h"
-#include "Aquarium.h"
 
 using namespace std;
 
 /// Fish filename
 const wstring FishNemoImageName = L"images/nemo.png";
 
-/**
- * Constructor
- * @param aquarium Aquarium this fish is a member of
- */
-FishNemo::FishNemo(Aquarium *aquarium) : Fish(aquarium, FishNemoImageName)
-{
-  // Set Nemo's speed to be faster than other fish
-    std::uniform_real_distribution<> distributionX(60, 100);  // Faster range for horizontal speed
-    std::uniform_real_distribution<> distributionY(-20, 20);  // Vertical speed range
+/// Fastest a Nemo can swim horizontally in pixels per second
+const double FishNemoSpeedLimitX = 100;
 
-    // Set the speed using the random distribution
-    SetSpeed(distributionX(aquarium->GetRandom()), distributionY(aquarium->GetRandom()));
+/// Fastest a Nemo can swim vertically in pixels per second
+const double FishNemoSpeedLimitY = 30;
 
-}
+/// Height of the Nemo swimming wave in pixels
+const double FishNemoWaveAmplitude = 50;
+
+/// Nemo swimming waves per 100 pixels across
+const double FishNemoWaveFrequency = 2;
 
+/// Schooling parameters. Nemos school loosely
+const SchoolParameters FishNemoSchoolParameters = {150, 60, 120, 1.0, 0.4};
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that represents this fish in XML
+ * Fill in the built in Nemo species
+ * @param species Species to fill in
  */
-wxXmlNode* FishNemo::XmlSave(wxXmlNode* node)
-{
- // Call the base class's XmlSave to save x and y
- auto itemNode = Item::XmlSave(node);
-
- // Add the 'type' attribute specific to FishNemo
- itemNode->AddAttribute(L"type", L"nemo");
-
- return itemNode;  // Return the updated node
-}
-
-
-void FishNemo::Update(double elapsed)
+void NemoMotion::Define(Species &species)
 {
- // First, call the base class Update to maintain the original logic
- Fish::Update(elapsed);
-
- // Add unique zig-zag or wave-like movement for Nemo on the Y-axis
- double waveAmplitude = 50;   // Amplitude of the wave in pixels
- double waveFrequency = 2;    // Frequency of the wave
- double offsetY = waveAmplitude * sin(waveFrequency * GetX() * 0.01);
-
- // Apply the wave offset to the Y-position
- SetLocation(GetX(), GetY() + offsetY * elapsed);
+ species.mLabel = L"&Nemo Fish";
+ species.mImage = FishNemoImageName;
+ species.mMinSpeedX = 60;     // Faster range for horizontal speed
+ species.mMaxSpeedX = 100;
+ species.mMinSpeedY = -20;
+ species.mMaxSpeedY = 20;
+ species.mSpeedLimitX = FishNemoSpeedLimitX;
+ species.mSpeedLimitY = FishNemoSpeedLimitY;
+ species.mWaveAmplitude = FishNemoWaveAmplitude;
+ species.mWaveFrequency = FishNemoWaveFrequency;
+ species.mSchool = FishNemoSchoolParameters;
 }
-
-
-
-
-
@@ -8,26 +8,83 @@
 #ifndef FISHNEMO_H
 #define FISHNEMO_H
 
-#include "Fish.h"
+#include "FishT.h"
+#include "FastMath.h"
 
 
+/**
+ * Motion policy for a Nemo, which swims in a wave.
+ *
+ * Each fish keeps its own place in the wave, which moves on with
+ * the distance it swims across the tank. The wave doesn't depend
+ * on where the fish is, so a fish that is dragged or bounces off
+ * a wall carries on smoothly.
+ */
+struct NemoMotion : public SwimMotion {
+ /// Behaviour and built in species name
+ static constexpr const wchar_t *Behavior = L"nemo";
 
+ /// Nemos move up and down after swimming
+ static constexpr bool Drifts = true;
 
-class FishNemo : public Fish {
-private:
+ /// Height of the swimming wave in pixels
+ double mWaveAmplitude = 0;
 
+ /// Swimming waves per 100 pixels across
+ double mWaveFrequency = 0;
 
-public:
- /// Constructor
- FishNemo(Aquarium* aquarium);
+ /// Where the fish is in its wave, in radians
+ double mPhase = 0;
 
- wxXmlNode* XmlSave(wxXmlNode* node) override;
+ /**
+  * Start each fish at a different place in the wave
+  * @param random Random number generator
+  */
+ void Start(std::mt19937 &random)
+ {
+  std::uniform_real_distribution<> distribution(0, TwoPi);
+  mPhase = distribution(random);
+ }
 
- void Update(double elapsed);
+ /**
+  * Pick up the new wave after the species has been tuned
+  * @param species The species
+  */
+ void Tune(const Species &species)
+ {
+  mWaveAmplitude = species.mWaveAmplitude;
+  mWaveFrequency = species.mWaveFrequency;
+ }
 
+ /**
+  * Zig-zag up and down in a wave across the tank
+  * @param speedX X speed in pixels per second
+  * @param elapsed Time elapsed since the last update
+  * @return Y speed in pixels per second
+  */
+ double Drift(double speedX, double elapsed)
+ {
+  mPhase += mWaveFrequency * 0.01 * fabs(speedX) * elapsed;
+  if (mPhase >= TwoPi)
+  {
+   mPhase -= TwoPi;
+  }
 
+  return mWaveAmplitude * FastSin(mPhase);
+ }
+
+ /**
+  * Add the place in the wave to a state hash
+  * @param hash Hash to add to
+  */
+ void HashState(StateHash &hash) const { hash.Add(mPhase); }
+
+ static void Define(Species &species);
 };
 
+/// Class for a fish of type Nemo
+using FishNemo = FishT<NemoMotion>;
+
 
 
 #endif //FISHNEMO_H
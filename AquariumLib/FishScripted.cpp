@@ -0,0 +1,59 @@
+/**
+ * @file FishScripted.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include "FishScripted.h"
+#include "SpeciesRegistry.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param aquarium Aquarium this fish is a member of
+ * @param species The species this fish is
+ */
+FishScripted::FishScripted(Aquarium *aquarium, std::shared_ptr<const Species> species) : Fish(aquarium, species)
+{
+}
+
+/**
+ * Register the scripted behaviour, used by species from the data file
+ * @param registry Registry to add to
+ */
+void FishScripted::Register(SpeciesRegistry &registry)
+{
+ registry.AddBehavior(L"script", [](Aquarium *aquarium, std::shared_ptr<const Species> species) {
+  return std::make_shared<FishScripted>(aquarium, species);
+ });
+}
+
+/**
+ * Set the speed the script chose and move the fish
+ *
+ * The speed is limited to what the species can swim, the same
+ * as for any other fish, and the fish still bounces off the edges.
+ * A script that divides by zero or takes the root of a negative
+ * number gives NaN or infinity; the fish keeps its speed and
+ * doesn't move the extra distance rather than lose its position.
+ *
+ * @param speedX New X speed in pixels per second
+ * @param speedY New Y speed in pixels per second
+ * @param dx Extra X distance to move in pixels
+ * @param dy Extra Y distance to move in pixels
+ * @param elapsed Time elapsed since the last update
+ */
+void FishScripted::Steer(double speedX, double speedY, double dx, double dy, double elapsed)
+{
+ speedX = isfinite(speedX) ? speedX : mSpeedX;
+ speedY = isfinite(speedY) ? speedY : mSpeedY;
+ dx = isfinite(dx) ? dx : 0;
+ dy = isfinite(dy) ? dy : 0;
+
+ mSpeedX = clamp(speedX, -mSpeedLimitX, mSpeedLimitX);
+ mSpeedY = clamp(speedY, -mSpeedLimitY, mSpeedLimitY);
+ Move(mSpeedX * elapsed + dx, mSpeedY * elapsed + dy);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file FishScripted.h
+ * @author Ismail Abdi
+ *
+ *
+ */
+ 
+#ifndef FISHSCRIPTED_H
+#define FISHSCRIPTED_H
+
+#include "Fish.h"
+#include "ItemGroup.h"
+
+/**
+ * A fish whose behaviour is a script in the species file.
+ *
+ * Scripted fish don't move themselves in Update. The aquarium
+ * runs each species' script over all of its fish at once (see
+ * ScriptRunner) and hands each fish the result through Steer.
+ */
+class FishScripted : public Fish {
+public:
+ /// Default constructor (disabled)
+ FishScripted() = delete;
+
+ /// Copy constructor (disabled)
+ FishScripted(const FishScripted &) = delete;
+
+ /// Assignment operator
+ void operator=(const FishScripted &) = delete;
+
+ FishScripted(Aquarium* aquarium, std::shared_ptr<const Species> species);
+
+ static void Register(SpeciesRegistry &registry);
+
+ /**
+  * Scripted fish are moved by ScriptRunner instead
+  * @param elapsed Time elapsed since the last update
+  */
+ void Update(double elapsed) override {}
+
+ /**
+  * Make a group for scripted fish, which does nothing when it
+  * updates, so the fish cost no virtual call each
+  * @return New empty group
+  */
+ std::unique_ptr<ItemGroup> NewGroup() const override { return std::make_unique<ItemGroupIdle>(); }
+
+ void Steer(double speedX, double speedY, double dx, double dy, double elapsed);
+};
+
+
+
+
+#endif //FISHSCRIPTED_H
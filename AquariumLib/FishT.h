@@ -0,0 +1,245 @@
+/**
+ * @file FishT.h
+ * @author Ismail Abdi
+ *
+ * A fish put together at compile time from a motion and a sprite policy.
+ */
+ 
+#ifndef FISHT_H
+#define FISHT_H
+
+#include "Fish.h"
+#include "ItemGroup.h"
+#include "SpeciesRegistry.h"
+#include "StateHash.h"
+
+/**
+ * Sprite policy for species with a single image
+ */
+struct StaticSprite {
+ /**
+  * Get the sprite to draw an item with
+  * @param item Item to draw
+  * @return The item's image
+  */
+ static Sprite *Frame(const Item &item) { return item.GetSprite().get(); }
+};
+
+/**
+ * Sprite policy for species with animation frames
+ */
+struct AnimatedSprite {
+ /**
+  * Get the sprite to draw an item with
+  * @param item Item to draw
+  * @return The item's current animation frame
+  */
+ static Sprite *Frame(const Item &item) { return item.GetFrame(); }
+};
+
+/**
+ * Motion policy for a plain fish, which swims straight at its
+ * speed and bounces off the edges.
+ *
+ * A motion policy keeps whatever a fish needs on top of its
+ * speed, and has:
+ *
+ * - Start(random), to set up a new fish
+ * - Tune(species), to pick up tuned species parameters
+ * - Accelerate(speedX, elapsed, limitX), to change the X speed before the fish swims
+ * - Drifts, true if the fish moves again after swimming, by
+ * - Drift(speedX, elapsed), the Y speed to move at
+ * - HashState(hash), to add anything it keeps to a state hash
+ *
+ * Policies for built in behaviours also have Behavior, the
+ * behaviour name, and Define(species), which fills in the built
+ * in species of the same name.
+ */
+struct SwimMotion {
+ /// Plain fish don't move after swimming
+ static constexpr bool Drifts = false;
+
+ /**
+  * Set up a new fish
+  * @param random Random number generator
+  */
+ void Start(std::mt19937 &random) {}
+
+ /**
+  * Pick up tuned species parameters
+  * @param species The species
+  */
+ void Tune(const Species &species) {}
+
+ /**
+  * Change the X speed before the fish swims
+  * @param speedX X speed in pixels per second, updated in place
+  * @param elapsed Time elapsed since the last update
+  * @param limitX Largest X speed
+  */
+ void Accelerate(double &speedX, double elapsed, double limitX) const {}
+
+ /**
+  * Y speed to move at after swimming
+  * @param speedX X speed in pixels per second
+  * @param elapsed Time elapsed since the last update
+  * @return Y speed in pixels per second
+  */
+ double Drift(double speedX, double elapsed) { return 0; }
+
+ /**
+  * Add anything the policy keeps to a state hash
+  * @param hash Hash to add to
+  */
+ void HashState(StateHash &hash) const {}
+};
+
+/**
+ * A fish put together at compile time from a motion and a sprite policy.
+ *
+ * Everything that makes one behaviour differ from another is in
+ * the policies, so Step has no virtual calls in it. The aquarium
+ * keeps the fish of each instantiation in an ItemGroup and steps
+ * them all in one loop, where the policy code inlines.
+ *
+ * The built in behaviours are instantiations of this (FishBeta,
+ * FishNemo and FishGoldeen). A species with animation frames gets
+ * an AnimatedSprite instantiation of its behaviour's motion.
+ *
+ * @tparam Motion Motion policy, like SwimMotion
+ * @tparam SpritePolicy Sprite policy, StaticSprite or AnimatedSprite
+ */
+template <class Motion, class SpritePolicy = StaticSprite>
+class FishT final : public Fish {
+private:
+ /// Motion state
+ Motion mMotion;
+
+public:
+ /// Default constructor (disabled)
+ FishT() = delete;
+
+ /// Copy constructor (disabled)
+ FishT(const FishT &) = delete;
+
+ /// Assignment operator
+ void operator=(const FishT &) = delete;
+
+ /**
+  * Constructor for a fish of the built in species
+  * @param aquarium Aquarium this fish is a member of
+  */
+ FishT(Aquarium *aquarium) : FishT(aquarium, FindSpecies(aquarium, Motion::Behavior))
+ {
+ }
+
+ /**
+  * Constructor
+  * @param aquarium Aquarium this fish is a member of
+  * @param species The species this fish is
+  */
+ FishT(Aquarium *aquarium, std::shared_ptr<const Species> species) : Fish(aquarium, species)
+ {
+  mMotion.Start(GetRandom());
+  mMotion.Tune(*species);
+ }
+
+ /**
+  * Create a fish of a species with this motion, picking the sprite policy
+  * @param aquarium Aquarium the fish will be in
+  * @param species The species
+  * @return New fish
+  */
+ static std::shared_ptr<Item> Create(Aquarium *aquarium, std::shared_ptr<const Species> species)
+ {
+  if (species->mClip != nullptr)
+  {
+   return std::make_shared<FishT<Motion, AnimatedSprite>>(aquarium, species);
+  }
+
+  return std::make_shared<FishT<Motion, StaticSprite>>(aquarium, species);
+ }
+
+ /**
+  * Register the behaviour and its built in species
+  * @param registry Registry to add to
+  */
+ static void Register(SpeciesRegistry &registry)
+ {
+  registry.AddBehavior(Motion::Behavior, Create);
+
+  Species species;
+  species.mName = Motion::Behavior;
+  species.mBehavior = Motion::Behavior;
+  Motion::Define(species);
+  registry.Add(species);
+ }
+
+ /**
+  * Handle updates in time of our fish, without any virtual calls
+  * @param elapsed Time elapsed since the last update
+  */
+ void Step(double elapsed)
+ {
+  mMotion.Accelerate(mSpeedX, elapsed, mSpeedLimitX);
+  Swim(elapsed);
+  if constexpr (Motion::Drifts)
+  {
+   Move(0, mMotion.Drift(mSpeedX, elapsed) * elapsed);
+  }
+ }
+
+ /**
+  * Handle updates in time of our fish
+  * @param elapsed Time elapsed since the last update
+  */
+ void Update(double elapsed) override { Step(elapsed); }
+
+ /**
+  * Draw this fish
+  * @param dc Device context to draw on
+  */
+ void Draw(wxDC *dc) override { DrawFrame(dc, SpritePolicy::Frame(*this)); }
+
+ /**
+  * Pick up tuned species parameters
+  */
+ void OnSpeciesChanged() override
+ {
+  Fish::OnSpeciesChanged();
+  mMotion.Tune(*GetSpecies());
+ }
+
+ /**
+  * Add the fish's position, speed and motion state to a state hash
+  * @param hash Hash to add to
+  */
+ void HashState(StateHash &hash) const override
+ {
+  Fish::HashState(hash);
+  mMotion.HashState(hash);
+ }
+
+ /**
+  * Make the group the aquarium steps these fish in
+  * @return New empty group
+  */
+ std::unique_ptr<ItemGroup> NewGroup() const override { return std::make_unique<ItemGroupT<FishT>>(); }
+
+ /**
+  * Memory used by this fish object, motion state included
+  * @return Size in bytes
+  */
+ size_t GetByteSize() const override { return sizeof(FishT); }
+
+ /**
+  * Get the motion state
+  * @return Motion policy object
+  */
+ const Motion &GetMotion() const { return mMotion; }
+};
+
+
+
+
+#endif //FISHT_H
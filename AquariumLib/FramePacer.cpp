@@ -0,0 +1,124 @@
+/**
+ * @file FramePacer.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/// Slowest frame rate either rate can be set to
+const double MinRate = 0.5;
+
+/// How much of each new frame cost goes into the smoothed cost
+const double CostSmoothing = 0.1;
+
+/// Seconds the achieved frame rate is counted over
+const double RateWindow = 1;
+
+/**
+ * Start a frame
+ * @param now Time the frame started
+ * @return Seconds the frame started after it was due, or 0 if it was on time
+ */
+double FramePacer::BeginFrame(Clock::time_point now)
+{
+    if (!mStarted)
+    {
+        mStarted = true;
+        mDeadline = now;
+    }
+
+    mFrameStart = now;
+    return max(0.0, chrono::duration<double>(now - mDeadline).count());
+}
+
+/**
+ * Finish a frame and work out when the next one is due.
+ *
+ * A frame that finishes after the next deadline is followed
+ * straight away by the next one, which gives a frame that only
+ * just overran the chance to catch up. Any deadlines that passed
+ * entirely while the frame ran are skipped.
+ *
+ * @param now Time the frame finished updating and drawing
+ * @param idle True if nothing was moving in the frame
+ * @return Milliseconds to wait before the next frame, at least 1
+ */
+int FramePacer::EndFrame(Clock::time_point now, bool idle)
+{
+    double cost = chrono::duration<double>(now - mFrameStart).count();
+    mCost = mCost == 0 ? cost : mCost + (cost - mCost) * CostSmoothing;
+
+    // The rate is counted between frame ends, starting with the first
+    mRateFrames++;
+    double window = chrono::duration<double>(now - mRateStart).count();
+    if (mRateFrames == 0 || window >= RateWindow)
+    {
+        if (mRateFrames > 0)
+        {
+            mFramesPerSecond = mRateFrames / window;
+        }
+
+        mRateFrames = 0;
+        mRateStart = now;
+    }
+
+    mIdle = idle;
+    auto interval = chrono::duration_cast<Clock::duration>(
+            chrono::duration<double>(1 / (idle ? mIdleRate : mTargetRate)));
+    mDeadline += interval;
+
+    if (now - mDeadline >= interval)
+    {
+        auto missed = (now - mDeadline) / interval;
+        mDeadline += missed * interval;
+        mSkipped += (uint64_t)missed;
+    }
+
+    double wait = chrono::duration<double, milli>(mDeadline - now).count();
+    return max(1, (int)ceil(wait));
+}
+
+/**
+ * Something has changed, so don't wait out the idle rate.
+ *
+ * If the last frame was idle, the next one is made due now.
+ * Otherwise the next frame is already coming at the target
+ * rate and this does nothing.
+ *
+ * @param now Time of the change
+ * @return True if the next frame was brought forward and should run now
+ */
+bool FramePacer::Wake(Clock::time_point now)
+{
+    if (!mIdle || mDeadline <= now)
+    {
+        return false;
+    }
+
+    mIdle = false;
+    mDeadline = now;
+    return true;
+}
+
+/**
+ * Set the rate to aim for while something is moving
+ * @param rate Frames per second
+ */
+void FramePacer::SetTargetRate(double rate)
+{
+    mTargetRate = max(rate, MinRate);
+}
+
+/**
+ * Set the rate used while nothing is moving
+ * @param rate Frames per second
+ */
+void FramePacer::SetIdleRate(double rate)
+{
+    mIdleRate = max(rate, MinRate);
+}
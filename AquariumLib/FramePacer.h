@@ -0,0 +1,115 @@
+/**
+ * @file FramePacer.h
+ * @author Ismail Abdi
+ *
+ * Decides when the next frame should be drawn.
+ */
+
+#ifndef AQUARIUM_FRAMEPACER_H
+#define AQUARIUM_FRAMEPACER_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Decides when the next frame should be drawn.
+ *
+ * Frames are scheduled against a deadline that advances by one
+ * frame interval at a time, rather than a fixed delay after each
+ * frame, so the time spent updating and drawing comes out of the
+ * wait instead of being added to it. The cost of a frame is
+ * measured from BeginFrame to EndFrame and smoothed.
+ *
+ * If a frame runs past one or more deadlines, the frames that
+ * should have happened in the meantime are skipped rather than
+ * run back to back to catch up. The simulation is driven by
+ * wall-clock time, so a skipped frame loses nothing but a repaint.
+ *
+ * When nothing in any tank can move, the pacer drops to the idle
+ * rate, which is enough to notice a change but costs next to
+ * nothing.
+ */
+class FramePacer {
+public:
+    /// The clock frames are timed with
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /// Frames per second to aim for while something is moving
+    double mTargetRate = 30;
+
+    /// Frames per second while nothing is moving
+    double mIdleRate = 4;
+
+    /// When the next frame is due
+    Clock::time_point mDeadline;
+
+    /// When the frame in progress started
+    Clock::time_point mFrameStart;
+
+    /// True once the first frame has started
+    bool mStarted = false;
+
+    /// True if nothing was moving in the last frame
+    bool mIdle = false;
+
+    /// Smoothed seconds a frame takes to update and draw
+    double mCost = 0;
+
+    /// Frames skipped because a frame overran its deadline
+    uint64_t mSkipped = 0;
+
+    /// End of the frame the window the frame rate is counted over started at
+    Clock::time_point mRateStart;
+
+    /// Frames finished since mRateStart, or -1 before the first frame
+    int mRateFrames = -1;
+
+    /// Frames per second over the last full window
+    double mFramesPerSecond = 0;
+
+public:
+    FramePacer() {}
+
+    double BeginFrame(Clock::time_point now);
+
+    int EndFrame(Clock::time_point now, bool idle);
+
+    bool Wake(Clock::time_point now);
+
+    /**
+     * Get the rate to aim for while something is moving
+     * @return Frames per second
+     */
+    double GetTargetRate() const { return mTargetRate; }
+
+    void SetTargetRate(double rate);
+
+    /**
+     * Get the rate used while nothing is moving
+     * @return Frames per second
+     */
+    double GetIdleRate() const { return mIdleRate; }
+
+    void SetIdleRate(double rate);
+
+    /**
+     * Smoothed time a frame takes to update and draw
+     * @return Seconds
+     */
+    double GetCost() const { return mCost; }
+
+    /**
+     * Frames skipped so far because a frame overran
+     * @return Frame count
+     */
+    uint64_t GetSkipped() const { return mSkipped; }
+
+    /**
+     * Frames actually finished per second, over the last second
+     * @return Frames per second
+     */
+    double GetFramesPerSecond() const { return mFramesPerSecond; }
+};
+
+#endif //AQUARIUM_FRAMEPACER_H
@@ -0,0 +1,139 @@
+/**
+ * @file FrameRing.h
+ * @author Ismail Abdi
+ *
+ * Layout of the shared-memory ring that finished frames are published to.
+ */
+
+#ifndef AQUARIUM_FRAMERING_H
+#define AQUARIUM_FRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Header of one slot of a FrameRing
+ */
+struct FrameRingSlot {
+    /// Odd while the slot is being written
+    std::atomic<uint64_t> mSequence;
+
+    /// Frame number, counting from 0
+    uint64_t mFrame;
+
+    /// When the frame was published, in nanoseconds of the system monotonic clock
+    uint64_t mTimestamp;
+
+    /// Width in pixels
+    uint32_t mWidth;
+
+    /// Height in pixels
+    uint32_t mHeight;
+
+    /// Bytes from the start of one row to the next
+    uint32_t mStride;
+
+    /// Pixel format
+    uint32_t mFormat;
+};
+
+/**
+ * Layout of the shared-memory ring that finished frames are published to.
+ *
+ * The shared memory object starts with a FrameRing header,
+ * followed by mSlotCount slots of mSlotStride bytes. Each slot
+ * is a FrameRingSlot header followed by the pixels, 24-bit RGB,
+ * top row first.
+ *
+ * Each slot is guarded by a sequence number that is odd while
+ * the slot is being written. A reader notes the sequence, reads
+ * the slot in place, then checks the sequence hasn't changed; if
+ * it has, the writer lapped the reader and the frame is discarded.
+ * There is one writer and any number of readers, and readers
+ * never hold up the writer.
+ *
+ * Everything is stored in the native byte order, since the ring
+ * is only ever shared between processes on one machine.
+ */
+struct FrameRing {
+    /// Magic number at the start of the shared memory
+    static const uint32_t Magic = 0x52464141;  // "AAFR"
+
+    /// Layout version
+    static const uint32_t Version = 1;
+
+    /// Pixel format of 24-bit RGB
+    static const uint32_t FormatRgb24 = 1;
+
+    /// Magic, set last when the ring is created
+    std::atomic<uint32_t> mMagic;
+
+    /// Layout version
+    uint32_t mVersion;
+
+    /// Number of slots
+    uint32_t mSlotCount;
+
+    /// Bytes of pixel data each slot can hold
+    uint32_t mSlotCapacity;
+
+    /// Bytes from the start of one slot to the next
+    uint64_t mSlotStride;
+
+    /// Number of frames published so far. Frame n is in slot n % mSlotCount.
+    std::atomic<uint64_t> mPublished;
+
+    /// Headers are padded to this, so the pixels start on a cache line
+    static const size_t Alignment = 64;
+
+    /**
+     * Round a size up to a whole number of cache lines
+     * @param size Size in bytes
+     * @return Padded size
+     */
+    static constexpr size_t Align(size_t size) { return (size + Alignment - 1) / Alignment * Alignment; }
+
+    /**
+     * Get the slot a frame goes in
+     * @param frame Frame number
+     * @return Slot header
+     */
+    FrameRingSlot *GetSlot(uint64_t frame)
+    {
+        auto start = reinterpret_cast<unsigned char *>(this) + Align(sizeof(FrameRing));
+        return reinterpret_cast<FrameRingSlot *>(start + (frame % mSlotCount) * mSlotStride);
+    }
+
+    /**
+     * Get the pixels of a slot
+     * @param slot Slot header
+     * @return First byte of the top row
+     */
+    static unsigned char *GetPixels(FrameRingSlot *slot)
+    {
+        return reinterpret_cast<unsigned char *>(slot) + Align(sizeof(FrameRingSlot));
+    }
+
+    /**
+     * Bytes of shared memory a ring takes
+     * @param slots Number of slots
+     * @param capacity Bytes of pixel data per slot
+     * @return Size in bytes
+     */
+    static size_t GetSize(uint32_t slots, uint32_t capacity)
+    {
+        return Align(sizeof(FrameRing)) + GetSlotStride(capacity) * slots;
+    }
+
+    /**
+     * Bytes from the start of one slot to the next
+     * @param capacity Bytes of pixel data per slot
+     * @return Slot stride in bytes
+     */
+    static size_t GetSlotStride(uint32_t capacity) { return Align(Align(sizeof(FrameRingSlot)) + capacity); }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Frame rings need lock-free 64-bit atomics");
+
+#endif //AQUARIUM_FRAMERING_H
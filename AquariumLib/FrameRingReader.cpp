@@ -0,0 +1,175 @@
+/**
+ * @file FrameRingReader.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "FrameRingReader.h"
+#include "FrameRing.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * Destructor
+ */
+FrameRingReader::~FrameRingReader()
+{
+    Close();
+}
+
+/**
+ * Map a ring a writer has created
+ * @param name Name of the shared memory object, starting with a /
+ * @return True if the ring was opened
+ */
+bool FrameRingReader::Open(const std::string &name)
+{
+    Close();
+
+#ifdef _WIN32
+    return false;
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    void *memory = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && (size_t)status.st_size >= sizeof(FrameRing))
+    {
+        memory = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    auto ring = static_cast<FrameRing *>(memory);
+    if (ring->mMagic.load(memory_order_acquire) != FrameRing::Magic || ring->mVersion != FrameRing::Version ||
+            ring->mSlotCount == 0 || FrameRing::GetSize(ring->mSlotCount, ring->mSlotCapacity) > (size_t)status.st_size)
+    {
+        munmap(memory, (size_t)status.st_size);
+        return false;
+    }
+
+    mRing = ring;
+    mSize = (size_t)status.st_size;
+    return true;
+#endif
+}
+
+/**
+ * Unmap the ring
+ */
+void FrameRingReader::Close()
+{
+#ifndef _WIN32
+    if (mRing != nullptr)
+    {
+        munmap(mRing, mSize);
+    }
+#endif
+
+    mRing = nullptr;
+    mSize = 0;
+}
+
+/**
+ * Number of frames the writer has published
+ * @return Frame count
+ */
+uint64_t FrameRingReader::GetPublished() const
+{
+    return mRing == nullptr ? 0 : mRing->mPublished.load(memory_order_acquire);
+}
+
+/**
+ * Number of frames the ring holds
+ * @return Slot count
+ */
+uint32_t FrameRingReader::GetSlotCount() const
+{
+    return mRing == nullptr ? 0 : mRing->mSlotCount;
+}
+
+/**
+ * Get a frame.
+ * @param frame Frame number
+ * @param result Set to the frame
+ * @return False if the frame hasn't been published, has already
+ * been overwritten, or is being overwritten right now
+ */
+bool FrameRingReader::Get(uint64_t frame, Frame &result) const
+{
+    auto published = GetPublished();
+    if (frame >= published || published - frame > mRing->mSlotCount)
+    {
+        return false;
+    }
+
+    auto slot = mRing->GetSlot(frame);
+    auto sequence = slot->mSequence.load(memory_order_acquire);
+    if (sequence & 1)
+    {
+        return false;
+    }
+
+    Frame read;
+    read.mFrame = slot->mFrame;
+    read.mTimestamp = slot->mTimestamp;
+    read.mWidth = (int)slot->mWidth;
+    read.mHeight = (int)slot->mHeight;
+    read.mStride = (int)slot->mStride;
+    read.mPixels = FrameRing::GetPixels(slot);
+    read.mSlot = slot;
+    read.mSequence = sequence;
+    uint32_t format = slot->mFormat;
+
+    // If the writer started on the slot while we read it, the header may be torn
+    if (!IsCurrent(read) || read.mFrame != frame || format != FrameRing::FormatRgb24 ||
+            (size_t)read.mStride * read.mHeight > mRing->mSlotCapacity)
+    {
+        return false;
+    }
+
+    result = read;
+    return true;
+}
+
+/**
+ * Get the newest frame
+ * @param result Set to the frame
+ * @return False if there are no frames yet, or the newest is being overwritten
+ */
+bool FrameRingReader::Latest(Frame &result) const
+{
+    auto published = GetPublished();
+    return published > 0 && Get(published - 1, result);
+}
+
+/**
+ * Is a frame still in the ring as it was read?
+ *
+ * Call this after using the pixels. If it returns false the
+ * writer has started overwriting the frame, and what was read
+ * from it can't be trusted.
+ *
+ * @param frame Frame from Get or Latest
+ * @return True if the frame hasn't changed
+ */
+bool FrameRingReader::IsCurrent(const Frame &frame) const
+{
+    atomic_thread_fence(memory_order_acquire);
+    return frame.mSlot != nullptr && frame.mSlot->mSequence.load(memory_order_relaxed) == frame.mSequence;
+}
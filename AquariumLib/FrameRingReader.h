@@ -0,0 +1,93 @@
+/**
+ * @file FrameRingReader.h
+ * @author Ismail Abdi
+ *
+ * Reads frames from a shared-memory ring in place.
+ */
+
+#ifndef AQUARIUM_FRAMERINGREADER_H
+#define AQUARIUM_FRAMERINGREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct FrameRing;
+struct FrameRingSlot;
+
+/**
+ * Reads frames from a shared-memory ring in place.
+ *
+ * Frames aren't copied out of the ring. A frame's pixels point
+ * into the shared memory and stay good until the writer comes
+ * round to that slot again, so check IsCurrent after using them.
+ */
+class FrameRingReader {
+public:
+    /// A frame in the ring
+    struct Frame {
+        /// Frame number, counting from 0
+        uint64_t mFrame = 0;
+
+        /// When the frame was published, in nanoseconds of the system monotonic clock
+        uint64_t mTimestamp = 0;
+
+        /// Width in pixels
+        int mWidth = 0;
+
+        /// Height in pixels
+        int mHeight = 0;
+
+        /// Bytes from the start of one row to the next
+        int mStride = 0;
+
+        /// 24-bit RGB pixels, top row first, in the shared memory
+        const unsigned char *mPixels = nullptr;
+
+        /// The slot the frame is in
+        FrameRingSlot *mSlot = nullptr;
+
+        /// Sequence number of the slot when the frame was read
+        uint64_t mSequence = 0;
+    };
+
+private:
+    /// The mapped ring, or nullptr if not open
+    FrameRing *mRing = nullptr;
+
+    /// Bytes mapped
+    size_t mSize = 0;
+
+public:
+    FrameRingReader() {}
+
+    virtual ~FrameRingReader();
+
+    /// Copy constructor (disabled)
+    FrameRingReader(const FrameRingReader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameRingReader &) = delete;
+
+    bool Open(const std::string &name);
+
+    void Close();
+
+    /**
+     * Is a ring open?
+     * @return True if open
+     */
+    bool IsOpen() const { return mRing != nullptr; }
+
+    uint64_t GetPublished() const;
+
+    uint32_t GetSlotCount() const;
+
+    bool Get(uint64_t frame, Frame &result) const;
+
+    bool Latest(Frame &result) const;
+
+    bool IsCurrent(const Frame &frame) const;
+};
+
+#endif //AQUARIUM_FRAMERINGREADER_H
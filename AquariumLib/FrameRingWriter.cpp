@@ -0,0 +1,175 @@
+/**
+ * @file FrameRingWriter.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "FrameRingWriter.h"
+#include "FrameRing.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * Destructor
+ */
+FrameRingWriter::~FrameRingWriter()
+{
+    Close();
+}
+
+/**
+ * Create the shared memory ring.
+ *
+ * Replaces any ring of the same name left behind by a writer
+ * that didn't close.
+ *
+ * @param name Name of the shared memory object, starting with a /
+ * @param slots Number of frames the ring holds
+ * @param capacity Bytes of pixel data each frame can have
+ * @return True if successful
+ */
+bool FrameRingWriter::Create(const std::string &name, uint32_t slots, uint32_t capacity)
+{
+    Close();
+    if (slots == 0)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    return false;
+#else
+    size_t size = FrameRing::GetSize(slots, capacity);
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+    {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // The new object is all zeros, which is a valid empty ring
+    // apart from the header
+    mRing = static_cast<FrameRing *>(memory);
+    mRing->mVersion = FrameRing::Version;
+    mRing->mSlotCount = slots;
+    mRing->mSlotCapacity = capacity;
+    mRing->mSlotStride = FrameRing::GetSlotStride(capacity);
+    mRing->mPublished.store(0, memory_order_relaxed);
+    mRing->mMagic.store(FrameRing::Magic, memory_order_release);
+
+    mName = name;
+    mSize = size;
+    return true;
+#endif
+}
+
+/**
+ * Unmap the ring and remove the shared memory object.
+ * Readers that still have it mapped can carry on reading it.
+ */
+void FrameRingWriter::Close()
+{
+#ifndef _WIN32
+    if (mRing != nullptr)
+    {
+        munmap(mRing, mSize);
+        shm_unlink(mName.c_str());
+    }
+#endif
+
+    mRing = nullptr;
+    mSize = 0;
+    mName.clear();
+}
+
+/**
+ * Publish a frame.
+ *
+ * Overwrites the oldest frame in the ring. Frames too big for
+ * the slots are dropped.
+ *
+ * @param pixels 24-bit RGB pixels, top row first
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param stride Bytes from the start of one row to the next in pixels
+ * @return True if the frame was published
+ */
+bool FrameRingWriter::Publish(const unsigned char *pixels, int width, int height, int stride)
+{
+    size_t rowBytes = (size_t)width * 3;
+    if (mRing == nullptr || width <= 0 || height <= 0 || rowBytes * height > mRing->mSlotCapacity)
+    {
+        return false;
+    }
+
+    auto frame = mRing->mPublished.load(memory_order_relaxed);
+    auto slot = mRing->GetSlot(frame);
+    auto data = FrameRing::GetPixels(slot);
+
+    // Odd while we write, so readers can tell the slot is changing
+    auto sequence = slot->mSequence.load(memory_order_relaxed);
+    slot->mSequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->mFrame = frame;
+    slot->mWidth = (uint32_t)width;
+    slot->mHeight = (uint32_t)height;
+    slot->mStride = (uint32_t)rowBytes;
+    slot->mFormat = FrameRing::FormatRgb24;
+    for (int y = 0; y < height; y++)
+    {
+        memcpy(data + y * rowBytes, pixels + (size_t)y * stride, rowBytes);
+    }
+    slot->mTimestamp = Now();
+
+    slot->mSequence.store(sequence + 2, memory_order_release);
+    mRing->mPublished.store(frame + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * Number of frames published so far
+ * @return Frame count
+ */
+uint64_t FrameRingWriter::GetPublished() const
+{
+    return mRing == nullptr ? 0 : mRing->mPublished.load(memory_order_relaxed);
+}
+
+/**
+ * The time frames are stamped with
+ * @return Nanoseconds of the system monotonic clock, which every
+ * process on the machine shares
+ */
+uint64_t FrameRingWriter::Now()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+#endif
+}
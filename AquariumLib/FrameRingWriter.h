@@ -0,0 +1,73 @@
+/**
+ * @file FrameRingWriter.h
+ * @author Ismail Abdi
+ *
+ * Publishes frames to a shared-memory ring.
+ */
+
+#ifndef AQUARIUM_FRAMERINGWRITER_H
+#define AQUARIUM_FRAMERINGWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct FrameRing;
+
+/**
+ * Publishes frames to a shared-memory ring.
+ *
+ * Creates a POSIX shared memory object that other processes on
+ * the machine can map to read the frames without copying them.
+ * See FrameRing for the layout. The object is removed again when
+ * the writer is closed.
+ *
+ * Shared memory rings are only available on POSIX systems. On
+ * other systems Create always fails.
+ */
+class FrameRingWriter {
+private:
+    /// Name of the shared memory object
+    std::string mName;
+
+    /// The mapped ring, or nullptr if not open
+    FrameRing *mRing = nullptr;
+
+    /// Bytes mapped
+    size_t mSize = 0;
+
+public:
+    FrameRingWriter() {}
+
+    virtual ~FrameRingWriter();
+
+    /// Copy constructor (disabled)
+    FrameRingWriter(const FrameRingWriter &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameRingWriter &) = delete;
+
+    bool Create(const std::string &name, uint32_t slots, uint32_t capacity);
+
+    void Close();
+
+    /**
+     * Is the ring open?
+     * @return True if frames can be published
+     */
+    bool IsOpen() const { return mRing != nullptr; }
+
+    /**
+     * Get the name of the shared memory object
+     * @return Name, starting with a /
+     */
+    const std::string &GetName() const { return mName; }
+
+    bool Publish(const unsigned char *pixels, int width, int height, int stride);
+
+    uint64_t GetPublished() const;
+
+    static uint64_t Now();
+};
+
+#endif //AQUARIUM_FRAMERINGWRITER_H
@@ -6,6 +6,14 @@
 #include "pch.h"
 #include "Item.h"
 #include "Aquarium.h"
+#include "Sprite.h"
+#include "Viewport.h"
+#include "StateHash.h"
+#include "SpeciesRegistry.h"
+#include "AnimationClip.h"
+#include "Metrics.h"
+#include "ItemGroup.h"
+#include "AquariumSnapshot.h"
 
 /**
  * Constructor
@@ -14,11 +22,37 @@
  */
 Item::Item(Aquarium* aquarium, const std::wstring& filename) : mAquarium(aquarium)
 {
-	// Load the fish image from the given file
-	mItemImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
+	// Images are loaded once and shared by every item that uses them
+	mSprite = aquarium->GetSprites()->Get(filename);
+}
+
+/**
+ * Constructor
+ * @param aquarium The aquarium this item is a member of
+ * @param species The species this item is
+ */
+Item::Item(Aquarium* aquarium, std::shared_ptr<const Species> species) :
+	Item(aquarium, species->mImage)
+{
+	mSpecies = species;
 
-	// Create a bitmap from the image
-	mItemBitmap = std::make_unique<wxBitmap>(*mItemImage);
+	// Start each animated item at a different point in the clip
+	if (species->mClip != nullptr)
+	{
+		std::uniform_real_distribution<> distribution(0, (double)species->mClip->GetFrameCount());
+		mPhase = distribution(aquarium->GetRandom());
+	}
+}
+
+/**
+ * Move this item to a tuned copy of its species and pick up
+ * the new parameters.
+ * @param species The tuned species. See SpeciesRegistry::IsTuning.
+ */
+void Item::Retune(std::shared_ptr<const Species> species)
+{
+	mSpecies = species;
+	OnSpeciesChanged();
 }
 
 /**
@@ -35,8 +69,8 @@ Item::~Item()
  * @return true if the item was clicked, false otherwise
  */
 bool Item::HitTest(int x, int y) {
-	double width = mItemBitmap->GetWidth();
-	double height = mItemBitmap->GetHeight();
+	double width = GetWidth();
+	double height = GetHeight();
 
 	double testX = x - GetX() + width / 2;
 	double testY = y - GetY() + height / 2;
@@ -45,7 +79,113 @@ bool Item::HitTest(int x, int y) {
 		return false;
 	}
 
-	return !mItemImage->IsTransparent(static_cast<int>(testX), static_cast<int>(testY));
+	// The mask matches the way we are facing, so mirrored fish test correctly
+	return GetFrame()->GetMask(mMirror).IsOpaque(static_cast<int>(testX), static_cast<int>(testY));
+}
+
+/**
+ * Get the sprite to show right now.
+ *
+ * For an animated species the frame comes from the aquarium's
+ * simulation time, so nothing is stored or updated per item.
+ *
+ * @return Current animation frame, or the item's only image
+ */
+Sprite *Item::GetFrame() const
+{
+	if (mSpecies == nullptr || mSpecies->mClip == nullptr)
+	{
+		return mSprite.get();
+	}
+
+	auto &clip = *mSpecies->mClip;
+	return clip.GetFrame(clip.FrameAt(mAquarium->GetTime() * mSpecies->mFrameRate + mPhase));
+}
+
+/**
+ * Can this item change from one frame to the next?
+ *
+ * Items of an animated species change as the simulation time
+ * moves on. Derived classes that move override this.
+ *
+ * @return True if the item needs to be redrawn as time passes
+ */
+bool Item::IsAnimated() const
+{
+	return mSpecies != nullptr && mSpecies->mClip != nullptr;
+}
+
+/**
+ * Make a group that can update every item of this class at
+ * once, without a virtual call per item. Items that don't
+ * have one are updated one at a time.
+ * @return New empty group, or nullptr to update items one at a time
+ */
+std::unique_ptr<ItemGroup> Item::NewGroup() const
+{
+	return nullptr;
+}
+
+/**
+ * Do the opaque pixels of this item overlap another item's?
+ *
+ * The bounding boxes are tested first, then the packed
+ * opacity masks 64 pixels at a time.
+ *
+ * @param other The other item
+ * @return True if the items touch
+ */
+bool Item::Overlaps(const Item& other) const
+{
+	int left = static_cast<int>(GetX() - GetWidth() / 2.0);
+	int top = static_cast<int>(GetY() - GetHeight() / 2.0);
+	int otherLeft = static_cast<int>(other.GetX() - other.GetWidth() / 2.0);
+	int otherTop = static_cast<int>(other.GetY() - other.GetHeight() / 2.0);
+
+	if (otherLeft >= left + GetWidth() || left >= otherLeft + other.GetWidth() ||
+		otherTop >= top + GetHeight() || top >= otherTop + other.GetHeight())
+	{
+		return false;
+	}
+
+	auto& mask = GetFrame()->GetMask(mMirror);
+	return mask.Overlaps(other.GetFrame()->GetMask(other.mMirror), otherLeft - left, otherTop - top);
+}
+
+/**
+ * Get the fish image
+ * @return Full size, unmirrored image
+ */
+wxImage* Item::GetFishImage() const
+{
+	return GetFrame()->GetImage();
+}
+
+/**
+ * Get the fish bitmap for the way the item is facing
+ * @return Full size bitmap
+ */
+wxBitmap* Item::GetFishBitmap() const
+{
+	return GetFrame()->GetBitmap(mMirror);
+}
+
+/**
+ * Width of the item
+ * @return Width in pixels
+ */
+int Item::GetWidth() const
+{
+	return mSprite->GetWidth();
+}
+
+/**
+ * Height of the item
+ * @return Height in pixels
+ */
+int Item::GetHeight() const
+{
+	return mSprite->GetHeight();
 }
 
 
@@ -54,13 +194,47 @@ bool Item::HitTest(int x, int y) {
  * @param dc Device context to draw on
  */
 void Item::Draw(wxDC* dc)
+{
+	DrawFrame(dc, GetFrame());
+}
+
+/**
+ * Draw one frame of this item's animation
+ * @param dc Device context to draw on
+ * @param frame Sprite to draw, the same size as the item's image
+ */
+void Item::DrawFrame(wxDC* dc, Sprite* frame)
 {
 	// Get the width and height of the bitmap
-	double width = mItemBitmap->GetWidth();
-	double height = mItemBitmap->GetHeight();
+	double width = GetWidth();
+	double height = GetHeight();
+
+	// Draw the bitmap centered at the item's location. The sprite
+	// draws a placeholder if it is still being decoded.
+	frame->Draw(dc, mMirror, static_cast<int>(GetX() - width / 2), static_cast<int>(GetY() - height / 2), 1);
+}
+
+/**
+ * Draw this item through a viewport.
+ *
+ * When the view is panned or zoomed this draws from the sprite's
+ * mip chain instead of calling Draw, so a zoomed out tank never
+ * scales full size images.
+ *
+ * @param dc Device context to draw on
+ * @param viewport The part of the aquarium being shown
+ */
+void Item::DrawLod(wxDC* dc, const Viewport& viewport)
+{
+	if (viewport.IsIdentity())
+	{
+		Draw(dc);
+		return;
+	}
 
-	// Draw the bitmap centered at the item's location
-	dc->DrawBitmap(*mItemBitmap, static_cast<int>(GetX() - width / 2), static_cast<int>(GetY() - height / 2));
+	double left = viewport.ToScreenX(GetX() - GetWidth() / 2.0);
+	double top = viewport.ToScreenY(GetY() - GetHeight() / 2.0);
+	GetFrame()->Draw(dc, mMirror, left, top, viewport.GetZoom());
 }
 
 
@@ -73,19 +247,18 @@ double Item::DistanceTo(std::shared_ptr<Item> other)
 
 
 /**
- * Save this item to an XML node
+ * Save this item to an XML node.
+ *
+ * Aquarium::Save writes every item from a snapshot, so this goes
+ * through the same code and what it writes can't differ. Anything
+ * an item saves has to be part of AquariumSnapshot::ItemState.
+ *
  * @param node The parent node we are going to be a child of
  * @return wxXmlNode that we saved the item into
  */
-wxXmlNode* Item::XmlSave(wxXmlNode* node)
+wxXmlNode* Item::XmlSave(wxXmlNode* node) const
 {
-	auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
-	node->AddChild(itemNode);
-
-	itemNode->AddAttribute(L"x", wxString::FromDouble(mX));
-	itemNode->AddAttribute(L"y", wxString::FromDouble(mY));
-
-	return itemNode;
+	return AquariumSnapshot::SaveItem(node, AquariumSnapshot::Capture(*this));
 }
 
 
@@ -105,6 +278,33 @@ void Item::XmlLoad(wxXmlNode *node)
 }
 
 
+/**
+ * Add the state that changes as the simulation runs to a hash.
+ *
+ * Override this to add any state a derived item updates.
+ *
+ * @param hash Hash to add to
+ */
+void Item::HashState(StateHash &hash) const
+{
+	hash.Add(mX);
+	hash.Add(mY);
+	hash.Add(mMirror);
+}
+
+
+/**
+ * Hash the state of this item on its own.
+ * @return Hash of the item's state
+ */
+uint64_t Item::GetStateHash() const
+{
+	StateHash hash;
+	HashState(hash);
+	return hash.Get();
+}
+
+
 
 
 /**
@@ -112,18 +312,12 @@ void Item::XmlLoad(wxXmlNode *node)
  * @param m New mirror flag
  */
 void Item::SetMirror(bool m) {
-	if(m != mMirror)
+	static auto &turns = Metrics::GetDefault()->Counter("aquarium_item_turns_total", "Times an item turned around");
+	if (m != mMirror)
 	{
-		mMirror = m;
-
-		// Update the bitmap to reflect the mirrored status
-		if(mMirror)
-		{
-			mItemBitmap = std::make_unique<wxBitmap>(mItemImage->Mirror());  // Create mirrored image
-		}
-		else
-		{
-			mItemBitmap = std::make_unique<wxBitmap>(*mItemImage);  // Use the normal image
-		}
+		turns.Add();
 	}
+
+	// Both orientations live in the shared sprite, so turning is just a flag
+	mMirror = m;
 }
\ No newline at end of file
@@ -8,7 +8,15 @@
 #ifndef AQUARIUM_ITEM_H
 #define AQUARIUM_ITEM_H
 
+#include <memory>
+#include <cstdint>
+
 class Aquarium;
+class Sprite;
+class Viewport;
+class StateHash;
+class ItemGroup;
+struct Species;
 
 /**
  * Base class for any item in our aquarium.
@@ -22,18 +30,20 @@ private:
     double mX = 0;     ///< X location for the center of the item
     double mY = 0;     ///< Y location for the center of the item
 
-    /// The underlying fish image
-    std::unique_ptr<wxImage> mItemImage;
+    /// The image for this item, shared with every item that uses the same file
+    std::shared_ptr<Sprite> mSprite;
 
+    /// The species this item is, or nullptr if it isn't a registered species
+    std::shared_ptr<const Species> mSpecies;
 
+    /// How many frames into its animation this item is at time zero
+    double mPhase = 0;
 
 
-    bool mMirror = false;   ///< True mirrors the item image
 
 
-protected:
- /// The bitmap we can display for this item
- std::unique_ptr<wxBitmap> mItemBitmap;
+    bool mMirror = false;   ///< True mirrors the item image
+
 
 public:
     /**
@@ -43,6 +53,8 @@ public:
      */
     Item(Aquarium* aquarium, const std::wstring& filename);
 
+    Item(Aquarium* aquarium, std::shared_ptr<const Species> species);
+
     /// Destructor
     virtual ~Item();
 
@@ -80,6 +92,8 @@ public:
      */
     virtual void Draw(wxDC* dc);
 
+    void DrawLod(wxDC* dc, const Viewport& viewport);
+
     /**
      * Perform hit testing
      * @param x X location in pixels
@@ -88,14 +102,31 @@ public:
      */
     bool HitTest(int x, int y);
 
+    bool Overlaps(const Item& other) const;
+
     /// Get the fish image
-    wxImage* GetFishImage() const { return mItemImage.get(); }
+    wxImage* GetFishImage() const;
 
-    /// Get the fish bitmap
-    wxBitmap* GetFishBitmap() const { return mItemBitmap.get(); }
+    /// Get the fish bitmap for the way the item is facing
+    wxBitmap* GetFishBitmap() const;
 
-    /// Set a new fish bitmap (optional, in case derived classes need to set a new bitmap)
-    void SetFishBitmap(std::unique_ptr<wxBitmap> bitmap) { mItemBitmap = std::move(bitmap); }
+    /**
+     * Get the sprite this item is drawn with
+     * @return Shared sprite
+     */
+    const std::shared_ptr<Sprite> &GetSprite() const { return mSprite; }
+
+    Sprite *GetFrame() const;
+
+    int GetWidth() const;
+
+    int GetHeight() const;
+
+    /**
+     * Is the item image mirrored?
+     * @return True if mirrored
+     */
+    bool IsMirror() const { return mMirror; }
 
  /**
      * Calculate the distance between this item and another item.
@@ -104,16 +135,46 @@ public:
      */
     double DistanceTo(std::shared_ptr<Item> other);
 
-    virtual wxXmlNode* XmlSave(wxXmlNode* node);
+    /**
+     * Get the species this item is
+     * @return Species, or nullptr if it isn't a registered species
+     */
+    const std::shared_ptr<const Species> &GetSpecies() const { return mSpecies; }
+
+    void Retune(std::shared_ptr<const Species> species);
+
+    /**
+     * Called when the parameters of this item's species have been
+     * tuned. Override this to pick up parameters the item keeps
+     * its own copy of.
+     */
+    virtual void OnSpeciesChanged() {}
+
+    wxXmlNode* XmlSave(wxXmlNode* node) const;
 
     virtual void XmlLoad(wxXmlNode *node);
 
+    virtual void HashState(StateHash &hash) const;
+
+    uint64_t GetStateHash() const;
+
      /**
      * Handle updates for animation.
      * @param elapsed The time since the last update.
      */
     virtual void Update(double elapsed) {}
 
+    virtual bool IsAnimated() const;
+
+    virtual std::unique_ptr<ItemGroup> NewGroup() const;
+
+    /**
+     * Memory used by this item object, not counting the sprite it
+     * shares with every other item that displays it. Classes with
+     * members of their own override this.
+     * @return Size in bytes
+     */
+    virtual size_t GetByteSize() const { return sizeof(Item); }
 
     /**
      * Get the pointer to the Aquarium object
@@ -123,5 +184,8 @@ public:
 
 
     void SetMirror(bool m);
+
+protected:
+    void DrawFrame(wxDC* dc, Sprite* frame);
 };
 #endif //AQUARIUM_ITEM_H
@@ -0,0 +1,102 @@
+/**
+ * @file ItemGroup.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "ItemGroup.h"
+#include "Item.h"
+
+using namespace std;
+
+/**
+ * Sort the items into their groups
+ * @param items Items in the aquarium, in drawing order
+ */
+void ItemGroups::Sort(const std::vector<std::shared_ptr<Item>> &items)
+{
+    for (auto &group : mGroups)
+    {
+        group->Clear();
+    }
+    mOthers.clear();
+
+    for (auto &item : items)
+    {
+        auto &object = *item;
+        auto found = mByClass.find(typeid(object));
+        if (found == mByClass.end())
+        {
+            // First of its class, so find out if it has a group
+            auto added = item->NewGroup();
+            found = mByClass.emplace(typeid(object), added.get()).first;
+            if (added != nullptr)
+            {
+                mGroups.push_back(move(added));
+            }
+        }
+
+        if (found->second != nullptr)
+        {
+            found->second->Add(item.get());
+        }
+        else
+        {
+            mOthers.push_back(item.get());
+        }
+    }
+
+    mValid = true;
+}
+
+/**
+ * Update the items a group at a time.
+ *
+ * Items in the same group are updated in drawing order. Items
+ * don't look at each other while they update, so the order only
+ * decides who draws which random numbers, and that is the same
+ * on every run with the same items.
+ *
+ * @param items Items in the aquarium, in drawing order
+ * @param elapsed Time elapsed since the last update
+ * @return True if the items were sorted into their groups again first
+ */
+bool ItemGroups::Update(const std::vector<std::shared_ptr<Item>> &items, double elapsed)
+{
+    bool sorted = !mValid;
+    if (sorted)
+    {
+        Sort(items);
+    }
+
+    for (auto &group : mGroups)
+    {
+        group->Update(elapsed);
+    }
+
+    for (auto item : mOthers)
+    {
+        item->Update(elapsed);
+    }
+
+    return sorted;
+}
+
+/**
+ * Memory used by the groups and the class map, not counting
+ * the ItemGroups object itself
+ * @return Size in bytes
+ */
+size_t ItemGroups::GetByteSize() const
+{
+    size_t bytes = MemoryUsage::Capacity(mGroups) + MemoryUsage::Capacity(mOthers);
+    for (auto &group : mGroups)
+    {
+        bytes += group->GetByteSize();
+    }
+
+    // Each entry of the map is a node of its own
+    bytes += mByClass.bucket_count() * sizeof(void *);
+    bytes += mByClass.size() * (sizeof(void *) + sizeof(*mByClass.begin()));
+    return bytes;
+}
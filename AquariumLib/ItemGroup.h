@@ -0,0 +1,200 @@
+/**
+ * @file ItemGroup.h
+ * @author Ismail Abdi
+ *
+ * Items of one class, kept together so they can be updated without virtual calls.
+ */
+
+#ifndef AQUARIUM_ITEMGROUP_H
+#define AQUARIUM_ITEMGROUP_H
+
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "MemoryUsage.h"
+
+class Item;
+
+/**
+ * Items of one class, kept together so they can be updated
+ * without virtual calls.
+ *
+ * The aquarium still owns its items, in drawing order; a group
+ * only points at them. Updating a group is one virtual call for
+ * the whole group, after which every item is updated by a loop
+ * the compiler can see all the way into.
+ */
+class ItemGroup {
+public:
+    /// Destructor
+    virtual ~ItemGroup() {}
+
+    /**
+     * Add an item. It must be of the group's class.
+     * @param item Item to add
+     */
+    virtual void Add(Item *item) = 0;
+
+    /**
+     * Remove every item from the group
+     */
+    virtual void Clear() = 0;
+
+    /**
+     * Update every item in the group
+     * @param elapsed Time elapsed since the last update
+     */
+    virtual void Update(double elapsed) = 0;
+
+    /**
+     * Number of items in the group
+     * @return Item count
+     */
+    virtual size_t GetCount() const = 0;
+
+    /**
+     * Memory used by the group
+     * @return Size in bytes
+     */
+    virtual size_t GetByteSize() const = 0;
+};
+
+/**
+ * A group of items of class T, which must have a non-virtual
+ * Step(elapsed) that does what its Update does.
+ * @tparam T Item class
+ */
+template <class T>
+class ItemGroupT : public ItemGroup {
+private:
+    /// The items, in drawing order
+    std::vector<T *> mItems;
+
+public:
+    /**
+     * Add an item. It must be of class T.
+     * @param item Item to add
+     */
+    void Add(Item *item) override { mItems.push_back(static_cast<T *>(item)); }
+
+    /**
+     * Remove every item from the group
+     */
+    void Clear() override { mItems.clear(); }
+
+    /**
+     * Update every item in the group
+     * @param elapsed Time elapsed since the last update
+     */
+    void Update(double elapsed) override
+    {
+        for (auto item : mItems)
+        {
+            item->Step(elapsed);
+        }
+    }
+
+    /**
+     * Number of items in the group
+     * @return Item count
+     */
+    size_t GetCount() const override { return mItems.size(); }
+
+    /**
+     * Memory used by the group
+     * @return Size in bytes
+     */
+    size_t GetByteSize() const override { return sizeof(*this) + MemoryUsage::Capacity(mItems); }
+};
+
+/**
+ * A group of items that don't move themselves, because something
+ * else in the aquarium moves them. Updating it does nothing, so
+ * the items cost nothing per update.
+ */
+class ItemGroupIdle : public ItemGroup {
+private:
+    /// Number of items in the group
+    size_t mCount = 0;
+
+public:
+    /**
+     * Add an item
+     * @param item Item to add
+     */
+    void Add(Item *item) override { mCount++; }
+
+    /**
+     * Remove every item from the group
+     */
+    void Clear() override { mCount = 0; }
+
+    /**
+     * Update every item in the group, which does nothing
+     * @param elapsed Time elapsed since the last update
+     */
+    void Update(double elapsed) override {}
+
+    /**
+     * Number of items in the group
+     * @return Item count
+     */
+    size_t GetCount() const override { return mCount; }
+
+    /**
+     * Memory used by the group
+     * @return Size in bytes
+     */
+    size_t GetByteSize() const override { return sizeof(*this); }
+};
+
+/**
+ * Sorts the items of an aquarium into groups by class.
+ *
+ * Items whose class has no group are updated one at a time
+ * through Item::Update. The groups are sorted again only after
+ * items are added, removed or reordered.
+ */
+class ItemGroups {
+private:
+    /// The groups, in the order their classes were first seen
+    std::vector<std::unique_ptr<ItemGroup>> mGroups;
+
+    /// Group for each class seen, or nullptr for classes updated one at a time
+    std::unordered_map<std::type_index, ItemGroup *> mByClass;
+
+    /// Items updated one at a time, in drawing order
+    std::vector<Item *> mOthers;
+
+    /// False if the items have changed since they were sorted
+    bool mValid = false;
+
+    void Sort(const std::vector<std::shared_ptr<Item>> &items);
+
+public:
+    ItemGroups() {}
+
+    /**
+     * Note that items have been added, removed or reordered
+     */
+    void Invalidate() { mValid = false; }
+
+    bool Update(const std::vector<std::shared_ptr<Item>> &items, double elapsed);
+
+    /**
+     * Number of classes with a group, including empty ones
+     * @return Group count
+     */
+    size_t GetGroupCount() const { return mGroups.size(); }
+
+    /**
+     * Number of items updated one at a time by the last Update
+     * @return Item count
+     */
+    size_t GetOtherCount() const { return mOthers.size(); }
+
+    size_t GetByteSize() const;
+};
+
+#endif //AQUARIUM_ITEMGROUP_H
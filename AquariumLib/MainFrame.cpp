@@ -7,25 +7,68 @@
 #include "MainFrame.h"
 #include "AquariumView.h"
 #include "DecorCastle.h"
-#include "ids.h"  // Include the ids.h file where IDM_ADDFISHBETA is defined
+#include "ids.h"  // Include the ids.h file where IDM_ADDSPECIES is defined
+#include "SpeciesRegistry.h"
+#include "AssetLoader.h"
+#include "Aquarium.h"
+#include "Sprite.h"
+#include "TankHost.h"
+#include "ThreadPool.h"
+#include "ControlServer.h"
+#include "Metrics.h"
+#include <wx/filename.h>
+#include <chrono>
+
+/// Frame rates offered in the Simulation menu
+const int FrameRates[] = {15, 30, 60, 120};
+
+/// Number of entries in FrameRates
+const int FrameRateCount = sizeof(FrameRates) / sizeof(FrameRates[0]);
+
+/// Frames per second to aim for at startup
+const int DefaultFrameRate = 30;
+
+/// Milliseconds the species file must be left alone before it is reloaded,
+/// so we don't read it while an editor is part way through saving
+const long SpeciesReloadDelay = 250;
+
+/// Milliseconds between updates of the CPU time in the status bar
+const long StatusInterval = 1000;
+
+/// Bytes in a megabyte, the unit memory is shown and budgeted in
+const double Megabyte = 1024 * 1024;
+
+/// Milliseconds between snapshots of the tanks for the control API
+const long ControlInterval = 100;
+
+/// Environment variable holding the port for the control API
+const wchar_t *ControlPortVariable = L"AQUARIUM_CONTROL_PORT";
 
 /**
  * Initialize the MainFrame window and its components.
  */
 void MainFrame::Initialize()
 {
+    // Start decoding the images now, so they load on the worker threads
+    // while the window is put together and shown rather than holding up
+    // the first paint. Until then the aquarium draws placeholders.
+    mAssets = std::make_shared<AssetLoader>(SpriteCache::GetDefault(), ThreadPool::GetDefault());
+    mAssets->Load(*SpeciesRegistry::GetDefault());
+
     // Create the main window frame
     Create(nullptr, wxID_ANY, L"Aquarium", wxDefaultPosition, wxSize(1000, 800));
 
     // Create a vertical box sizer
     auto sizer = new wxBoxSizer(wxVERTICAL);
 
-    // Initialize the AquariumView
-    mAquariumView = new AquariumView();
-    mAquariumView->Initialize(this);  // Pass the main frame as the parent
+    // One page for each tank, starting with one
+    mHost = std::make_shared<TankHost>(ThreadPool::GetDefault());
+    mNotebook = new wxNotebook(this, wxID_ANY);
+    mNotebook->Bind(wxEVT_NOTEBOOK_PAGE_CHANGED, &MainFrame::OnPageChanged, this);
+    AddTank();
 
-    // Add the AquariumView to the sizer
-    sizer->Add(mAquariumView, 1, wxEXPAND | wxALL);
+    // Add the tanks to the sizer
+    sizer->Add(mNotebook, 1, wxEXPAND | wxALL);
 
     // Set the sizer for the main frame
     SetSizer(sizer);
@@ -34,8 +77,442 @@ void MainFrame::Initialize()
     // Create the menu bar and set it
     CreateMenu();
 
-    // Create the status bar at the bottom of the window
-    CreateStatusBar(1, wxSTB_SIZEGRIP, wxID_ANY);
+    // Create the status bar at the bottom of the window, with
+    // a second field for the CPU time of the tank showing
+    CreateStatusBar(2, wxSTB_SIZEGRIP, wxID_ANY);
+
+    // The timer is one-shot; each frame schedules the next
+    mPacer.SetTargetRate(DefaultFrameRate);
+    mTimer.SetOwner(this);
+    mTimer.StartOnce(1);
+    Bind(wxEVT_TIMER, &MainFrame::OnTimer, this);
+    mStopWatch.Start();
+
+    // The file system watcher needs the event loop to be running
+    CallAfter([this] { WatchSpecies(); });
+
+    StartControlServer();
+}
+
+/**
+ * Constructor. Defined here, where ControlServer is a complete
+ * type, so code that creates a frame doesn't need its header.
+ */
+MainFrame::MainFrame()
+{
+}
+
+/**
+ * Destructor. Stops the control API, if it is running.
+ */
+MainFrame::~MainFrame()
+{
+}
+
+/**
+ * Start the control API if a port for it is set in the environment.
+ *
+ * It is off unless asked for, since anything on this machine that
+ * can reach the port can load and save files.
+ */
+void MainFrame::StartControlServer()
+{
+    wxString setting;
+    long port;
+    if (!wxGetEnv(ControlPortVariable, &setting) || !setting.ToLong(&port) || port < 0 || port > 65535)
+    {
+        return;
+    }
+
+    mControl = std::make_unique<ControlServer>();
+    mControl->SetOnQueued([this] { CallAfter([this] { Wake(); }); });
+    if (!mControl->Start((int)port))
+    {
+        mControl = nullptr;
+        wxMessageBox(wxString::Format(L"Unable to start the control API on port %ld", port));
+        return;
+    }
+
+    mControl->Publish(*mHost);
+    wxLogStatus(L"Control API listening on 127.0.0.1:%d", mControl->GetPort());
+}
+
+/**
+ * Add a tank to the host and a page to show it on
+ */
+void MainFrame::AddTank()
+{
+    static auto &tanks = Metrics::GetDefault()->Gauge("aquarium_tanks", "Tanks running");
+    auto tank = mHost->Add();
+    tanks.Set((double)mHost->GetCount());
+
+    // Posted changes should show without waiting out an idle frame
+    mHost->GetAquarium(tank)->SetOnPosted([this] { CallAfter([this] { Wake(); }); });
+
+    auto view = new AquariumView();
+    view->Initialize(mNotebook, mHost, tank);
+    mNotebook->AddPage(view, wxString::Format(L"Tank %d", (int)tank + 1), true);
+}
+
+/**
+ * Get the view of the tank that is showing
+ * @return View, or nullptr if there are no tanks
+ */
+AquariumView *MainFrame::GetView()
+{
+    return mNotebook == nullptr ? nullptr : dynamic_cast<AquariumView *>(mNotebook->GetCurrentPage());
+}
+
+/**
+ * Set the checks in the menus to match the tank that is showing
+ */
+void MainFrame::UpdateMenus()
+{
+    auto view = GetView();
+    auto menuBar = GetMenuBar();
+    if (view == nullptr || menuBar == nullptr)
+    {
+        return;
+    }
+
+    UpdateAddMenus(*view->GetAquarium()->GetSpecies());
+
+    auto &clock = mHost->GetClock(view->GetTank());
+    menuBar->Check(IDM_SCHOOLING, view->GetAquarium()->IsSchooling());
+    menuBar->Check(IDM_PAUSE, clock.IsPaused());
+    menuBar->Check(IDM_PUBLISHFRAMES, view->IsPublishingFrames());
+    for (int i = 0; i < AquariumView::SpeedCount; i++)
+    {
+        if (AquariumView::Speeds[i] == clock.GetSpeed())
+        {
+            menuBar->Check(IDM_SPEED + i, true);
+        }
+    }
+}
+
+/**
+ * Fill the Add Fish and Add Decor menus with the species of a
+ * registry. The view resolves the menu ids against the registry
+ * of the tank showing, so the menus are made from that one, and
+ * made again when another tank or a reload changes it.
+ * @param registry Species registry of the tank that is showing
+ */
+void MainFrame::UpdateAddMenus(const SpeciesRegistry &registry)
+{
+    if (&registry == mMenuSpecies && registry.GetVersion() == mMenuVersion)
+    {
+        return;
+    }
+
+    mMenuSpecies = &registry;
+    mMenuVersion = registry.GetVersion();
+    for (auto menu : {mFishMenu, mDecorMenu})
+    {
+        while (menu->GetMenuItemCount() > 0)
+        {
+            menu->Destroy(menu->FindItemByPosition(0));
+        }
+    }
+
+    // Every registered species goes in the Add Fish or Add Decor menu
+    auto &species = registry.GetSpecies();
+    for (int i = 0; i < (int)species.size() && IDM_ADDSPECIES + i <= IDM_ADDSPECIESLAST; i++)
+    {
+        auto menu = species[i]->mDecor ? mDecorMenu : mFishMenu;
+        menu->Append(IDM_ADDSPECIES + i, species[i]->mLabel,
+                wxString::Format(L"Add a %s", wxStripMenuCodes(species[i]->mLabel)));
+    }
+}
+
+/**
+ * Start watching the species data file, so edits to it
+ * are picked up by the fish already swimming.
+ */
+void MainFrame::WatchSpecies()
+{
+    auto filename = SpeciesRegistry::GetDefault()->GetFilename();
+    if (filename.empty())
+    {
+        return;
+    }
+
+    wxFileName file(filename);
+    file.MakeAbsolute();
+    mSpeciesFile = file.GetFullName();
+
+    mWatcher = std::make_unique<wxFileSystemWatcher>();
+    mWatcher->SetOwner(this);
+    Bind(wxEVT_FSWATCHER, &MainFrame::OnSpeciesFileChanged, this);
+
+    // Watch the directory, since many editors save by replacing the file
+    mWatcher->Add(wxFileName::DirName(file.GetPath()),
+            wxFSW_EVENT_MODIFY | wxFSW_EVENT_CREATE | wxFSW_EVENT_RENAME);
+}
+
+/**
+ * Handle a change in the directory holding the species file
+ * @param event File system watcher event
+ */
+void MainFrame::OnSpeciesFileChanged(wxFileSystemWatcherEvent& event)
+{
+    auto name = event.GetChangeType() == wxFSW_EVENT_RENAME ?
+            event.GetNewPath().GetFullName() : event.GetPath().GetFullName();
+    if (name == mSpeciesFile)
+    {
+        // Reloaded from OnTimer once the file has settled
+        mSpeciesChanged = true;
+        mSpeciesChangedTime = mStopWatch.Time();
+    }
+}
+
+/**
+ * Handle the timer event, which runs one frame and
+ * schedules the next.
+ *
+ * The pacer times the whole frame, update and draw, and
+ * works out how long to wait from there, so a busy frame
+ * waits less and an idle one waits much longer.
+ *
+ * @param event Timer event object
+ */
+void MainFrame::OnTimer(wxTimerEvent& event)
+{
+    static auto &ticks = Metrics::GetDefault()->Counter("aquarium_timer_ticks_total", "Frame timer events");
+    static auto &jitter = Metrics::GetDefault()->Histogram("aquarium_timer_jitter_seconds",
+            "How long after it was due each frame started");
+    static auto &missed = Metrics::GetDefault()->Counter("aquarium_missed_frames_total",
+            "Frames skipped because the frame before overran");
+    static auto &frameTime = Metrics::GetDefault()->Histogram("aquarium_frame_seconds",
+            "Time to update the tanks and draw a frame");
+    static auto &rate = Metrics::GetDefault()->Gauge("aquarium_frames_per_second", "Frames drawn per second");
+    static auto &uptime = Metrics::GetDefault()->Gauge("aquarium_uptime_seconds", "Seconds since the window opened");
+
+    auto start = FramePacer::Clock::now();
+    jitter.Observe(mPacer.BeginFrame(start));
+    ticks.Add();
+    uptime.Set(mStopWatch.Time() / 1000.0);
+
+    RunFrame();
+
+    auto end = FramePacer::Clock::now();
+    frameTime.Observe(std::chrono::duration<double>(end - start).count());
+
+    auto skipped = mPacer.GetSkipped();
+    int delay = mPacer.EndFrame(end, mHost->IsIdle());
+    missed.Add(mPacer.GetSkipped() - skipped);
+    rate.Set(mPacer.GetFramesPerSecond());
+
+    mTimer.StartOnce(delay);
+}
+
+/**
+ * Something may have started moving, so run the next
+ * frame now rather than at the idle rate.
+ */
+void MainFrame::Wake()
+{
+    if (mPacer.Wake(FramePacer::Clock::now()))
+    {
+        mTimer.StartOnce(1);
+    }
+}
+
+/**
+ * Update every tank and draw the one showing.
+ *
+ * The view is only repainted if the aquarium has changed
+ * since it was last painted, so a tank of decor costs
+ * next to nothing.
+ */
+void MainFrame::RunFrame()
+{
+    static auto &unchanged = Metrics::GetDefault()->Counter("aquarium_frames_unchanged_total",
+            "Frames not drawn because nothing had changed");
+
+    if (mSpeciesChanged && mStopWatch.Time() - mSpeciesChangedTime >= SpeciesReloadDelay)
+    {
+        mSpeciesChanged = false;
+        SpeciesRegistry::GetDefault()->Reload();
+
+        // A reload may have added species
+        UpdateMenus();
+    }
+
+    if (mAssets != nullptr && mAssets->IsDone())
+    {
+        wxLogStatus(L"Images loaded in %.0f ms", mAssets->GetLoadTime() * 1000);
+        mAssets = nullptr;
+    }
+
+    // Changes asked for through the control API are made before the update
+    if (mControl != nullptr && mControl->Apply(*mHost) > 0)
+    {
+        UpdateMenus();
+    }
+
+    mHost->Tick();
+
+    if (mControl != nullptr)
+    {
+        mControl->Sample(*mHost);
+        if (mStopWatch.Time() - mControlTime >= ControlInterval)
+        {
+            mControlTime = mStopWatch.Time();
+            mControl->Publish(*mHost);
+        }
+    }
+
+    auto view = GetView();
+    if (view == nullptr)
+    {
+        return;
+    }
+
+    if (mStopWatch.Time() - mStatusTime >= StatusInterval)
+    {
+        mStatusTime = mStopWatch.Time();
+        auto memory = ReportMemory();
+        auto tank = view->GetTank();
+        SetStatusText(wxString::Format(L"Tank %d: %.1f fps, %.2f ms CPU per update, %.1f s in total, %.1f MB",
+                (int)tank + 1, mPacer.GetFramesPerSecond(), mHost->GetLastCpuTime(tank) * 1000,
+                mHost->GetCpuTime(tank), memory.GetTotal() / Megabyte), 1);
+    }
+
+    if (!view->IsStale())
+    {
+        unchanged.Add();
+        return;
+    }
+
+    // Paint now rather than when the event loop gets round to it,
+    // so the drawing is part of the frame the pacer measures
+    view->Refresh();
+    view->Update();
+}
+
+/**
+ * Publish the memory the tanks are using as metrics
+ * @return Bytes in use by all of the tanks
+ */
+MemoryUsage MainFrame::ReportMemory()
+{
+    static auto &pixels = Metrics::GetDefault()->Gauge("aquarium_memory_pixel_bytes",
+            "Bytes of decoded images, bitmaps and masks");
+    static auto &items = Metrics::GetDefault()->Gauge("aquarium_memory_item_bytes", "Bytes of item objects");
+    static auto &containers = Metrics::GetDefault()->Gauge("aquarium_memory_container_bytes",
+            "Bytes of item lists and per-fish arrays");
+    static auto &xml = Metrics::GetDefault()->Gauge("aquarium_memory_xml_bytes",
+            "Bytes of the largest XML document saved or loaded");
+
+    auto usage = mHost->GetMemoryUsage();
+    pixels.Set((double)usage.mPixels);
+    items.Set((double)usage.mItems);
+    containers.Set((double)usage.mContainers);
+    xml.Set((double)usage.mXml);
+    return usage;
+}
+
+/**
+ * Menu handler for File > New Tank
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnNewTank(wxCommandEvent& event)
+{
+    AddTank();
+    UpdateMenus();
+    Wake();
+}
+
+/**
+ * Menu handler for File > Save Metrics
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnSaveMetrics(wxCommandEvent& event)
+{
+    wxFileDialog metricsFileDialog(this, L"Save Metrics", L"", L"",
+            L"Prometheus Metrics (*.prom)|*.prom", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (metricsFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    if (!Metrics::GetDefault()->Dump(metricsFileDialog.GetPath().ToStdString()))
+    {
+        wxMessageBox(L"Unable to write the metrics file");
+    }
+}
+
+/**
+ * Menu handler for Simulation > Memory Budget
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnMemoryBudget(wxCommandEvent& event)
+{
+    long megabytes = wxGetNumberFromUser(L"Megabytes each tank's items may use before it stops adding more,\n0 for no limit:",
+            L"Megabytes", L"Memory Budget", (long)(mHost->GetMemoryBudget() / Megabyte), 0, 1024 * 1024, this);
+    if (megabytes < 0)
+    {
+        return;
+    }
+
+    mHost->SetMemoryBudget((size_t)(megabytes * Megabyte));
+}
+
+/**
+ * Menu handler for Simulation > Image Budget
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnImageBudget(wxCommandEvent& event)
+{
+    long megabytes = wxGetNumberFromUser(L"Megabytes the images may use before small items are drawn as points,\n0 for no limit:",
+            L"Megabytes", L"Image Budget", (long)(mHost->GetPixelBudget() / Megabyte), 0, 1024 * 1024, this);
+    if (megabytes < 0)
+    {
+        return;
+    }
+
+    mHost->SetPixelBudget((size_t)(megabytes * Megabyte));
+}
+
+/**
+ * Menu handler for Simulation > Frame Rate
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnFrameRate(wxCommandEvent& event)
+{
+    mPacer.SetTargetRate(FrameRates[event.GetId() - IDM_FRAMERATE]);
+}
+
+/**
+ * Pass menu events on to the view of the tank that is showing.
+ *
+ * The views don't bind the frame's menus themselves, or every
+ * tank would act on every menu selection.
+ *
+ * @param event The wxCommandEvent triggered by the menu
+ */
+void MainFrame::OnViewMenu(wxCommandEvent& event)
+{
+    auto view = GetView();
+    if (view == nullptr || !view->ProcessWindowEventLocally(event))
+    {
+        event.Skip();
+        return;
+    }
+
+    // The menu may have added something that moves, or unpaused
+    Wake();
+}
+
+/**
+ * Handle a different tank being shown
+ * @param event Notebook event
+ */
+void MainFrame::OnPageChanged(wxBookCtrlEvent& event)
+{
+    UpdateMenus();
+    mStatusTime = 0;
+    event.Skip();
 }
 
 /**
@@ -48,39 +525,88 @@ void MainFrame::CreateMenu()
 
     // Create File, Add Fish, Add Decor, and Help menus
     auto fileMenu = new wxMenu();
-    auto fishMenu = new wxMenu();
-    auto decorMenu = new wxMenu();
+    mFishMenu = new wxMenu();
+    mDecorMenu = new wxMenu();
+    auto behaviorMenu = new wxMenu();
+    auto viewMenu = new wxMenu();
+    auto simulationMenu = new wxMenu();
+    auto speedMenu = new wxMenu();
+    auto frameRateMenu = new wxMenu();
     auto helpMenu = new wxMenu();
 
-    // Add "Save As" and "Exit" options to the File menu
+    // Add "New Tank", "Save As" and "Exit" options to the File menu
+    fileMenu->Append(IDM_NEWTANK, L"&New Tank\tCtrl-N", L"Add another aquarium in a new tab");
     fileMenu->Append(wxID_SAVEAS, L"Save &As...\tCtrl-S", L"Save aquarium as...");
+    fileMenu->Append(IDM_SAVEMETRICS, L"Save &Metrics...", L"Write the health counters to a file in the Prometheus format");
     fileMenu->Append(wxID_EXIT, L"E&xit\tAlt-X", L"Quit this program");
 
-    // Add fish options to the Add Fish menu
-    fishMenu->Append(IDM_ADDFISHBETA, L"&Beta Fish", L"Add a Beta Fish");
-    fishMenu->Append(IDM_ADDFISHNEMO, L"&Nemo Fish", L"Add a Nemo Fish");
-    fishMenu->Append(IDM_ADDFISHGOLDEEN, L"&Goldeen Fish", L"Add a Goldeen Fish");
 	fileMenu->Append(wxID_OPEN, L"Open &File...\tCtrl-F", L"Open aquarium file...");
 
-    // Add decor options to the Add Decor menu
-    decorMenu->Append(IDM_ADDDECORCASTLE, L"&Castle Decor", L"Add a Castle");
+    // Add the schooling toggle to the Behavior menu
+    behaviorMenu->AppendCheckItem(IDM_SCHOOLING, L"&Schooling", L"Fish school together with their own species");
+
+    // Add zoom options to the View menu
+    viewMenu->Append(IDM_ZOOMIN, L"Zoom &In\tCtrl-+", L"Zoom in on the aquarium");
+    viewMenu->Append(IDM_ZOOMOUT, L"Zoom &Out\tCtrl--", L"Zoom out from the aquarium");
+    viewMenu->Append(IDM_ZOOMRESET, L"&Actual Size\tCtrl-0", L"Show the aquarium at its natural size");
+    viewMenu->AppendSeparator();
+    viewMenu->AppendCheckItem(IDM_PUBLISHFRAMES, L"&Publish Frames",
+            L"Publish every frame to shared memory for other programs to read");
+
+    // Add time controls to the Simulation menu
+    simulationMenu->AppendCheckItem(IDM_PAUSE, L"&Pause\tCtrl-P", L"Stop the simulation clock");
+    simulationMenu->Append(IDM_STEP, L"S&tep\tCtrl-T", L"Advance a paused simulation by one frame");
+    for (int i = 0; i < AquariumView::SpeedCount; i++)
+    {
+        auto item = speedMenu->AppendRadioItem(IDM_SPEED + i,
+                wxString::Format(L"%gx", AquariumView::Speeds[i]), L"Set the simulation speed");
+        item->Check(AquariumView::Speeds[i] == 1);
+    }
+    simulationMenu->AppendSubMenu(speedMenu, L"&Speed");
+    simulationMenu->Append(IDM_FASTFORWARD, L"&Fast Forward...", L"Run the simulation ahead without drawing");
+    for (int i = 0; i < FrameRateCount && IDM_FRAMERATE + i <= IDM_FRAMERATELAST; i++)
+    {
+        auto item = frameRateMenu->AppendRadioItem(IDM_FRAMERATE + i,
+                wxString::Format(L"%d fps", FrameRates[i]), L"Set the frame rate to aim for");
+        item->Check(FrameRates[i] == DefaultFrameRate);
+    }
+    simulationMenu->AppendSubMenu(frameRateMenu, L"F&rame Rate");
+    simulationMenu->Append(IDM_MEMORYBUDGET, L"&Memory Budget...", L"Limit the memory each tank's items may use");
+    simulationMenu->Append(IDM_IMAGEBUDGET, L"&Image Budget...", L"Limit the memory the images may use at full detail");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(IDM_RECORD, L"&Record Session...", L"Start a new session and record it to a trace file");
+    simulationMenu->Append(IDM_STOPRECORDING, L"St&op Recording", L"Finish the trace being recorded");
+    simulationMenu->Append(IDM_REPLAY, L"Re&play Session...", L"Replay a trace and check it matches the recording");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(IDM_EXPORTVIDEO, L"&Export Video...", L"Render the simulation to a PNG sequence or Y4M video");
 
     // Add "About" option to the Help menu
     helpMenu->Append(wxID_ABOUT, L"&About\tF1", L"Show about dialog");
 
     // Append the menus to the menu bar
     menuBar->Append(fileMenu, L"&File");
-    menuBar->Append(fishMenu, L"&Add Fish");
-    menuBar->Append(decorMenu, L"&Add Decor");
+    menuBar->Append(mFishMenu, L"&Add Fish");
+    menuBar->Append(mDecorMenu, L"&Add Decor");
+    menuBar->Append(behaviorMenu, L"&Behavior");
+    menuBar->Append(viewMenu, L"&View");
+    menuBar->Append(simulationMenu, L"&Simulation");
     menuBar->Append(helpMenu, L"&Help");
 
     // Set the menu bar for the main frame
     SetMenuBar(menuBar);
 
+    // Fill the Add menus, and the checks, from the tank showing
+    UpdateMenus();
+
     // Bind the menu events to their corresponding event handlers
     Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnExit, this, wxID_EXIT);
     Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAbout, this, wxID_ABOUT);
-	Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileOpen, mAquariumView, wxID_OPEN);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnNewTank, this, IDM_NEWTANK);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnSaveMetrics, this, IDM_SAVEMETRICS);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnFrameRate, this, IDM_FRAMERATE, IDM_FRAMERATELAST);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnMemoryBudget, this, IDM_MEMORYBUDGET);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnImageBudget, this, IDM_IMAGEBUDGET);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnViewMenu, this);
 }
 
 /**
@@ -7,28 +7,119 @@
 #ifndef _MAINFRAME_H_
 #define _MAINFRAME_H_
 
+#include <memory>
+#include <wx/fswatcher.h>
+#include <wx/notebook.h>
+#include "FramePacer.h"
+
 class AquariumView;
+class AssetLoader;
+class ControlServer;
+class SpeciesRegistry;
+class TankHost;
+struct MemoryUsage;
 
 /**
  * The top-level (main) frame of the application
+ *
+ * Each tab shows one of the tanks the host runs. The menus act
+ * on whichever tank is showing.
  */
 class MainFrame : public wxFrame
 {
 private:
-    /// View class for our aquarium
-    AquariumView *mAquariumView;
+    /// The tanks
+    std::shared_ptr<TankHost> mHost;
+
+    /// One page per tank
+    wxNotebook *mNotebook = nullptr;
+
+    /// Drives the simulation and repainting, one frame at a time
+    wxTimer mTimer;
+
+    /// Decides when the timer fires next
+    FramePacer mPacer;
+
+    /// Stopwatch used to time the species file settling
+    wxStopWatch mStopWatch;
+
+    /// Images still loading in the background, or nullptr once they are all in
+    std::shared_ptr<AssetLoader> mAssets;
+
+    /// Watches the species data file for edits
+    std::unique_ptr<wxFileSystemWatcher> mWatcher;
+
+    /// Name of the species data file within the watched directory
+    wxString mSpeciesFile;
+
+    /// True if the species file has changed and not been reloaded yet
+    bool mSpeciesChanged = false;
+
+    /// Stopwatch time of the last change to the species file
+    long mSpeciesChangedTime = 0;
+
+    /// Stopwatch time the CPU time in the status bar was last updated
+    long mStatusTime = 0;
+
+    /// Server for the control API, or nullptr if it isn't enabled
+    std::unique_ptr<ControlServer> mControl;
+
+    /// Stopwatch time the control API status was last published
+    long mControlTime = 0;
+
+    /// The Add Fish menu
+    wxMenu *mFishMenu = nullptr;
+
+    /// The Add Decor menu
+    wxMenu *mDecorMenu = nullptr;
+
+    /// Registry the Add menus were last filled from
+    const SpeciesRegistry *mMenuSpecies = nullptr;
+
+    /// Version of that registry when they were filled
+    uint64_t mMenuVersion = 0;
 
 	void CreateMenu();
 
+	AquariumView *GetView();
+
+	void AddTank();
+
+	void UpdateMenus();
+
+	void UpdateAddMenus(const SpeciesRegistry &registry);
+
+	void WatchSpecies();
+
+	void StartControlServer();
+
+	void RunFrame();
+
+	MemoryUsage ReportMemory();
+
+	void Wake();
+
 	/// Event handler for the "Exit" menu item
 	void OnExit(wxCommandEvent& event);
 
 	/// Event handler for the "About" menu item
 	void OnAbout(wxCommandEvent& event);
 
-
+	void OnNewTank(wxCommandEvent& event);
+	void OnSaveMetrics(wxCommandEvent& event);
+	void OnFrameRate(wxCommandEvent& event);
+	void OnMemoryBudget(wxCommandEvent& event);
+	void OnImageBudget(wxCommandEvent& event);
+	void OnViewMenu(wxCommandEvent& event);
+	void OnPageChanged(wxBookCtrlEvent& event);
+	void OnTimer(wxTimerEvent& event);
+	void OnSpeciesFileChanged(wxFileSystemWatcherEvent& event);
 
 public:
+    MainFrame();
+
+    virtual ~MainFrame();
+
     void Initialize();
 };
 
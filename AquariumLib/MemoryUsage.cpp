@@ -0,0 +1,38 @@
+/**
+ * @file MemoryUsage.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "MemoryUsage.h"
+
+using namespace std;
+
+/**
+ * Estimate the bytes an XML node, the nodes after it and
+ * everything under them hold.
+ *
+ * Counts each node and attribute object and the characters of
+ * their names, values and content. Pass a document's root to
+ * size the whole document.
+ *
+ * @param node First node, or nullptr
+ * @return Size in bytes
+ */
+size_t MemoryUsage::XmlBytes(const wxXmlNode *node)
+{
+    size_t bytes = 0;
+    for (; node != nullptr; node = node->GetNext())
+    {
+        bytes += sizeof(wxXmlNode) + (node->GetName().length() + node->GetContent().length()) * sizeof(wxChar);
+        for (auto attribute = node->GetAttributes(); attribute != nullptr; attribute = attribute->GetNext())
+        {
+            bytes += sizeof(wxXmlAttribute) +
+                    (attribute->GetName().length() + attribute->GetValue().length()) * sizeof(wxChar);
+        }
+
+        bytes += XmlBytes(node->GetChildren());
+    }
+
+    return bytes;
+}
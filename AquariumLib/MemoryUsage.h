@@ -0,0 +1,71 @@
+/**
+ * @file MemoryUsage.h
+ * @author Ismail Abdi
+ *
+ * Bytes an aquarium is using, by what they are used for.
+ */
+
+#ifndef AQUARIUM_MEMORYUSAGE_H
+#define AQUARIUM_MEMORYUSAGE_H
+
+#include <cstddef>
+#include <vector>
+
+class wxXmlNode;
+
+/**
+ * Bytes an aquarium is using, by what they are used for.
+ *
+ * The sizes are estimates from what the objects hold, not from
+ * the allocator, so they leave out allocator overhead and
+ * anything wxWidgets keeps privately. They are close enough to
+ * see what grows with the number of fish and what doesn't.
+ */
+struct MemoryUsage {
+    /// Estimated bytes make_shared puts with each object for its reference counts
+    static const size_t SharedCountBytes = sizeof(void *) + 2 * sizeof(int);
+
+    /// Decoded images, bitmaps and opacity masks
+    size_t mPixels = 0;
+
+    /// The item objects themselves
+    size_t mItems = 0;
+
+    /// Lists of items and the per-fish arrays built from them, including unused capacity
+    size_t mContainers = 0;
+
+    /// XML text and document tree of the largest save or load so far
+    size_t mXml = 0;
+
+    /**
+     * Total of every category
+     * @return Size in bytes
+     */
+    size_t GetTotal() const { return mPixels + mItems + mContainers + mXml; }
+
+    /**
+     * Add the usage of something else to this
+     * @param other Usage to add
+     * @return This usage
+     */
+    MemoryUsage &operator+=(const MemoryUsage &other)
+    {
+        mPixels += other.mPixels;
+        mItems += other.mItems;
+        mContainers += other.mContainers;
+        mXml += other.mXml;
+        return *this;
+    }
+
+    /**
+     * Bytes a vector has allocated, used or not
+     * @param vector Vector
+     * @return Size in bytes
+     */
+    template <class T>
+    static size_t Capacity(const std::vector<T> &vector) { return vector.capacity() * sizeof(T); }
+
+    static size_t XmlBytes(const wxXmlNode *node);
+};
+
+#endif //AQUARIUM_MEMORYUSAGE_H
@@ -0,0 +1,269 @@
+/**
+ * @file Metrics.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+
+const std::vector<double> Metrics::TimeBuckets =
+        {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1};
+
+/**
+ * Format a number the way Prometheus reads it
+ * @param value Number
+ * @return Text of the number
+ */
+static string Number(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.10g", value);
+    return text;
+}
+
+/**
+ * Constructor
+ * @param bounds Upper bound of each bucket, in increasing order
+ */
+MetricHistogram::MetricHistogram(const std::vector<double> &bounds) :
+    mBounds(bounds), mBuckets(new atomic<uint64_t>[bounds.size() + 1])
+{
+    for (size_t i = 0; i <= mBounds.size(); i++)
+    {
+        mBuckets[i] = 0;
+    }
+}
+
+/**
+ * Add an observation
+ * @param value Value observed
+ */
+void MetricHistogram::Observe(double value)
+{
+    // Buckets include their upper bound
+    size_t bucket = lower_bound(mBounds.begin(), mBounds.end(), value) - mBounds.begin();
+    mBuckets[bucket].fetch_add(1, memory_order_relaxed);
+    mCount.fetch_add(1, memory_order_relaxed);
+
+    double sum = mSum.load(memory_order_relaxed);
+    while (!mSum.compare_exchange_weak(sum, sum + value, memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * Number of observations at or below a bucket's bound
+ * @param bucket Bucket index. The one past the last bound counts everything.
+ * @return Cumulative count
+ */
+uint64_t MetricHistogram::GetCumulative(size_t bucket) const
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i <= bucket && i <= mBounds.size(); i++)
+    {
+        count += mBuckets[i].load(memory_order_relaxed);
+    }
+
+    return count;
+}
+
+/**
+ * Find a series of a metric, registering it if it is new. The
+ * series of a metric are kept together, as Prometheus wants them.
+ * @param name Metric name
+ * @param help Description, used if it is new
+ * @param labels Labels of the series, or empty for none
+ * @return The series' entry
+ */
+Metrics::Entry &Metrics::Find(const std::string &name, const std::string &help, const std::string &labels)
+{
+    auto at = mEntries.end();
+    for (auto entry = mEntries.begin(); entry != mEntries.end(); ++entry)
+    {
+        if ((*entry)->mName == name)
+        {
+            if ((*entry)->mLabels == labels)
+            {
+                return **entry;
+            }
+
+            at = entry + 1;
+        }
+    }
+
+    auto entry = make_unique<Entry>();
+    entry->mName = name;
+    entry->mLabels = labels;
+    entry->mHelp = help;
+    return **mEntries.insert(at, move(entry));
+}
+
+/**
+ * Get a counter, registering it the first time
+ * @param name Metric name, ending in _total by convention
+ * @param help Description
+ * @param labels Labels of the series, or empty for none
+ * @return The counter
+ */
+MetricCounter &Metrics::Counter(const std::string &name, const std::string &help, const std::string &labels)
+{
+    lock_guard<mutex> lock(mMutex);
+    auto &entry = Find(name, help, labels);
+    if (entry.mCounter == nullptr)
+    {
+        entry.mCounter = make_unique<MetricCounter>();
+    }
+
+    return *entry.mCounter;
+}
+
+/**
+ * Get a gauge, registering it the first time
+ * @param name Metric name
+ * @param help Description
+ * @param labels Labels of the series, or empty for none
+ * @return The gauge
+ */
+MetricGauge &Metrics::Gauge(const std::string &name, const std::string &help, const std::string &labels)
+{
+    lock_guard<mutex> lock(mMutex);
+    auto &entry = Find(name, help, labels);
+    if (entry.mGauge == nullptr)
+    {
+        entry.mGauge = make_unique<MetricGauge>();
+    }
+
+    return *entry.mGauge;
+}
+
+/**
+ * Get a histogram, registering it the first time
+ * @param name Metric name
+ * @param help Description
+ * @param bounds Bucket bounds, used if it is new
+ * @param labels Labels of the series, or empty for none
+ * @return The histogram
+ */
+MetricHistogram &Metrics::Histogram(const std::string &name, const std::string &help, const std::vector<double> &bounds,
+        const std::string &labels)
+{
+    lock_guard<mutex> lock(mMutex);
+    auto &entry = Find(name, help, labels);
+    if (entry.mHistogram == nullptr)
+    {
+        entry.mHistogram = make_unique<MetricHistogram>(bounds);
+    }
+
+    return *entry.mHistogram;
+}
+
+/**
+ * Write every metric in the Prometheus text exposition format
+ * @return The text
+ */
+std::string Metrics::ToPrometheus() const
+{
+    lock_guard<mutex> lock(mMutex);
+
+    string text;
+    const string *family = nullptr;
+    for (auto &entry : mEntries)
+    {
+        // Help and type once for all the series of a metric
+        auto &name = entry->mName;
+        bool first = family == nullptr || *family != name;
+        family = &name;
+        if (first)
+        {
+            text += "# HELP " + name + " " + entry->mHelp + "\n";
+        }
+
+        auto &labels = entry->mLabels;
+        auto series = labels.empty() ? name : name + "{" + labels + "}";
+        if (entry->mCounter != nullptr)
+        {
+            text += first ? "# TYPE " + name + " counter\n" : "";
+            text += series + " " + to_string(entry->mCounter->Get()) + "\n";
+        }
+        else if (entry->mGauge != nullptr)
+        {
+            text += first ? "# TYPE " + name + " gauge\n" : "";
+            text += series + " " + Number(entry->mGauge->Get()) + "\n";
+        }
+        else if (entry->mHistogram != nullptr)
+        {
+            auto &histogram = *entry->mHistogram;
+            auto &bounds = histogram.GetBounds();
+            auto bucket = name + "_bucket{" + (labels.empty() ? "" : labels + ",") + "le=\"";
+            auto suffix = labels.empty() ? " " : "{" + labels + "} ";
+            text += first ? "# TYPE " + name + " histogram\n" : "";
+            for (size_t i = 0; i < bounds.size(); i++)
+            {
+                text += bucket + Number(bounds[i]) + "\"} " + to_string(histogram.GetCumulative(i)) + "\n";
+            }
+
+            text += bucket + "+Inf\"} " + to_string(histogram.GetCumulative(bounds.size())) + "\n";
+            text += name + "_sum" + suffix + Number(histogram.GetSum()) + "\n";
+            text += name + "_count" + suffix + to_string(histogram.GetCount()) + "\n";
+        }
+    }
+
+    return text;
+}
+
+/**
+ * Make a label for a series, escaping the value as Prometheus wants
+ * @param name Label name
+ * @param value Label value
+ * @return The label, like tank="2"
+ */
+std::string Metrics::Label(const std::string &name, const std::string &value)
+{
+    string label = name + "=\"";
+    for (auto c : value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            label += '\\';
+            label += c;
+        }
+        else if (c == '\n')
+        {
+            label += "\\n";
+        }
+        else
+        {
+            label += c;
+        }
+    }
+
+    return label + "\"";
+}
+
+/**
+ * Write every metric to a file in the Prometheus text format
+ * @param filename File to write
+ * @return False if the file couldn't be written
+ */
+bool Metrics::Dump(const std::string &filename) const
+{
+    ofstream file(filename, ios::binary);
+    file << ToPrometheus();
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * Get the process-wide registry everything reports to
+ * @return The default registry
+ */
+std::shared_ptr<Metrics> Metrics::GetDefault()
+{
+    static auto metrics = make_shared<Metrics>();
+    return metrics;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file Metrics.h
+ * @author Ismail Abdi
+ *
+ * Counters, gauges and histograms for keeping an eye on a running aquarium.
+ */
+
+#ifndef AQUARIUM_METRICS_H
+#define AQUARIUM_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * A count that only goes up.
+ */
+class MetricCounter {
+private:
+    /// The count
+    std::atomic<uint64_t> mValue{0};
+
+public:
+    /**
+     * Add to the count
+     * @param count Amount to add
+     */
+    void Add(uint64_t count = 1) { mValue.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * Get the count
+     * @return Count so far
+     */
+    uint64_t Get() const { return mValue.load(std::memory_order_relaxed); }
+};
+
+/**
+ * A value that can go up and down.
+ */
+class MetricGauge {
+private:
+    /// The value
+    std::atomic<double> mValue{0};
+
+public:
+    /**
+     * Set the value
+     * @param value New value
+     */
+    void Set(double value) { mValue.store(value, std::memory_order_relaxed); }
+
+    /**
+     * Get the value
+     * @return Current value
+     */
+    double Get() const { return mValue.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Counts of observations falling into fixed buckets.
+ */
+class MetricHistogram {
+private:
+    /// Upper bound of each bucket, in increasing order
+    std::vector<double> mBounds;
+
+    /// Observations in each bucket, with one more for anything above the last bound
+    std::unique_ptr<std::atomic<uint64_t>[]> mBuckets;
+
+    /// Number of observations
+    std::atomic<uint64_t> mCount{0};
+
+    /// Total of the observations
+    std::atomic<double> mSum{0};
+
+public:
+    explicit MetricHistogram(const std::vector<double> &bounds);
+
+    void Observe(double value);
+
+    /**
+     * Get the bucket bounds
+     * @return Upper bound of each bucket
+     */
+    const std::vector<double> &GetBounds() const { return mBounds; }
+
+    uint64_t GetCumulative(size_t bucket) const;
+
+    /**
+     * Number of observations
+     * @return Observation count
+     */
+    uint64_t GetCount() const { return mCount.load(std::memory_order_relaxed); }
+
+    /**
+     * Total of the observations
+     * @return Sum
+     */
+    double GetSum() const { return mSum.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Observes the time from its construction to its
+ * destruction in a histogram, in seconds.
+ */
+class MetricTimer {
+private:
+    /// Histogram to observe the time in
+    MetricHistogram &mHistogram;
+
+    /// When the timer was made
+    std::chrono::steady_clock::time_point mStart;
+
+public:
+    /**
+     * Constructor. Starts timing.
+     * @param histogram Histogram to observe the time in
+     */
+    explicit MetricTimer(MetricHistogram &histogram) :
+        mHistogram(histogram), mStart(std::chrono::steady_clock::now()) {}
+
+    /**
+     * Destructor. Observes the time.
+     */
+    ~MetricTimer()
+    {
+        mHistogram.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count());
+    }
+
+    /// Copy constructor (disabled)
+    MetricTimer(const MetricTimer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const MetricTimer &) = delete;
+};
+
+/**
+ * Counters, gauges and histograms for keeping an eye on a running aquarium.
+ *
+ * Metrics are registered by name the first time they are asked for
+ * and live as long as the registry, so code that updates one keeps a
+ * reference to it, usually in a function static:
+ *
+ *     static auto &updates = Metrics::GetDefault()->Counter("aquarium_updates_total", "...");
+ *     updates.Add();
+ *
+ * After that, updating a metric is a relaxed atomic operation with no
+ * locking, so they can be used on the hot paths and from the tank
+ * update threads. The registry writes them in the Prometheus text
+ * format for the control API's /metrics, or to a file.
+ *
+ * A metric can have several series told apart by labels, such as
+ * one for each tank. Each series is registered on its own with its
+ * labels in Prometheus form, like tank="2", and kept by whatever
+ * it measures instead of in a function static.
+ */
+class Metrics {
+private:
+    /// One registered metric
+    struct Entry {
+        /// Metric name
+        std::string mName;
+
+        /// Labels of this series, like tank="2", or empty for none
+        std::string mLabels;
+
+        /// Description
+        std::string mHelp;
+
+        /// The metric if it is a counter
+        std::unique_ptr<MetricCounter> mCounter;
+
+        /// The metric if it is a gauge
+        std::unique_ptr<MetricGauge> mGauge;
+
+        /// The metric if it is a histogram
+        std::unique_ptr<MetricHistogram> mHistogram;
+    };
+
+    /// Metrics in the order they were registered
+    std::vector<std::unique_ptr<Entry>> mEntries;
+
+    /// Protects mEntries
+    mutable std::mutex mMutex;
+
+    Entry &Find(const std::string &name, const std::string &help, const std::string &labels);
+
+public:
+    /// Bucket bounds for times in seconds, from 100 us to 1 s
+    static const std::vector<double> TimeBuckets;
+
+    Metrics() {}
+
+    /// Copy constructor (disabled)
+    Metrics(const Metrics &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const Metrics &) = delete;
+
+    MetricCounter &Counter(const std::string &name, const std::string &help, const std::string &labels = "");
+
+    MetricGauge &Gauge(const std::string &name, const std::string &help, const std::string &labels = "");
+
+    MetricHistogram &Histogram(const std::string &name, const std::string &help,
+            const std::vector<double> &bounds = TimeBuckets, const std::string &labels = "");
+
+    static std::string Label(const std::string &name, const std::string &value);
+
+    std::string ToPrometheus() const;
+
+    bool Dump(const std::string &filename) const;
+
+    static std::shared_ptr<Metrics> GetDefault();
+};
+
+#endif //AQUARIUM_METRICS_H
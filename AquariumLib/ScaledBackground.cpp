@@ -0,0 +1,203 @@
+/**
+ * @file ScaledBackground.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "ScaledBackground.h"
+#include "Sprite.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param sprite The background image
+ * @param pool Pool to scale the image on
+ */
+ScaledBackground::ScaledBackground(std::shared_ptr<Sprite> sprite, std::shared_ptr<ThreadPool> pool) :
+    mSprite(sprite), mPool(pool)
+{
+}
+
+/**
+ * Destructor. Waits for the worker, since it uses this object.
+ */
+ScaledBackground::~ScaledBackground()
+{
+    Wait();
+}
+
+/**
+ * Get the background scaled to a size.
+ *
+ * If there is no copy at that size yet, one is started on a
+ * worker thread and this returns nullptr. Asking again for the
+ * same size while it is being made doesn't start another one.
+ *
+ * @param width Width on screen
+ * @param height Height on screen
+ * @return Bitmap at exactly that size, or nullptr if it isn't ready
+ */
+wxBitmap *ScaledBackground::GetBitmap(int width, int height)
+{
+    if (mBitmap != nullptr && mBitmap->GetWidth() == width && mBitmap->GetHeight() == height)
+    {
+        return mBitmap.get();
+    }
+
+    unique_ptr<wxImage> scaled;
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mScaled != nullptr && mScaled->GetWidth() == width && mScaled->GetHeight() == height)
+        {
+            scaled = move(mScaled);
+        }
+        else
+        {
+            mScaled = nullptr;
+            mWantedWidth = width;
+            mWantedHeight = height;
+            if (!mScaling)
+            {
+                mScaling = true;
+                mPool->Submit([this] { Scale(); });
+            }
+        }
+    }
+
+    if (scaled == nullptr)
+    {
+        return nullptr;
+    }
+
+    mBitmap = make_unique<wxBitmap>(*scaled);
+    return mBitmap.get();
+}
+
+/**
+ * Body of the scaling task. Keeps going until it has made a
+ * copy at the size most recently asked for.
+ */
+void ScaledBackground::Scale()
+{
+    // Shared with every other user of the sprite, and only read
+    const wxImage &source = *mSprite->GetImage();
+
+    unique_lock<mutex> lock(mMutex);
+    for (;;)
+    {
+        int width = mWantedWidth;
+        int height = mWantedHeight;
+        lock.unlock();
+
+        unique_ptr<wxImage> scaled;
+        if (source.IsOk())
+        {
+            scaled = make_unique<wxImage>(source.Scale(width, height, wxIMAGE_QUALITY_HIGH));
+        }
+
+        lock.lock();
+        if (width == mWantedWidth && height == mWantedHeight)
+        {
+            mScaled = move(scaled);
+            mScaleCount++;
+            mScaling = false;
+            mIdle.notify_all();
+            return;
+        }
+    }
+}
+
+/**
+ * Draw the background filling a rectangle.
+ *
+ * Uses the scaled copy if it is ready. If not, stretches the last
+ * copy made, or the sprite itself, so the window never waits.
+ *
+ * @param dc Device context to draw on
+ * @param left Screen X of the left edge
+ * @param top Screen Y of the top edge
+ * @param width Screen width
+ * @param height Screen height
+ * @return False if a stand-in was drawn because the image isn't ready yet
+ */
+bool ScaledBackground::Draw(wxDC *dc, double left, double top, int width, int height)
+{
+    // Nothing to draw if the image couldn't be loaded
+    if (width <= 0 || height <= 0 || (mSprite->IsReady() && mSprite->GetWidth() == 0))
+    {
+        return true;
+    }
+
+    // Drawn at its own size there is nothing to scale
+    if (width == mSprite->GetWidth() && height == mSprite->GetHeight())
+    {
+        mSprite->Draw(dc, false, left, top, 1);
+        return mSprite->IsReady();
+    }
+
+    auto bitmap = GetBitmap(width, height);
+    if (bitmap != nullptr)
+    {
+        dc->DrawBitmap(*bitmap, (int)left, (int)top);
+        return true;
+    }
+
+    if (mBitmap == nullptr)
+    {
+        mSprite->Stretch(dc, false, left, top, width, height);
+        return false;
+    }
+
+    // Stretch on top of the caller's scale, then put theirs back
+    double scaleX = (double)width / mBitmap->GetWidth();
+    double scaleY = (double)height / mBitmap->GetHeight();
+    double userX, userY;
+    dc->GetUserScale(&userX, &userY);
+    dc->SetUserScale(userX * scaleX, userY * scaleY);
+    dc->DrawBitmap(*mBitmap, (int)(left / scaleX), (int)(top / scaleY));
+    dc->SetUserScale(userX, userY);
+    return false;
+}
+
+/**
+ * Wait for any scaling in progress to finish
+ */
+void ScaledBackground::Wait()
+{
+    unique_lock<mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return !mScaling; });
+}
+
+/**
+ * Number of scaled copies made so far
+ * @return Scale count
+ */
+int ScaledBackground::GetScaleCount()
+{
+    lock_guard<mutex> lock(mMutex);
+    return mScaleCount;
+}
+
+/**
+ * Memory used by the scaled copies, not counting the image they
+ * are scaled from, which is a sprite. Call on the GUI thread.
+ * @return Size in bytes
+ */
+size_t ScaledBackground::GetByteSize()
+{
+    size_t bytes = 0;
+    if (mBitmap != nullptr)
+    {
+        bytes += (size_t)mBitmap->GetWidth() * mBitmap->GetHeight() * 4;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    if (mScaled != nullptr)
+    {
+        bytes += (size_t)mScaled->GetWidth() * mScaled->GetHeight() * 3;
+    }
+
+    return bytes;
+}
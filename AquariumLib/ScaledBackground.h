@@ -0,0 +1,94 @@
+/**
+ * @file ScaledBackground.h
+ * @author Ismail Abdi
+ *
+ * A background image scaled to fill the tank on screen.
+ */
+
+#ifndef AQUARIUM_SCALEDBACKGROUND_H
+#define AQUARIUM_SCALEDBACKGROUND_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+class Sprite;
+class ThreadPool;
+
+/**
+ * A background image scaled to fill the tank on screen.
+ *
+ * Scaling a background to a 4K or 8K window with a good filter
+ * takes far too long to do every frame, so the scaled copy is
+ * made once on a worker thread whenever the size on screen
+ * changes, and kept. Until it is ready the old copy, or the
+ * sprite's nearest mip level, is stretched by the DC instead.
+ *
+ * The worker scales from the sprite's own full size image, which
+ * nothing changes once it is decoded, so every tank showing the
+ * same background shares one decoded copy. Bitmaps are only made
+ * on the GUI thread.
+ */
+class ScaledBackground {
+private:
+    /// The background image
+    std::shared_ptr<Sprite> mSprite;
+
+    /// Pool the scaling runs on
+    std::shared_ptr<ThreadPool> mPool;
+
+    /// The most recent scaled copy. Only used on the GUI thread.
+    std::unique_ptr<wxBitmap> mBitmap;
+
+    /// Size the background is wanted at
+    int mWantedWidth = 0;
+
+    /// Size the background is wanted at
+    int mWantedHeight = 0;
+
+    /// A scaled image the worker has finished and the GUI thread hasn't taken yet
+    std::unique_ptr<wxImage> mScaled;
+
+    /// True while a scaling task is queued or running
+    bool mScaling = false;
+
+    /// Number of scaled copies made
+    int mScaleCount = 0;
+
+    /// Protects everything the worker and GUI thread share
+    std::mutex mMutex;
+
+    /// Signalled when the worker finishes
+    std::condition_variable mIdle;
+
+    void Scale();
+
+public:
+    ScaledBackground(std::shared_ptr<Sprite> sprite, std::shared_ptr<ThreadPool> pool);
+
+    virtual ~ScaledBackground();
+
+    /// Copy constructor (disabled)
+    ScaledBackground(const ScaledBackground &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ScaledBackground &) = delete;
+
+    /**
+     * Get the background image
+     * @return Sprite
+     */
+    std::shared_ptr<Sprite> GetSprite() const { return mSprite; }
+
+    wxBitmap *GetBitmap(int width, int height);
+
+    bool Draw(wxDC *dc, double left, double top, int width, int height);
+
+    void Wait();
+
+    int GetScaleCount();
+
+    size_t GetByteSize();
+};
+
+#endif //AQUARIUM_SCALEDBACKGROUND_H
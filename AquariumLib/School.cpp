@@ -0,0 +1,156 @@
+/**
+ * @file School.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "School.h"
+#include "Fish.h"
+#include "ThreadPool.h"
+#include "MemoryUsage.h"
+#include <cmath>
+
+using namespace std;
+
+/// Number of fish each parallel chunk steers
+const size_t SteerGrain = 256;
+
+/**
+ * Constructor
+ */
+School::School() : mPool(ThreadPool::GetDefault())
+{
+}
+
+/**
+ * Adjust the velocity of every fish for one tick of schooling.
+ * @param fish The fish to steer
+ * @param elapsed Time since the last tick in seconds
+ */
+void School::Steer(const std::vector<Fish *> &fish, double elapsed)
+{
+    size_t count = fish.size();
+    mX.resize(count);
+    mY.resize(count);
+    mSpeedX.resize(count);
+    mSpeedY.resize(count);
+    mParameters.resize(count);
+    mNewSpeedX.resize(count);
+    mNewSpeedY.resize(count);
+
+    double radius = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto f = fish[i];
+        mX[i] = f->GetX();
+        mY[i] = f->GetY();
+        mSpeedX[i] = f->GetSpeedX();
+        mSpeedY[i] = f->GetSpeedY();
+        mParameters[i] = &f->GetSchoolParameters();
+        radius = max(radius, mParameters[i]->mRadius);
+    }
+
+    mGrid.SetCellSize(radius);
+    mGrid.Build(mX, mY);
+
+    if (mPool != nullptr && count >= mParallelThreshold)
+    {
+        mPool->ParallelFor(count, SteerGrain, [this, elapsed](size_t begin, size_t end) {
+            SteerRange(begin, end, elapsed);
+        });
+    }
+    else
+    {
+        SteerRange(0, count, elapsed);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        fish[i]->SetSpeed(mNewSpeedX[i], mNewSpeedY[i]);
+    }
+}
+
+/**
+ * Compute new velocities for a range of the snapshot.
+ * @param begin First fish to steer
+ * @param end One past the last fish to steer
+ * @param elapsed Time since the last tick in seconds
+ */
+void School::SteerRange(size_t begin, size_t end, double elapsed)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        const SchoolParameters *params = mParameters[i];
+        double x = mX[i];
+        double y = mY[i];
+        double vx = mSpeedX[i];
+        double vy = mSpeedY[i];
+
+        double separationX = 0, separationY = 0;
+        double sumVX = 0, sumVY = 0;
+        double sumX = 0, sumY = 0;
+        int mates = 0;
+        double separation2 = params->mSeparationDistance * params->mSeparationDistance;
+
+        mGrid.ForEachNeighbor(x, y, params->mRadius,
+                [&](size_t j, double nx, double ny, double d2) {
+            if (j == i)
+            {
+                return;
+            }
+
+            if (d2 < separation2 && d2 > 0)
+            {
+                // Push away, harder the closer the neighbour is
+                separationX += (x - nx) / d2 * params->mSeparationDistance;
+                separationY += (y - ny) / d2 * params->mSeparationDistance;
+            }
+
+            if (mParameters[j] == params)
+            {
+                sumVX += mSpeedX[j];
+                sumVY += mSpeedY[j];
+                sumX += nx;
+                sumY += ny;
+                mates++;
+            }
+        });
+
+        double ax = separationX * params->mSeparation;
+        double ay = separationY * params->mSeparation;
+        if (mates > 0)
+        {
+            ax += (sumVX / mates - vx) * params->mAlignment + (sumX / mates - x) * params->mCohesion;
+            ay += (sumVY / mates - vy) * params->mAlignment + (sumY / mates - y) * params->mCohesion;
+        }
+
+        double nvx = vx + ax * elapsed;
+        double nvy = vy + ay * elapsed;
+
+        // Schooling changes the direction a fish swims, not how fast
+        double speed = sqrt(vx * vx + vy * vy);
+        double newSpeed = sqrt(nvx * nvx + nvy * nvy);
+        if (speed > 0 && newSpeed > 0)
+        {
+            nvx *= speed / newSpeed;
+            nvy *= speed / newSpeed;
+        }
+
+        mNewSpeedX[i] = nvx;
+        mNewSpeedY[i] = nvy;
+    }
+}
+
+/**
+ * Memory used by the per-fish arrays and the neighbour grid,
+ * including unused capacity
+ * @return Size in bytes
+ */
+size_t School::GetByteSize() const
+{
+    return MemoryUsage::Capacity(mX) + MemoryUsage::Capacity(mY) +
+            MemoryUsage::Capacity(mSpeedX) + MemoryUsage::Capacity(mSpeedY) +
+            MemoryUsage::Capacity(mParameters) +
+            MemoryUsage::Capacity(mNewSpeedX) + MemoryUsage::Capacity(mNewSpeedY) +
+            mGrid.GetByteSize();
+}
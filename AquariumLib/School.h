@@ -0,0 +1,101 @@
+/**
+ * @file School.h
+ * @author Ismail Abdi
+ *
+ * Boids-style schooling behaviour for the fish in an aquarium.
+ */
+
+#ifndef AQUARIUM_SCHOOL_H
+#define AQUARIUM_SCHOOL_H
+
+#include <memory>
+#include <vector>
+#include "SpatialGrid.h"
+
+class Fish;
+class ThreadPool;
+
+/**
+ * Per-species tuning for schooling.
+ *
+ * Fish only align with and move towards fish that share the
+ * same parameters object (their own species), but keep their
+ * distance from every fish.
+ */
+struct SchoolParameters {
+    /// Distance in pixels within which other fish are neighbours
+    double mRadius = 150;
+
+    /// Distance in pixels under which fish push apart
+    double mSeparationDistance = 60;
+
+    /// Weight of the push away from close fish
+    double mSeparation = 120;
+
+    /// Weight of matching the neighbours' velocity
+    double mAlignment = 1.0;
+
+    /// Weight of moving towards the neighbours' centre
+    double mCohesion = 0.4;
+};
+
+/**
+ * Boids-style schooling behaviour for the fish in an aquarium.
+ *
+ * Each call to Steer snapshots the fish into flat arrays, buckets
+ * them into a SpatialGrid and computes every fish's new velocity
+ * from the snapshot. Because nothing reads a velocity that has
+ * already been changed this tick, the result does not depend on
+ * how the work is split across threads.
+ */
+class School {
+private:
+    /// Neighbour search structure, rebuilt every tick
+    SpatialGrid mGrid;
+
+    /// Pool used to steer large schools in parallel
+    std::shared_ptr<ThreadPool> mPool;
+
+    /// Schools smaller than this are steered on the calling thread
+    size_t mParallelThreshold = 512;
+
+    // Snapshot of the fish being steered
+    std::vector<double> mX;         ///< X locations
+    std::vector<double> mY;         ///< Y locations
+    std::vector<double> mSpeedX;    ///< X speeds
+    std::vector<double> mSpeedY;    ///< Y speeds
+    std::vector<const SchoolParameters *> mParameters;  ///< Species of each fish
+
+    // Steering results
+    std::vector<double> mNewSpeedX; ///< New X speeds
+    std::vector<double> mNewSpeedY; ///< New Y speeds
+
+    void SteerRange(size_t begin, size_t end, double elapsed);
+
+public:
+    School();
+
+    /**
+     * Set the pool used for large schools
+     * @param pool Thread pool, or nullptr to always run on the calling thread
+     */
+    void SetThreadPool(std::shared_ptr<ThreadPool> pool) { mPool = pool; }
+
+    /**
+     * Set the school size at which steering goes parallel
+     * @param threshold Minimum fish count for parallel steering
+     */
+    void SetParallelThreshold(size_t threshold) { mParallelThreshold = threshold; }
+
+    void Steer(const std::vector<Fish *> &fish, double elapsed);
+
+    /**
+     * Get the neighbour grid built by the last Steer
+     * @return Spatial grid
+     */
+    const SpatialGrid &GetGrid() const { return mGrid; }
+
+    size_t GetByteSize() const;
+};
+
+#endif //AQUARIUM_SCHOOL_H
@@ -0,0 +1,174 @@
+/**
+ * @file ScriptRunner.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "ScriptRunner.h"
+#include "FishScripted.h"
+#include "SpeciesRegistry.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Get the script a fish runs
+ * @param fish Scripted fish
+ * @return Compiled script, or nullptr if its species has none
+ */
+static const BehaviorScript *ScriptOf(const FishScripted *fish)
+{
+    return fish->GetSpecies()->mProgram.get();
+}
+
+/**
+ * Find the scripted fish in a list of items and group them by
+ * script. Call again whenever the items or their species change.
+ * @param items Items in the aquarium
+ */
+void ScriptRunner::Group(const std::vector<std::shared_ptr<Item>> &items)
+{
+    mFish.clear();
+    mStarts.clear();
+    for (auto &item : items)
+    {
+        auto fish = dynamic_cast<FishScripted *>(item.get());
+        if (fish != nullptr && ScriptOf(fish) != nullptr)
+        {
+            mFish.push_back(fish);
+        }
+    }
+
+    // Group by script, keeping drawing order within a group
+    stable_sort(mFish.begin(), mFish.end(), [](const FishScripted *a, const FishScripted *b) {
+        return less<const BehaviorScript *>()(ScriptOf(a), ScriptOf(b));
+    });
+
+    for (size_t i = 0; i < mFish.size(); i++)
+    {
+        if (i == 0 || ScriptOf(mFish[i]) != ScriptOf(mFish[i - 1]))
+        {
+            mStarts.push_back(i);
+        }
+    }
+    mStarts.push_back(mFish.size());
+}
+
+/**
+ * Run the scripts of the fish found by the last Group
+ * @param time Simulated seconds since the aquarium was created
+ * @param elapsed Time elapsed since the last update
+ * @param width Tank width in pixels
+ * @param height Tank height in pixels
+ */
+void ScriptRunner::Run(double time, double elapsed, double width, double height)
+{
+    for (size_t g = 0; g + 1 < mStarts.size(); g++)
+    {
+        auto begin = mStarts[g];
+        auto end = mStarts[g + 1];
+        RunGroup(*ScriptOf(mFish[begin]), mFish.data() + begin, end - begin, time, elapsed, width, height);
+    }
+}
+
+/**
+ * Run a script over a group of fish and move them
+ * @param script Script the fish run
+ * @param fish The fish
+ * @param count Number of fish
+ * @param time Simulated seconds since the aquarium was created
+ * @param elapsed Time elapsed since the last update
+ * @param width Tank width in pixels
+ * @param height Tank height in pixels
+ */
+void ScriptRunner::RunGroup(const BehaviorScript &script, FishScripted *const *fish, size_t count,
+        double time, double elapsed, double width, double height)
+{
+    script.Prepare(mBatch, count);
+
+    fill_n(mBatch.Column(BehaviorScript::Time), count, time);
+    fill_n(mBatch.Column(BehaviorScript::Elapsed), count, elapsed);
+    fill_n(mBatch.Column(BehaviorScript::MoveX), count, 0.0);
+    fill_n(mBatch.Column(BehaviorScript::MoveY), count, 0.0);
+    fill_n(mBatch.Column(BehaviorScript::Width), count, width);
+    fill_n(mBatch.Column(BehaviorScript::Height), count, height);
+
+    auto x = mBatch.Column(BehaviorScript::X);
+    auto y = mBatch.Column(BehaviorScript::Y);
+    auto speedX = mBatch.Column(BehaviorScript::SpeedX);
+    auto speedY = mBatch.Column(BehaviorScript::SpeedY);
+    auto amplitude = mBatch.Column(BehaviorScript::Amplitude);
+    auto frequency = mBatch.Column(BehaviorScript::Frequency);
+    auto acceleration = mBatch.Column(BehaviorScript::Acceleration);
+    for (size_t i = 0; i < count; i++)
+    {
+        auto &species = *fish[i]->GetSpecies();
+        x[i] = fish[i]->GetX();
+        y[i] = fish[i]->GetY();
+        speedX[i] = fish[i]->GetSpeedX();
+        speedY[i] = fish[i]->GetSpeedY();
+        amplitude[i] = species.mWaveAmplitude;
+        frequency[i] = species.mWaveFrequency;
+        acceleration[i] = species.mAcceleration;
+    }
+
+    if (script.UsesNeighbors())
+    {
+        FindNeighbors(fish, count);
+    }
+
+    script.Run(mBatch);
+
+    auto dx = mBatch.Column(BehaviorScript::MoveX);
+    auto dy = mBatch.Column(BehaviorScript::MoveY);
+    for (size_t i = 0; i < count; i++)
+    {
+        fish[i]->Steer(speedX[i], speedY[i], dx[i], dy[i], elapsed);
+    }
+}
+
+/**
+ * Fill in the neighbour variables of the current batch. Neighbours
+ * are the other fish running the same script within the school
+ * radius of the first fish's species.
+ * @param fish The fish
+ * @param count Number of fish
+ */
+void ScriptRunner::FindNeighbors(FishScripted *const *fish, size_t count)
+{
+    auto x = mBatch.Column(BehaviorScript::X);
+    auto y = mBatch.Column(BehaviorScript::Y);
+    auto speedX = mBatch.Column(BehaviorScript::SpeedX);
+    auto speedY = mBatch.Column(BehaviorScript::SpeedY);
+    auto neighbors = mBatch.Column(BehaviorScript::Neighbors);
+    auto neighborX = mBatch.Column(BehaviorScript::NeighborX);
+    auto neighborY = mBatch.Column(BehaviorScript::NeighborY);
+    auto neighborSpeedX = mBatch.Column(BehaviorScript::NeighborSpeedX);
+    auto neighborSpeedY = mBatch.Column(BehaviorScript::NeighborSpeedY);
+
+    double radius = fish[0]->GetSpecies()->mSchool.mRadius;
+    mGrid.SetCellSize(radius);
+    mGrid.Build(x, y, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t n = 0;
+        double sumX = 0, sumY = 0, sumSpeedX = 0, sumSpeedY = 0;
+        mGrid.ForEachNeighbor(x[i], y[i], radius, [&](size_t j, double nx, double ny, double) {
+            if (j != i)
+            {
+                n++;
+                sumX += nx;
+                sumY += ny;
+                sumSpeedX += speedX[j];
+                sumSpeedY += speedY[j];
+            }
+        });
+
+        neighbors[i] = (double)n;
+        neighborX[i] = n > 0 ? sumX / n - x[i] : 0;
+        neighborY[i] = n > 0 ? sumY / n - y[i] : 0;
+        neighborSpeedX[i] = n > 0 ? sumSpeedX / n : 0;
+        neighborSpeedY[i] = n > 0 ? sumSpeedY / n : 0;
+    }
+}
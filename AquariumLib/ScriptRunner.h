@@ -0,0 +1,65 @@
+/**
+ * @file ScriptRunner.h
+ * @author Ismail Abdi
+ *
+ * Runs the behaviour scripts of the scripted fish in an aquarium.
+ */
+
+#ifndef AQUARIUM_SCRIPTRUNNER_H
+#define AQUARIUM_SCRIPTRUNNER_H
+
+#include <memory>
+#include <vector>
+#include "BehaviorScript.h"
+#include "SpatialGrid.h"
+
+class Item;
+class FishScripted;
+
+/**
+ * Runs the behaviour scripts of the scripted fish in an aquarium.
+ *
+ * The fish are grouped by script and each script is run once over
+ * its whole group as a BehaviorScript::Batch, rather than once per
+ * fish. Every fish reads the state at the start of the pass, so the
+ * result doesn't depend on the order the fish are in. The arrays
+ * are kept between updates, so a steady tank allocates nothing.
+ *
+ * The fish are only found and grouped when Group is called, which
+ * the aquarium does when its items change, so Run itself doesn't
+ * look at any item that isn't scripted.
+ */
+class ScriptRunner {
+private:
+    /// The scripted fish, grouped by script
+    std::vector<FishScripted *> mFish;
+
+    /// Where each group of mFish starts, with mFish.size() at the end
+    std::vector<size_t> mStarts;
+
+    /// Values the current script runs on
+    BehaviorScript::Batch mBatch;
+
+    /// Neighbour search for scripts that read the neighbours
+    SpatialGrid mGrid;
+
+    void RunGroup(const BehaviorScript &script, FishScripted *const *fish, size_t count,
+            double time, double elapsed, double width, double height);
+
+    void FindNeighbors(FishScripted *const *fish, size_t count);
+
+public:
+    ScriptRunner() {}
+
+    void Group(const std::vector<std::shared_ptr<Item>> &items);
+
+    void Run(double time, double elapsed, double width, double height);
+
+    /**
+     * Number of scripted fish found by the last Group
+     * @return Fish count
+     */
+    size_t GetCount() const { return mFish.size(); }
+};
+
+#endif //AQUARIUM_SCRIPTRUNNER_H
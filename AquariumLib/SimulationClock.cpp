@@ -0,0 +1,47 @@
+/**
+ * @file SimulationClock.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "SimulationClock.h"
+#include <algorithm>
+
+/**
+ * Advance the clock by some wall-clock time.
+ *
+ * A paused clock takes one of its pending steps, if it has any,
+ * so queued steps update the aquarium one step at a time just as
+ * if each had been pressed on its own frame.
+ *
+ * @param wallElapsed Wall-clock seconds since the last call
+ * @return Simulated seconds to update the aquarium by
+ */
+double SimulationClock::Advance(double wallElapsed)
+{
+    double elapsed = 0;
+    if (mPaused)
+    {
+        if (mPendingSteps > 0)
+        {
+            elapsed = mStepSize;
+            mPendingSteps--;
+        }
+    }
+    else if (wallElapsed > 0)
+    {
+        elapsed = wallElapsed * mSpeed;
+    }
+
+    mTime += elapsed;
+    return elapsed;
+}
+
+/**
+ * Set the speed multiplier
+ * @param speed Simulated seconds per wall-clock second, clamped to MinSpeed..MaxSpeed
+ */
+void SimulationClock::SetSpeed(double speed)
+{
+    mSpeed = std::clamp(speed, MinSpeed, MaxSpeed);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file SimulationClock.h
+ * @author Ismail Abdi
+ *
+ * Turns wall-clock time into simulation time.
+ */
+
+#ifndef AQUARIUM_SIMULATIONCLOCK_H
+#define AQUARIUM_SIMULATIONCLOCK_H
+
+/**
+ * Turns wall-clock time into simulation time.
+ *
+ * Supports pausing, single steps while paused and
+ * a speed multiplier.
+ */
+class SimulationClock {
+private:
+    /// Simulated seconds per wall-clock second
+    double mSpeed = 1;
+
+    /// True if time is stopped
+    bool mPaused = false;
+
+    /// Single steps requested while paused
+    int mPendingSteps = 0;
+
+    /// Simulated seconds in one single step
+    double mStepSize = 1.0 / 30;
+
+    /// Total simulated seconds
+    double mTime = 0;
+
+public:
+    /// Slowest speed multiplier allowed
+    static constexpr double MinSpeed = 1.0 / 16;
+
+    /// Fastest speed multiplier allowed
+    static constexpr double MaxSpeed = 64;
+
+    double Advance(double wallElapsed);
+
+    /**
+     * Is the clock paused?
+     * @return True if paused
+     */
+    bool IsPaused() const { return mPaused; }
+
+    /**
+     * Pause or resume the clock
+     * @param paused True to pause
+     */
+    void SetPaused(bool paused) { mPaused = paused; mPendingSteps = 0; }
+
+    /**
+     * Advance by one step the next time the clock is advanced.
+     * Steps requested faster than that queue up and are taken one
+     * per advance. Only has an effect while paused.
+     */
+    void Step() { if (mPaused) { mPendingSteps++; } }
+
+    /**
+     * Are there steps waiting to be taken?
+     * @return True if a paused clock will still advance
+     */
+    bool HasPendingSteps() const { return mPendingSteps > 0; }
+
+    /**
+     * Get the speed multiplier
+     * @return Simulated seconds per wall-clock second
+     */
+    double GetSpeed() const { return mSpeed; }
+
+    void SetSpeed(double speed);
+
+    /**
+     * Get the size of a single step
+     * @return Simulated seconds per step
+     */
+    double GetStepSize() const { return mStepSize; }
+
+    /**
+     * Set the size of a single step
+     * @param step Simulated seconds per step
+     */
+    void SetStepSize(double step) { mStepSize = step; }
+
+    /**
+     * Total simulated time
+     * @return Simulated seconds since the clock was created
+     */
+    double GetTime() const { return mTime; }
+};
+
+#endif //AQUARIUM_SIMULATIONCLOCK_H
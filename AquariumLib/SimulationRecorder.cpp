@@ -0,0 +1,203 @@
+/**
+ * @file SimulationRecorder.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "SimulationRecorder.h"
+#include <cstring>
+
+using namespace std;
+
+/**
+ * Start a new trace file.
+ * @param filename File to write
+ * @param seed The seed the aquarium's random number generator starts from
+ * @return True if the file could be created
+ */
+bool SimulationRecorder::Open(const std::string &filename, uint32_t seed)
+{
+    Close();
+
+    mFile.open(filename, ios::binary | ios::trunc);
+    if (!mFile.is_open())
+    {
+        return false;
+    }
+
+    mTicks = 0;
+    WriteU32(Magic);
+    WriteU16(Version);
+    WriteU32(seed);
+    return true;
+}
+
+/**
+ * Finish the trace and close the file
+ */
+void SimulationRecorder::Close()
+{
+    if (mFile.is_open())
+    {
+        mFile.close();
+    }
+}
+
+/**
+ * Write raw bytes
+ * @param data Bytes to write
+ * @param size Number of bytes
+ */
+void SimulationRecorder::Write(const void *data, size_t size)
+{
+    mFile.write(static_cast<const char *>(data), size);
+}
+
+/**
+ * Write a 16-bit value, little-endian
+ * @param value Value to write
+ */
+void SimulationRecorder::WriteU16(uint16_t value)
+{
+    uint8_t bytes[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+    Write(bytes, sizeof(bytes));
+}
+
+/**
+ * Write a 32-bit value, little-endian
+ * @param value Value to write
+ */
+void SimulationRecorder::WriteU32(uint32_t value)
+{
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++)
+    {
+        bytes[i] = (uint8_t)(value >> (i * 8));
+    }
+    Write(bytes, sizeof(bytes));
+}
+
+/**
+ * Write a 64-bit value, little-endian
+ * @param value Value to write
+ */
+void SimulationRecorder::WriteU64(uint64_t value)
+{
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++)
+    {
+        bytes[i] = (uint8_t)(value >> (i * 8));
+    }
+    Write(bytes, sizeof(bytes));
+}
+
+/**
+ * Write a double as its exact bit pattern
+ * @param value Value to write
+ */
+void SimulationRecorder::WriteF64(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteU64(bits);
+}
+
+/**
+ * Record one update of the aquarium
+ * @param elapsed Simulated seconds the aquarium was updated by
+ * @param hash State hash after the update
+ */
+void SimulationRecorder::Tick(double elapsed, uint64_t hash)
+{
+    WriteU8((uint8_t)Record::Tick);
+    WriteF64(elapsed);
+    WriteU64(hash);
+    mTicks++;
+}
+
+/**
+ * Record a new item being added from the menus
+ * @param type Item type, as saved in .aqua files
+ */
+void SimulationRecorder::Spawn(const std::wstring &type)
+{
+    auto utf8 = wxString(type).ToUTF8();
+    WriteU8((uint8_t)Record::Spawn);
+    WriteU16((uint16_t)utf8.length());
+    Write(utf8.data(), utf8.length());
+}
+
+/**
+ * Record an item being dragged
+ * @param index Index of the item in the aquarium
+ * @param x New X location
+ * @param y New Y location
+ */
+void SimulationRecorder::Move(size_t index, double x, double y)
+{
+    WriteU8((uint8_t)Record::Move);
+    WriteU32((uint32_t)index);
+    WriteF64(x);
+    WriteF64(y);
+}
+
+/**
+ * Record an item being brought to the top
+ * @param index Index of the item before it moved
+ */
+void SimulationRecorder::Raise(size_t index)
+{
+    WriteU8((uint8_t)Record::Raise);
+    WriteU32((uint32_t)index);
+}
+
+/**
+ * Record an item being taken out of the aquarium
+ * @param index Index of the item
+ */
+void SimulationRecorder::Remove(size_t index)
+{
+    WriteU8((uint8_t)Record::Remove);
+    WriteU32((uint32_t)index);
+}
+
+/**
+ * Record an aquarium file being loaded
+ * @param contents The file contents
+ */
+void SimulationRecorder::Load(const std::string &contents)
+{
+    WriteU8((uint8_t)Record::Load);
+    WriteU32((uint32_t)contents.size());
+    Write(contents.data(), contents.size());
+}
+
+/**
+ * Record the aquarium being cleared
+ */
+void SimulationRecorder::Clear()
+{
+    WriteU8((uint8_t)Record::Clear);
+}
+
+/**
+ * Record schooling being turned on or off
+ * @param on True if schooling was turned on
+ */
+void SimulationRecorder::Schooling(bool on)
+{
+    WriteU8((uint8_t)Record::Schooling);
+    WriteU8(on ? 1 : 0);
+}
+
+/**
+ * Record the tank being resized
+ * @param width New tank width in pixels
+ * @param height New tank height in pixels
+ */
+void SimulationRecorder::Resize(int width, int height)
+{
+    WriteU8((uint8_t)Record::Resize);
+    WriteU32((uint32_t)width);
+    WriteU32((uint32_t)height);
+}
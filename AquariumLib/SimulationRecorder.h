@@ -0,0 +1,103 @@
+/**
+ * @file SimulationRecorder.h
+ * @author Ismail Abdi
+ *
+ * Records a simulation session to a binary trace file.
+ */
+
+#ifndef AQUARIUM_SIMULATIONRECORDER_H
+#define AQUARIUM_SIMULATIONRECORDER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/**
+ * Records a simulation session to a binary trace file.
+ *
+ * The trace holds the random seed, then one record per tick
+ * (elapsed time and the state hash after the update) and one per
+ * input event. Loads are stored with the file contents so a trace
+ * replays without the original .aqua files.
+ *
+ * Values are stored little-endian at their natural size.
+ */
+class SimulationRecorder {
+public:
+    /// The kinds of record in a trace
+    enum class Record : uint8_t {
+        Tick = 1,       ///< elapsed (f64), state hash after the update (u64)
+        Spawn = 2,      ///< type (u16 length + UTF-8)
+        Move = 3,       ///< item index (u32), x (f64), y (f64)
+        Raise = 4,      ///< item index (u32), moved to the top of the z-order
+        Load = 5,       ///< file contents (u32 length + bytes)
+        Clear = 6,      ///< no payload
+        Schooling = 7,  ///< on (u8)
+        Resize = 8,     ///< tank width (u32), height (u32)
+        Remove = 9,     ///< item index (u32)
+    };
+
+    /// Magic number at the start of every trace
+    static const uint32_t Magic = 0x52545141;  // "AQTR"
+
+    /**
+     * Format version written to the header. Bump it whenever a
+     * record is added or changed, so an older replayer reports a
+     * trace as too new rather than as damaged.
+     *
+     * Version 2 added the Resize and Remove records and the
+     * simulated time to the state hash.
+     */
+    static const uint16_t Version = 2;
+
+private:
+    /// The trace file
+    std::ofstream mFile;
+
+    /// Number of ticks recorded
+    long mTicks = 0;
+
+    void Write(const void *data, size_t size);
+    void WriteU8(uint8_t value) { Write(&value, sizeof(value)); }
+    void WriteU16(uint16_t value);
+    void WriteU32(uint32_t value);
+    void WriteU64(uint64_t value);
+    void WriteF64(double value);
+
+public:
+    bool Open(const std::string &filename, uint32_t seed);
+
+    void Close();
+
+    /**
+     * Is the recorder writing to a file?
+     * @return True if open
+     */
+    bool IsOpen() const { return mFile.is_open(); }
+
+    /**
+     * Number of ticks recorded so far
+     * @return Tick count
+     */
+    long GetTicks() const { return mTicks; }
+
+    void Tick(double elapsed, uint64_t hash);
+
+    void Spawn(const std::wstring &type);
+
+    void Move(size_t index, double x, double y);
+
+    void Raise(size_t index);
+
+    void Remove(size_t index);
+
+    void Load(const std::string &contents);
+
+    void Clear();
+
+    void Schooling(bool on);
+
+    void Resize(int width, int height);
+};
+
+#endif //AQUARIUM_SIMULATIONRECORDER_H
@@ -0,0 +1,289 @@
+/**
+ * @file SimulationReplayer.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "SimulationReplayer.h"
+#include "SimulationRecorder.h"
+#include "Aquarium.h"
+#include "Item.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+/// Shorthand for the record types
+using Record = SimulationRecorder::Record;
+
+/**
+ * Read a trace file into memory and check its header.
+ * @param filename File to read
+ * @return True if the file is a trace we understand. If it is a
+ * trace in another format version, IsUnsupportedVersion says so.
+ */
+bool SimulationReplayer::Open(const std::string &filename)
+{
+    ifstream file(filename, ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    mData.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    mPosition = 0;
+    mVersion = 0;
+
+    uint32_t magic;
+    uint16_t version;
+    if (!ReadU32(magic) || !ReadU16(version) || !ReadU32(mSeed) || magic != SimulationRecorder::Magic)
+    {
+        return false;
+    }
+
+    mVersion = version;
+    return !IsUnsupportedVersion();
+}
+
+/**
+ * Read raw bytes
+ * @param data Where to put the bytes
+ * @param size Number of bytes
+ * @return False if the trace doesn't have that many bytes left
+ */
+bool SimulationReplayer::Read(void *data, size_t size)
+{
+    if (mData.size() - mPosition < size)
+    {
+        return false;
+    }
+
+    memcpy(data, mData.data() + mPosition, size);
+    mPosition += size;
+    return true;
+}
+
+/**
+ * Read a little-endian 16-bit value
+ * @param value Where to put the value
+ * @return False at the end of the trace
+ */
+bool SimulationReplayer::ReadU16(uint16_t &value)
+{
+    uint8_t bytes[2];
+    if (!Read(bytes, sizeof(bytes)))
+    {
+        return false;
+    }
+
+    value = (uint16_t)(bytes[0] | (bytes[1] << 8));
+    return true;
+}
+
+/**
+ * Read a little-endian 32-bit value
+ * @param value Where to put the value
+ * @return False at the end of the trace
+ */
+bool SimulationReplayer::ReadU32(uint32_t &value)
+{
+    uint8_t bytes[4];
+    if (!Read(bytes, sizeof(bytes)))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 3; i >= 0; i--)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    return true;
+}
+
+/**
+ * Read a little-endian 64-bit value
+ * @param value Where to put the value
+ * @return False at the end of the trace
+ */
+bool SimulationReplayer::ReadU64(uint64_t &value)
+{
+    uint8_t bytes[8];
+    if (!Read(bytes, sizeof(bytes)))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 7; i >= 0; i--)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    return true;
+}
+
+/**
+ * Read a double from its bit pattern
+ * @param value Where to put the value
+ * @return False at the end of the trace
+ */
+bool SimulationReplayer::ReadF64(double &value)
+{
+    uint64_t bits;
+    if (!ReadU64(bits))
+    {
+        return false;
+    }
+
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * Replay the trace into an aquarium.
+ *
+ * The aquarium is cleared and seeded from the trace first. Replay
+ * stops at the first tick whose state hash doesn't match.
+ *
+ * @param aquarium Aquarium to drive. It should not be recording.
+ * @return True if every tick matched the recording
+ */
+bool SimulationReplayer::Replay(Aquarium &aquarium)
+{
+    // Skip the header
+    mPosition = sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint32_t);
+    mTicks = 0;
+    mMismatch = -1;
+    mTruncated = false;
+    mUnknownRecord = 0;
+
+    aquarium.Clear();
+    aquarium.Seed(mSeed);
+
+    auto &items = aquarium.GetItems();
+    uint8_t record;
+    while (ReadU8(record))
+    {
+        bool ok = true;
+        switch ((Record)record)
+        {
+        case Record::Tick:
+        {
+            double elapsed;
+            uint64_t hash;
+            ok = ReadF64(elapsed) && ReadU64(hash);
+            if (ok)
+            {
+                aquarium.Update(elapsed);
+                if (aquarium.GetStateHash() != hash)
+                {
+                    mMismatch = mTicks;
+                    return false;
+                }
+                mTicks++;
+            }
+            break;
+        }
+
+        case Record::Spawn:
+        {
+            uint16_t length;
+            ok = ReadU16(length);
+            string type(ok ? length : 0, '\0');
+            ok = ok && Read(&type[0], length);
+            if (ok)
+            {
+                aquarium.Spawn(wxString::FromUTF8(type.data(), type.size()).ToStdWstring());
+            }
+            break;
+        }
+
+        case Record::Move:
+        {
+            uint32_t index;
+            double x, y;
+            ok = ReadU32(index) && ReadF64(x) && ReadF64(y);
+            if (ok && index < items.size())
+            {
+                aquarium.MoveItem(items[index], x, y);
+            }
+            break;
+        }
+
+        case Record::Raise:
+        {
+            uint32_t index;
+            ok = ReadU32(index);
+            if (ok && index < items.size())
+            {
+                aquarium.MoveToEnd(items[index]);
+            }
+            break;
+        }
+
+        case Record::Remove:
+        {
+            uint32_t index;
+            ok = ReadU32(index);
+            if (ok && index < items.size())
+            {
+                aquarium.Remove(items[index]);
+            }
+            break;
+        }
+
+        case Record::Load:
+        {
+            uint32_t length;
+            ok = ReadU32(length);
+            string contents(ok ? length : 0, '\0');
+            ok = ok && Read(&contents[0], length);
+            if (ok)
+            {
+                aquarium.LoadData(contents);
+            }
+            break;
+        }
+
+        case Record::Clear:
+            aquarium.Clear();
+            break;
+
+        case Record::Schooling:
+        {
+            uint8_t on;
+            ok = ReadU8(on);
+            if (ok)
+            {
+                aquarium.SetSchooling(on != 0);
+            }
+            break;
+        }
+
+        case Record::Resize:
+        {
+            uint32_t width, height;
+            ok = ReadU32(width) && ReadU32(height);
+            if (ok)
+            {
+                aquarium.SetSize((int)width, (int)height);
+            }
+            break;
+        }
+
+        default:
+            // Unknown record, we can't tell how long it is
+            mUnknownRecord = record;
+            return false;
+        }
+
+        if (!ok)
+        {
+            mTruncated = true;
+            return false;
+        }
+    }
+
+    return true;
+}
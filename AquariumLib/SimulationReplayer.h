@@ -0,0 +1,105 @@
+/**
+ * @file SimulationReplayer.h
+ * @author Ismail Abdi
+ *
+ * Replays a trace written by SimulationRecorder.
+ */
+
+#ifndef AQUARIUM_SIMULATIONREPLAYER_H
+#define AQUARIUM_SIMULATIONREPLAYER_H
+
+#include <cstdint>
+#include <string>
+#include "SimulationRecorder.h"
+
+class Aquarium;
+
+/**
+ * Replays a trace written by SimulationRecorder.
+ *
+ * Drives an aquarium through the recorded ticks and inputs with no
+ * view attached, checking the state hash after every tick.
+ */
+class SimulationReplayer {
+private:
+    /// The whole trace file
+    std::string mData;
+
+    /// Read position in mData
+    size_t mPosition = 0;
+
+    /// Seed from the trace header
+    uint32_t mSeed = 0;
+
+    /// Format version from the trace header
+    uint16_t mVersion = 0;
+
+    /// Ticks replayed
+    long mTicks = 0;
+
+    /// First tick whose hash didn't match, or -1
+    long mMismatch = -1;
+
+    /// True if the trace ended part way through a record
+    bool mTruncated = false;
+
+    /// Type of a record this version doesn't know, or 0
+    int mUnknownRecord = 0;
+
+    bool Read(void *data, size_t size);
+    bool ReadU8(uint8_t &value) { return Read(&value, sizeof(value)); }
+    bool ReadU16(uint16_t &value);
+    bool ReadU32(uint32_t &value);
+    bool ReadU64(uint64_t &value);
+    bool ReadF64(double &value);
+
+public:
+    bool Open(const std::string &filename);
+
+    bool Replay(Aquarium &aquarium);
+
+    /**
+     * Seed from the trace header
+     * @return Random seed the session started with
+     */
+    uint32_t GetSeed() const { return mSeed; }
+
+    /**
+     * Format version from the trace header
+     * @return Version, or 0 if the file isn't a trace
+     */
+    uint16_t GetVersion() const { return mVersion; }
+
+    /**
+     * Is the file a trace in a format version we can't replay?
+     * @return True if the version doesn't match SimulationRecorder::Version
+     */
+    bool IsUnsupportedVersion() const { return mVersion != 0 && mVersion != SimulationRecorder::Version; }
+
+    /**
+     * Number of ticks replayed by the last Replay
+     * @return Tick count
+     */
+    long GetTicks() const { return mTicks; }
+
+    /**
+     * First tick whose state didn't match the recording
+     * @return Tick index, or -1 if every tick matched
+     */
+    long GetFirstMismatch() const { return mMismatch; }
+
+    /**
+     * Did the trace end part way through a record?
+     * @return True if the trace was cut short
+     */
+    bool IsTruncated() const { return mTruncated; }
+
+    /**
+     * Type of the record the last Replay stopped at because it
+     * didn't know it, which means the trace came from a newer build
+     * @return Record type, or 0 if there was none
+     */
+    int GetUnknownRecord() const { return mUnknownRecord; }
+};
+
+#endif //AQUARIUM_SIMULATIONREPLAYER_H
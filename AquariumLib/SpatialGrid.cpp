@@ -0,0 +1,143 @@
+/**
+ * @file SpatialGrid.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+
+using namespace std;
+
+/// Upper bound on the number of cells per point, so a few
+/// far-flung points can't make us allocate a huge sparse grid
+const size_t MaxCellsPerPoint = 4;
+
+/// Most times the cell size is doubled to fit the points before
+/// they are all put in one cell
+const int MaxCellDoublings = 64;
+
+/**
+ * Build the grid from arrays of locations.
+ *
+ * Points at NaN or infinite locations are put in the first cell.
+ * They are never within range of anything, so queries skip them.
+ *
+ * @param xs X locations
+ * @param ys Y locations
+ * @param count Number of points
+ */
+void SpatialGrid::Build(const double *xs, const double *ys, size_t count)
+{
+    mIndices.resize(count);
+    mSortedX.resize(count);
+    mSortedY.resize(count);
+    mPointCell.resize(count);
+
+    if (count == 0)
+    {
+        mColumns = mRows = 0;
+        mCellStart.assign(1, 0);
+        return;
+    }
+
+    // Bounds of the points with finite locations
+    double minX = HUGE_VAL, maxX = -HUGE_VAL;
+    double minY = HUGE_VAL, maxY = -HUGE_VAL;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (isfinite(xs[i]) && isfinite(ys[i]))
+        {
+            minX = min(minX, xs[i]);
+            maxX = max(maxX, xs[i]);
+            minY = min(minY, ys[i]);
+            maxY = max(maxY, ys[i]);
+        }
+    }
+
+    if (minX > maxX)
+    {
+        minX = maxX = minY = maxY = 0;
+    }
+
+    mMinX = minX;
+    mMinY = minY;
+
+    // Grow the effective cell size if the points are very sparse.
+    // Larger cells are still correct, they just hold more points.
+    double cellSize = mCellSize > 0 ? mCellSize : 1;
+    size_t maxCells = max<size_t>(count * MaxCellsPerPoint, 16);
+    double columns = 1, rows = 1;
+    for (int doubling = 0; ; doubling++)
+    {
+        columns = floor((maxX - minX) / cellSize) + 1;
+        rows = floor((maxY - minY) / cellSize) + 1;
+        if (columns * rows <= maxCells)
+        {
+            break;
+        }
+
+        if (doubling == MaxCellDoublings)
+        {
+            // Spread too far to grid, like an infinite span; one cell holds everything
+            columns = rows = 1;
+            cellSize = HUGE_VAL;
+            break;
+        }
+
+        cellSize *= 2;
+    }
+
+    mColumns = (int)columns;
+    mRows = (int)rows;
+    mStep = cellSize;
+
+    // Counting sort of the points into cells
+    size_t cells = (size_t)mColumns * (size_t)mRows;
+    mCellStart.assign(cells + 1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t cell = (size_t)Row(ys[i]) * mColumns + Column(xs[i]);
+        mPointCell[i] = cell;
+        mCellStart[cell + 1]++;
+    }
+
+    for (size_t c = 0; c < cells; c++)
+    {
+        mCellStart[c + 1] += mCellStart[c];
+    }
+
+    // Scatter, using the start of each cell as a running cursor
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t slot = mCellStart[mPointCell[i]]++;
+        mIndices[slot] = i;
+        mSortedX[slot] = xs[i];
+        mSortedY[slot] = ys[i];
+    }
+
+    // The cursors now hold the end of each cell; shift them back
+    for (size_t c = cells; c > 0; c--)
+    {
+        mCellStart[c] = mCellStart[c - 1];
+    }
+    mCellStart[0] = 0;
+}
+
+/**
+ * Find the indices of all points within radius of a location.
+ * @param x X location to search around
+ * @param y Y location to search around
+ * @param radius Search radius in pixels
+ * @param result Vector the indices are stored into (cleared first)
+ * @return Number of points found
+ */
+size_t SpatialGrid::Query(double x, double y, double radius, std::vector<size_t> &result) const
+{
+    result.clear();
+    ForEachNeighbor(x, y, radius, [&result](size_t index, double, double, double) {
+        result.push_back(index);
+    });
+
+    return result.size();
+}
@@ -0,0 +1,179 @@
+/**
+ * @file SpatialGrid.h
+ * @author Ismail Abdi
+ *
+ * Uniform grid for fast fixed-radius neighbour queries.
+ */
+
+#ifndef AQUARIUM_SPATIALGRID_H
+#define AQUARIUM_SPATIALGRID_H
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+/**
+ * Uniform grid for fast fixed-radius neighbour queries.
+ *
+ * Points are bucketed into square cells with a counting sort,
+ * so a rebuild is O(n) and allocates nothing once the internal
+ * arrays have grown to the school size. A query with a radius no
+ * larger than the cell size only touches the 3x3 block of cells
+ * around the query point.
+ */
+class SpatialGrid {
+private:
+    /// Requested width and height of a cell in pixels
+    double mCellSize = 100;
+
+    /// Cell size actually used by the last Build
+    double mStep = 100;
+
+    /// Left edge of the grid
+    double mMinX = 0;
+
+    /// Top edge of the grid
+    double mMinY = 0;
+
+    /// Number of columns of cells
+    int mColumns = 0;
+
+    /// Number of rows of cells
+    int mRows = 0;
+
+    /// Index into mIndices of the first point in each cell (size cells + 1)
+    std::vector<size_t> mCellStart;
+
+    /// Original point indices, sorted by cell
+    std::vector<size_t> mIndices;
+
+    /// X locations, sorted by cell
+    std::vector<double> mSortedX;
+
+    /// Y locations, sorted by cell
+    std::vector<double> mSortedY;
+
+    /// Cell of each point in the order it was given
+    std::vector<size_t> mPointCell;
+
+    /**
+     * Column of an x location, clamped to the grid
+     * @param x X location in pixels
+     * @return Column index
+     */
+    int Column(double x) const
+    {
+        // Compared as a double so NaN and huge values never reach the cast
+        double c = (x - mMinX) / mStep;
+        return !(c >= 0) ? 0 : (c >= mColumns ? mColumns - 1 : (int)c);
+    }
+
+    /**
+     * Row of a y location, clamped to the grid
+     * @param y Y location in pixels
+     * @return Row index
+     */
+    int Row(double y) const
+    {
+        double r = (y - mMinY) / mStep;
+        return !(r >= 0) ? 0 : (r >= mRows ? mRows - 1 : (int)r);
+    }
+
+public:
+    SpatialGrid() = default;
+
+    /**
+     * Constructor
+     * @param cellSize Width and height of a cell in pixels
+     */
+    explicit SpatialGrid(double cellSize) : mCellSize(cellSize) {}
+
+    /**
+     * Set the cell size. Takes effect on the next Build.
+     * @param cellSize Width and height of a cell in pixels
+     */
+    void SetCellSize(double cellSize) { mCellSize = cellSize; }
+
+    /**
+     * Get the cell size
+     * @return Width and height of a cell in pixels
+     */
+    double GetCellSize() const { return mCellSize; }
+
+    /**
+     * Number of points in the grid
+     * @return Point count
+     */
+    size_t GetCount() const { return mIndices.size(); }
+
+    void Build(const double *xs, const double *ys, size_t count);
+
+    /**
+     * Build the grid from vectors of locations
+     * @param xs X locations
+     * @param ys Y locations (same size as xs)
+     */
+    void Build(const std::vector<double> &xs, const std::vector<double> &ys)
+    {
+        Build(xs.data(), ys.data(), xs.size());
+    }
+
+    /**
+     * Visit every point within radius of a location.
+     *
+     * The radius should not exceed the cell size; larger
+     * radii are clipped to the 3x3 block of cells around the point.
+     *
+     * @param x X location to search around
+     * @param y Y location to search around
+     * @param radius Search radius in pixels
+     * @param visit Called as visit(index, x, y, distanceSquared) for each neighbour
+     */
+    template <typename Visitor>
+    void ForEachNeighbor(double x, double y, double radius, Visitor &&visit) const
+    {
+        if (mIndices.empty())
+        {
+            return;
+        }
+
+        double radius2 = radius * radius;
+        int col = Column(x);
+        int row = Row(y);
+        int c0 = col > 0 ? col - 1 : 0;
+        int c1 = col + 1 < mColumns ? col + 1 : col;
+        int r0 = row > 0 ? row - 1 : 0;
+        int r1 = row + 1 < mRows ? row + 1 : row;
+
+        for (int r = r0; r <= r1; r++)
+        {
+            // Cells in a row are contiguous, so the whole span is one run
+            size_t begin = mCellStart[(size_t)r * mColumns + c0];
+            size_t end = mCellStart[(size_t)r * mColumns + c1 + 1];
+            for (size_t i = begin; i < end; i++)
+            {
+                double dx = mSortedX[i] - x;
+                double dy = mSortedY[i] - y;
+                double d2 = dx * dx + dy * dy;
+                if (d2 <= radius2)
+                {
+                    visit(mIndices[i], mSortedX[i], mSortedY[i], d2);
+                }
+            }
+        }
+    }
+
+    size_t Query(double x, double y, double radius, std::vector<size_t> &result) const;
+
+    /**
+     * Memory used by the grid's arrays, including unused capacity
+     * @return Size in bytes
+     */
+    size_t GetByteSize() const
+    {
+        return (mCellStart.capacity() + mIndices.capacity() + mPointCell.capacity()) * sizeof(size_t) +
+                (mSortedX.capacity() + mSortedY.capacity()) * sizeof(double);
+    }
+};
+
+#endif //AQUARIUM_SPATIALGRID_H
@@ -0,0 +1,337 @@
+/**
+ * @file SpeciesRegistry.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "SpeciesRegistry.h"
+#include "Fish.h"
+#include "FishBeta.h"
+#include "FishNemo.h"
+#include "FishGoldeen.h"
+#include "FishScripted.h"
+#include "DecorCastle.h"
+#include "AnimationClip.h"
+#include "Sprite.h"
+#include "BehaviorScript.h"
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+using namespace std;
+
+/// Data file with species beyond the built in ones
+const wstring SpeciesDataFile = L"data/species.xml";
+
+/**
+ * Read a number attribute, keeping the current value if it's missing
+ * @param node XML node
+ * @param name Attribute name
+ * @param value Value to update
+ */
+static void XmlNumber(wxXmlNode *node, const wxString &name, double &value)
+{
+    wxString text;
+    if (node->GetAttribute(name, &text))
+    {
+        text.ToDouble(&value);
+    }
+}
+
+/**
+ * Compile the behaviour script of a species
+ * @param species Species to set mProgram of
+ * @param error Output: what was wrong with the script, if it didn't compile
+ * @return False if the script didn't compile
+ */
+static bool CompileScript(Species &species, wstring &error)
+{
+    species.mProgram = BehaviorScript::Compile(species.mScript, error);
+    return species.mProgram != nullptr;
+}
+
+/**
+ * Constructor. Registers the built in behaviours and species.
+ */
+SpeciesRegistry::SpeciesRegistry()
+{
+    Fish::Register(*this);
+    DecorCastle::Register(*this);
+    FishBeta::Register(*this);
+    FishNemo::Register(*this);
+    FishGoldeen::Register(*this);
+    FishScripted::Register(*this);
+}
+
+/**
+ * Add a behaviour species can use
+ * @param name Behaviour name
+ * @param factory Creates an item with this behaviour
+ */
+void SpeciesRegistry::AddBehavior(const std::wstring &name, SpeciesFactory factory)
+{
+    mBehaviors[name] = factory;
+}
+
+/**
+ * Add a species, replacing any species with the same name.
+ *
+ * Items already created keep the species they were created with.
+ *
+ * @param species The species to add
+ * @return The registered species, or nullptr if its behaviour is
+ * unknown or its script doesn't compile
+ */
+std::shared_ptr<const Species> SpeciesRegistry::Add(const Species &species)
+{
+    auto behavior = mBehaviors.find(species.mBehavior);
+    if (behavior == mBehaviors.end())
+    {
+        return nullptr;
+    }
+
+    auto added = make_shared<Species>(species);
+    wstring error;
+    if (!CompileScript(*added, error))
+    {
+        return nullptr;
+    }
+
+    added->mFactory = behavior->second;
+    added->mClip = nullptr;
+    if (!added->mFrames.empty())
+    {
+        if (added->mImage.empty())
+        {
+            added->mImage = added->mFrames[0];
+        }
+
+        if (added->mFrames.size() > 1)
+        {
+            added->mClip = make_shared<AnimationClip>(SpriteCache::GetDefault(), added->mFrames);
+        }
+    }
+
+    Publish(added);
+    return added;
+}
+
+/**
+ * Make a species the one registered under its name, in the place
+ * in the menus of any species it replaces
+ * @param species The species, which mustn't change from now on
+ */
+void SpeciesRegistry::Publish(std::shared_ptr<const Species> species)
+{
+    auto &existing = mSpecies[species->mName];
+    if (existing != nullptr)
+    {
+        replace(mOrder.begin(), mOrder.end(), existing, species);
+        mRetired.push_back(existing);
+    }
+    else
+    {
+        mOrder.push_back(species);
+    }
+
+    existing = species;
+    mVersion++;
+}
+
+/**
+ * Is one species just the other with different parameters?
+ *
+ * Items can move from a species to a tuning of it, but not to one
+ * with a different behaviour, image or animation frames, since
+ * they can't change class or sprite.
+ *
+ * @param from Species an item has
+ * @param to Species that might replace it
+ * @return True if items of from can become items of to
+ */
+bool SpeciesRegistry::IsTuning(const Species &from, const Species &to)
+{
+    return from.mName == to.mName && from.mBehavior == to.mBehavior &&
+            from.mImage == to.mImage && from.mFrames == to.mFrames;
+}
+
+/**
+ * Find a species by type name
+ * @param name Type name, as saved in .aqua files
+ * @return The species, or nullptr if there isn't one by that name
+ */
+std::shared_ptr<const Species> SpeciesRegistry::Find(const std::wstring &name) const
+{
+    auto species = mSpecies.find(name);
+    return species != mSpecies.end() ? species->second : nullptr;
+}
+
+/**
+ * Create an item of a species
+ * @param name Type name, as saved in .aqua files
+ * @param aquarium Aquarium the item will be in
+ * @return New item, or nullptr if there is no such species
+ */
+std::shared_ptr<Item> SpeciesRegistry::Create(const std::wstring &name, Aquarium *aquarium) const
+{
+    auto species = Find(name);
+    if (species == nullptr)
+    {
+        return nullptr;
+    }
+
+    return species->mFactory(aquarium, species);
+}
+
+/**
+ * Add the species in an XML data file.
+ *
+ * The root is a species node with a fish or decor node for each
+ * species. A species that is already registered is replaced by a
+ * tuned copy, keeping anything the file doesn't give, which items
+ * already created move to on their aquarium's next tick. A new
+ * species takes the defaults from Species for anything not given.
+ *
+ * Changing the behaviour, image or animation frames of a species
+ * replaces it with a new species instead, since existing items
+ * can't change class or sprite. Items already created keep the
+ * old one.
+ *
+ * This runs when the file changes on disk, maybe while an editor
+ * is part way through saving it, so problems go to the status bar
+ * rather than a dialog.
+ *
+ * @param filename File to load
+ * @return False if the file couldn't be loaded
+ */
+bool SpeciesRegistry::Load(const wxString &filename)
+{
+    wxXmlDocument xmlDoc;
+    {
+        // The parser's own errors would each be a dialog
+        wxLogNull noLog;
+        if (!xmlDoc.Load(filename))
+        {
+            wxLogStatus(L"Unable to load species file %s", filename);
+            return false;
+        }
+    }
+
+    auto root = xmlDoc.GetRoot();
+    if (!root || root->GetName() != L"species")
+    {
+        wxLogStatus(L"Invalid species file %s", filename);
+        return false;
+    }
+
+    mFilename = filename;
+
+    for (auto node = root->GetChildren(); node; node = node->GetNext())
+    {
+        if (node->GetName() != L"fish" && node->GetName() != L"decor")
+        {
+            continue;
+        }
+
+        auto name = node->GetAttribute(L"name").ToStdWstring();
+        auto existing = mSpecies.find(name);
+
+        Species species;
+        if (existing != mSpecies.end())
+        {
+            species = *existing->second;
+        }
+        else
+        {
+            species.mName = name;
+            species.mLabel = name;
+            species.mDecor = node->GetName() == L"decor";
+            species.mBehavior = species.mDecor ? L"decor" : L"fish";
+        }
+
+        species.mLabel = node->GetAttribute(L"label", species.mLabel).ToStdWstring();
+        species.mImage = node->GetAttribute(L"image", species.mImage).ToStdWstring();
+        species.mBehavior = node->GetAttribute(L"behavior", species.mBehavior).ToStdWstring();
+        species.mScript = node->GetAttribute(L"script", species.mScript).ToStdWstring();
+
+        wxString frames;
+        if (node->GetAttribute(L"frames", &frames))
+        {
+            species.mFrames.clear();
+            wxStringTokenizer tokenizer(frames, L",");
+            while (tokenizer.HasMoreTokens())
+            {
+                species.mFrames.push_back(tokenizer.GetNextToken().Trim().Trim(false).ToStdWstring());
+            }
+        }
+
+        XmlNumber(node, L"min-speed-x", species.mMinSpeedX);
+        XmlNumber(node, L"max-speed-x", species.mMaxSpeedX);
+        XmlNumber(node, L"min-speed-y", species.mMinSpeedY);
+        XmlNumber(node, L"max-speed-y", species.mMaxSpeedY);
+        XmlNumber(node, L"limit-x", species.mSpeedLimitX);
+        XmlNumber(node, L"limit-y", species.mSpeedLimitY);
+        XmlNumber(node, L"radius", species.mSchool.mRadius);
+        XmlNumber(node, L"separation-distance", species.mSchool.mSeparationDistance);
+        XmlNumber(node, L"separation", species.mSchool.mSeparation);
+        XmlNumber(node, L"alignment", species.mSchool.mAlignment);
+        XmlNumber(node, L"cohesion", species.mSchool.mCohesion);
+        XmlNumber(node, L"acceleration", species.mAcceleration);
+        XmlNumber(node, L"wave-amplitude", species.mWaveAmplitude);
+        XmlNumber(node, L"wave-frequency", species.mWaveFrequency);
+        XmlNumber(node, L"frame-rate", species.mFrameRate);
+
+        // Report script errors here, where the file's name is known
+        wstring error;
+        if (!CompileScript(species, error))
+        {
+            wxLogStatus(L"Invalid script for species %s: %s", node->GetAttribute(L"name"), error);
+            continue;
+        }
+
+        if (existing != mSpecies.end() && IsTuning(*existing->second, species))
+        {
+            // A copy, so anything reading the old one is undisturbed
+            Publish(make_shared<const Species>(species));
+        }
+        else if (species.mName.empty() || (species.mImage.empty() && species.mFrames.empty()) ||
+                Add(species) == nullptr)
+        {
+            wxLogStatus(L"Invalid species %s in species file", node->GetAttribute(L"name"));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Load the data file last loaded again, after it has been edited
+ * @return False if there is no file or it couldn't be loaded
+ */
+bool SpeciesRegistry::Reload()
+{
+    if (mFilename.empty())
+    {
+        return false;
+    }
+
+    return Load(mFilename);
+}
+
+/**
+ * Get the registry shared by every aquarium. This has the built
+ * in species plus any in the species data file.
+ * @return Shared registry
+ */
+std::shared_ptr<SpeciesRegistry> SpeciesRegistry::GetDefault()
+{
+    static auto registry = [] {
+        auto registry = make_shared<SpeciesRegistry>();
+        if (wxFileName::FileExists(SpeciesDataFile))
+        {
+            registry->Load(SpeciesDataFile);
+        }
+        return registry;
+    }();
+
+    return registry;
+}
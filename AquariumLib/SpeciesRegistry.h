@@ -0,0 +1,179 @@
+/**
+ * @file SpeciesRegistry.h
+ * @author Ismail Abdi
+ *
+ * The kinds of item that can go in an aquarium.
+ */
+
+#ifndef AQUARIUM_SPECIESREGISTRY_H
+#define AQUARIUM_SPECIESREGISTRY_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "School.h"
+
+class Aquarium;
+class Item;
+class AnimationClip;
+class BehaviorScript;
+struct Species;
+
+/// Creates an item of a species
+using SpeciesFactory = std::function<std::shared_ptr<Item>(Aquarium *, std::shared_ptr<const Species>)>;
+
+/**
+ * Everything that describes one kind of item.
+ */
+struct Species {
+    /// Type name used in .aqua files
+    std::wstring mName;
+
+    /// Label for the Add menus
+    std::wstring mLabel;
+
+    /// Image filename. For an animated species, the first frame
+    std::wstring mImage;
+
+    /// Image filenames of the animation frames, empty if not animated
+    std::vector<std::wstring> mFrames;
+
+    /// Animation frames per second
+    double mFrameRate = 0;
+
+    /// Name of the behaviour that creates items of this species
+    std::wstring mBehavior;
+
+    /// True if this is decor rather than a fish
+    bool mDecor = false;
+
+    /// Slowest starting X speed in pixels per second
+    double mMinSpeedX = 20;
+
+    /// Fastest starting X speed in pixels per second
+    double mMaxSpeedX = 50;
+
+    /// Slowest starting Y speed in pixels per second
+    double mMinSpeedY = 0;
+
+    /// Fastest starting Y speed in pixels per second
+    double mMaxSpeedY = 0;
+
+    /// Largest X speed in pixels per second
+    double mSpeedLimitX = 100;
+
+    /// Largest Y speed in pixels per second
+    double mSpeedLimitY = 60;
+
+    /// How quickly fish speed up in pixels per second squared, for behaviours that accelerate
+    double mAcceleration = 0;
+
+    /// Height of the swimming wave in pixels, for behaviours that swim in a wave
+    double mWaveAmplitude = 0;
+
+    /// How many waves fish swim per 100 pixels across, for behaviours that swim in a wave
+    double mWaveFrequency = 0;
+
+    /// Schooling parameters
+    SchoolParameters mSchool;
+
+    /// Behaviour script, for the "script" behaviour. See BehaviorScript.
+    std::wstring mScript;
+
+    /// Creates items of this species, set from mBehavior when registered
+    SpeciesFactory mFactory;
+
+    /// Animation frames shared by every item, set from mFrames when registered
+    std::shared_ptr<AnimationClip> mClip;
+
+    /// mScript compiled, set when registered
+    std::shared_ptr<const BehaviorScript> mProgram;
+};
+
+/**
+ * The kinds of item that can go in an aquarium.
+ *
+ * Behaviours are the classes that implement items ("beta",
+ * "nemo", "fish", "decor", ...). Species pick a behaviour and
+ * give it an image, speeds and schooling parameters. The built
+ * in species are registered from code and more can be added
+ * from an XML data file.
+ *
+ * Species are looked up by type name in a hash table, so
+ * loading a large aquarium doesn't compare type strings.
+ *
+ * A species is never changed once it is registered, since items,
+ * snapshots and the control server's thread all read it. Loading
+ * a data file again registers a tuned copy of each species it
+ * names instead, and aquariums move their items onto the copy on
+ * their next tick, so fish already swimming pick up the new
+ * parameters. The version number changes whenever any species
+ * changes, so an aquarium only has to check one number per tick.
+ *
+ * Replaced species are kept for as long as the registry is, so
+ * anything holding the registry can use plain pointers to species.
+ */
+class SpeciesRegistry {
+private:
+    /// Factories for each behaviour
+    std::unordered_map<std::wstring, SpeciesFactory> mBehaviors;
+
+    /// Species by type name
+    std::unordered_map<std::wstring, std::shared_ptr<const Species>> mSpecies;
+
+    /// Species in the order they were first registered, for the menus
+    std::vector<std::shared_ptr<const Species>> mOrder;
+
+    /// Species that have been replaced, kept so a plain pointer to
+    /// any species of this registry stays good while it exists
+    std::vector<std::shared_ptr<const Species>> mRetired;
+
+    /// Changes whenever a species is added or tuned
+    uint64_t mVersion = 0;
+
+    /// The data file last loaded
+    wxString mFilename;
+
+    void Publish(std::shared_ptr<const Species> species);
+
+public:
+    SpeciesRegistry();
+
+    void AddBehavior(const std::wstring &name, SpeciesFactory factory);
+
+    std::shared_ptr<const Species> Add(const Species &species);
+
+    std::shared_ptr<const Species> Find(const std::wstring &name) const;
+
+    std::shared_ptr<Item> Create(const std::wstring &name, Aquarium *aquarium) const;
+
+    bool Load(const wxString &filename);
+
+    bool Reload();
+
+    static bool IsTuning(const Species &from, const Species &to);
+
+    /**
+     * Get the data file last loaded
+     * @return Filename, or empty if no file has been loaded
+     */
+    const wxString &GetFilename() const { return mFilename; }
+
+    /**
+     * Get the version of the species parameters
+     * @return Number that changes whenever any species changes
+     */
+    uint64_t GetVersion() const { return mVersion; }
+
+    /**
+     * Get the species in menu order
+     * @return Registered species
+     */
+    const std::vector<std::shared_ptr<const Species>> &GetSpecies() const { return mOrder; }
+
+    static std::shared_ptr<SpeciesRegistry> GetDefault();
+};
+
+#endif //AQUARIUM_SPECIESREGISTRY_H
@@ -0,0 +1,461 @@
+/**
+ * @file Sprite.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "Sprite.h"
+#include "Metrics.h"
+#include <cmath>
+#include <cstring>
+#include <wx/file.h>
+
+using namespace std;
+
+/// Colour a sprite is drawn in before it is decoded
+const unsigned char PlaceholderGrey = 128;
+
+/**
+ * Read the size of a PNG image from its header, without decoding it.
+ * @param filename The image file
+ * @param width Set to the image width
+ * @param height Set to the image height
+ * @return True if the file is a PNG and the size was read
+ */
+static bool ReadPngSize(const std::wstring &filename, int &width, int &height)
+{
+    // Signature, then the IHDR chunk: length, type, width, height
+    unsigned char header[24];
+    wxFile file;
+    if (!wxFileExists(filename) || !file.Open(filename) || file.Read(header, sizeof(header)) != (ssize_t)sizeof(header))
+    {
+        return false;
+    }
+
+    const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (memcmp(header, signature, sizeof(signature)) != 0 || memcmp(header + 12, "IHDR", 4) != 0)
+    {
+        return false;
+    }
+
+    auto bigEndian = [&header](int offset) {
+        return (int)(((uint32_t)header[offset] << 24) | ((uint32_t)header[offset + 1] << 16) |
+                ((uint32_t)header[offset + 2] << 8) | (uint32_t)header[offset + 3]);
+    };
+    width = bigEndian(16);
+    height = bigEndian(20);
+    return true;
+}
+
+/**
+ * Constructor.
+ * @param filename The image file to load
+ * @param decode True to decode the image now. If false only the size
+ * is read and the image is decoded by a later call to Decode.
+ */
+Sprite::Sprite(const std::wstring &filename, bool decode) : mFilename(filename)
+{
+    mLevels.push_back(make_unique<Level>());
+    mFullImage = &mLevels[0]->mImage;
+
+    if (decode)
+    {
+        Decode();
+        return;
+    }
+
+    int width, height;
+    if (ReadPngSize(filename, width, height))
+    {
+        mWidth.store(width, memory_order_relaxed);
+        mHeight.store(height, memory_order_relaxed);
+    }
+}
+
+/**
+ * Decode the image if it hasn't been already.
+ *
+ * Safe to call from any thread. If another thread is part way
+ * through decoding this sprite, waits for it to finish.
+ */
+void Sprite::Decode()
+{
+    call_once(mDecodeOnce, [this] {
+        static auto &decodes = Metrics::GetDefault()->Counter("aquarium_sprite_decodes_total", "Images decoded");
+        static auto &decodeTime = Metrics::GetDefault()->Histogram("aquarium_sprite_decode_seconds", "Time to decode an image");
+        MetricTimer timer(decodeTime);
+        decodes.Add();
+        DecodeImage();
+    });
+}
+
+/**
+ * Load the image and work out its masks and colour.
+ *
+ * Only ever runs once, through Decode. Nothing here is read by
+ * other threads until mReady is set at the end.
+ */
+void Sprite::DecodeImage()
+{
+    wxImage image;
+    image.LoadFile(mFilename, wxBITMAP_TYPE_ANY);
+    if (image.IsOk())
+    {
+        int width = image.GetWidth();
+        int height = image.GetHeight();
+        const unsigned char *data = image.GetData();
+
+        // Pack the opacity once so hit tests never touch the image
+        if (image.HasAlpha())
+        {
+            mMasks[0] = AlphaMask(width, height, image.GetAlpha());
+        }
+        else
+        {
+            mMasks[0] = AlphaMask(width, height);
+            bool hasMask = image.HasMask();
+            unsigned char maskRed = image.GetMaskRed();
+            unsigned char maskGreen = image.GetMaskGreen();
+            unsigned char maskBlue = image.GetMaskBlue();
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *pixel = data + ((size_t)y * width + x) * 3;
+                    bool masked = hasMask && pixel[0] == maskRed && pixel[1] == maskGreen && pixel[2] == maskBlue;
+                    mMasks[0].Set(x, y, !masked);
+                }
+            }
+        }
+        mMasks[1] = mMasks[0].Mirror();
+
+        // Average the opaque pixels for drawing the sprite as a point
+        unsigned long red = 0, green = 0, blue = 0, count = 0;
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                if (mMasks[0].IsOpaque(x, y))
+                {
+                    const unsigned char *pixel = data + ((size_t)y * width + x) * 3;
+                    red += pixel[0];
+                    green += pixel[1];
+                    blue += pixel[2];
+                    count++;
+                }
+            }
+        }
+
+        if (count > 0)
+        {
+            mColour = wxColour(red / count, green / count, blue / count);
+        }
+
+        mWidth.store(width, memory_order_relaxed);
+        mHeight.store(height, memory_order_relaxed);
+    }
+    else
+    {
+        mWidth.store(0, memory_order_relaxed);
+        mHeight.store(0, memory_order_relaxed);
+    }
+
+    *mFullImage = image;
+    mReady.store(true, memory_order_release);
+}
+
+/**
+ * Average colour of the opaque pixels
+ * @return Colour to draw the sprite as a single point, grey until it is decoded
+ */
+const wxColour &Sprite::GetColour() const
+{
+    static const wxColour placeholder(PlaceholderGrey, PlaceholderGrey, PlaceholderGrey);
+    return IsReady() ? mColour : placeholder;
+}
+
+/**
+ * Get the opacity mask of the full size image
+ * @param mirror True for the mirrored orientation
+ * @return Packed opacity mask, empty until the sprite is decoded
+ */
+const AlphaMask &Sprite::GetMask(bool mirror) const
+{
+    static const AlphaMask placeholder;
+    return IsReady() ? mMasks[mirror ? 1 : 0] : placeholder;
+}
+
+/**
+ * Number of mip levels this sprite can be drawn at
+ * @return Levels down to a single pixel
+ */
+int Sprite::GetLevelCount() const
+{
+    int size = max(GetWidth(), GetHeight());
+    int levels = 1;
+    while (size > 1)
+    {
+        size /= 2;
+        levels++;
+    }
+
+    return levels;
+}
+
+/**
+ * Memory used by the pixels of this sprite: the image and
+ * bitmaps at every level built so far, and the opacity masks.
+ *
+ * Bitmaps are counted at four bytes a pixel, which is what the
+ * platforms keep them as. Call on the GUI thread, which is the
+ * only one that builds levels and bitmaps.
+ *
+ * @return Size in bytes, 0 until the sprite is decoded
+ */
+size_t Sprite::GetByteSize() const
+{
+    if (!IsReady())
+    {
+        return 0;
+    }
+
+    size_t bytes = mMasks[0].GetByteSize() + mMasks[1].GetByteSize();
+    for (auto &level : mLevels)
+    {
+        size_t pixels = (size_t)level->mImage.GetWidth() * level->mImage.GetHeight();
+        bytes += pixels * (level->mImage.HasAlpha() ? 4 : 3);
+        for (auto &bitmap : level->mBitmaps)
+        {
+            if (bitmap != nullptr)
+            {
+                bytes += pixels * 4;
+            }
+        }
+    }
+
+    return bytes;
+}
+
+/**
+ * Get the mip level to draw at for a zoom factor.
+ *
+ * This is the smallest level that is still at least as
+ * large as the sprite will appear, so it is only ever
+ * scaled down by less than half when drawn.
+ *
+ * @param zoom Screen pixels per aquarium pixel
+ * @return Mip level, 0 for full size
+ */
+int Sprite::LevelForZoom(double zoom)
+{
+    if (zoom >= 1)
+    {
+        return 0;
+    }
+
+    return (int)floor(log2(1 / zoom));
+}
+
+/**
+ * Make sure a mip level and the ones above it exist.
+ * @param level Level to build
+ */
+void Sprite::BuildLevel(size_t level)
+{
+    while (mLevels.size() <= level)
+    {
+        auto &previous = mLevels.back()->mImage;
+        int width = max(previous.GetWidth() / 2, 1);
+        int height = max(previous.GetHeight() / 2, 1);
+
+        auto next = make_unique<Level>();
+        next->mImage = previous.Scale(width, height, wxIMAGE_QUALITY_BOX_AVERAGE);
+        mLevels.push_back(move(next));
+    }
+}
+
+/**
+ * Get a bitmap for this sprite.
+ * @param mirror True for the mirrored orientation
+ * @param level Mip level, clamped to the levels available
+ * @return Bitmap to draw
+ */
+wxBitmap *Sprite::GetBitmap(bool mirror, int level)
+{
+    Decode();
+    level = max(0, min(level, GetLevelCount() - 1));
+    BuildLevel(level);
+
+    auto &entry = *mLevels[level];
+    auto &bitmap = entry.mBitmaps[mirror ? 1 : 0];
+    if (bitmap == nullptr)
+    {
+        if (mirror)
+        {
+            bitmap = make_unique<wxBitmap>(entry.mImage.Mirror());
+        }
+        else
+        {
+            bitmap = make_unique<wxBitmap>(entry.mImage);
+        }
+    }
+
+    return bitmap.get();
+}
+
+/**
+ * Draw the sprite scaled, using the best mip level for the zoom.
+ *
+ * A sprite that is still being decoded is drawn as an outline
+ * of its size rather than waiting for it.
+ *
+ * @param dc Device context to draw on
+ * @param mirror True for the mirrored orientation
+ * @param left Screen X of the left edge of the sprite
+ * @param top Screen Y of the top edge of the sprite
+ * @param zoom Screen pixels per sprite pixel
+ */
+void Sprite::Draw(wxDC *dc, bool mirror, double left, double top, double zoom)
+{
+    Stretch(dc, mirror, left, top, zoom * GetWidth(), zoom * GetHeight());
+}
+
+/**
+ * Draw the sprite stretched to fill a rectangle, using the best
+ * mip level for the smaller of the two scale factors.
+ *
+ * The rectangle is in the DC's logical coordinates, and any user
+ * scale the caller has set is left as it was.
+ *
+ * @param dc Device context to draw on
+ * @param mirror True for the mirrored orientation
+ * @param left Screen X of the left edge of the rectangle
+ * @param top Screen Y of the top edge of the rectangle
+ * @param width Screen width of the rectangle
+ * @param height Screen height of the rectangle
+ */
+void Sprite::Stretch(wxDC *dc, bool mirror, double left, double top, double width, double height)
+{
+    if (!IsReady())
+    {
+        // Leave the caller's pen and brush as they were
+        wxDCPenChanger pen(*dc, wxPen(wxColour(PlaceholderGrey, PlaceholderGrey, PlaceholderGrey)));
+        wxDCBrushChanger brush(*dc, *wxTRANSPARENT_BRUSH);
+        dc->DrawRectangle((int)left, (int)top, (int)width, (int)height);
+        return;
+    }
+
+    if (GetWidth() <= 0 || GetHeight() <= 0)
+    {
+        return;
+    }
+
+    auto bitmap = GetBitmap(mirror, LevelForZoom(min(width / GetWidth(), height / GetHeight())));
+
+    // Whatever is left after the mip level is done by the DC
+    double scaleX = width / bitmap->GetWidth();
+    double scaleY = height / bitmap->GetHeight();
+    if (scaleX == 1 && scaleY == 1)
+    {
+        dc->DrawBitmap(*bitmap, (int)left, (int)top);
+        return;
+    }
+
+    // Scale on top of the caller's scale, then put theirs back
+    double userX, userY;
+    dc->GetUserScale(&userX, &userY);
+    dc->SetUserScale(userX * scaleX, userY * scaleY);
+    dc->DrawBitmap(*bitmap, (int)(left / scaleX), (int)(top / scaleY));
+    dc->SetUserScale(userX, userY);
+}
+
+/**
+ * Find a sprite, adding an undecoded one if it isn't in the cache.
+ * @param filename The image file
+ * @param created Set true if the sprite was added
+ * @return The sprite
+ */
+std::shared_ptr<Sprite> SpriteCache::Find(const std::wstring &filename, bool &created)
+{
+    static auto &hits = Metrics::GetDefault()->Counter("aquarium_sprite_cache_hits_total", "Sprite cache lookups that found the sprite");
+    static auto &misses = Metrics::GetDefault()->Counter("aquarium_sprite_cache_misses_total", "Sprite cache lookups that had to add the sprite");
+
+    lock_guard<mutex> lock(mMutex);
+
+    auto found = mSprites.find(filename);
+    created = found == mSprites.end();
+    if (!created)
+    {
+        hits.Add();
+        return found->second;
+    }
+
+    misses.Add();
+
+    auto sprite = make_shared<Sprite>(filename, false);
+    mSprites[filename] = sprite;
+    return sprite;
+}
+
+/**
+ * Get a sprite, loading it the first time it is asked for.
+ *
+ * The image is decoded outside the cache lock, so threads loading
+ * different images don't wait for each other. A sprite that was
+ * preloaded is returned straight away even if it isn't ready yet.
+ *
+ * @param filename The image file
+ * @return Sprite shared with every other user of this file
+ */
+std::shared_ptr<Sprite> SpriteCache::Get(const std::wstring &filename)
+{
+    bool created;
+    auto sprite = Find(filename, created);
+    if (created)
+    {
+        sprite->Decode();
+    }
+
+    return sprite;
+}
+
+/**
+ * Add a sprite to the cache without decoding it.
+ *
+ * Whoever preloads a sprite is responsible for calling Decode on
+ * it, usually from a worker thread.
+ *
+ * @param filename The image file
+ * @return Sprite shared with every other user of this file
+ */
+std::shared_ptr<Sprite> SpriteCache::Preload(const std::wstring &filename)
+{
+    bool created;
+    return Find(filename, created);
+}
+
+/**
+ * Memory used by the pixels of every sprite in the cache
+ * @return Size in bytes
+ */
+size_t SpriteCache::GetByteSize()
+{
+    lock_guard<mutex> lock(mMutex);
+    size_t bytes = 0;
+    for (auto &sprite : mSprites)
+    {
+        bytes += sprite.second->GetByteSize();
+    }
+
+    return bytes;
+}
+
+/**
+ * Get the process-wide cache shared by all aquariums
+ * @return The default cache
+ */
+std::shared_ptr<SpriteCache> SpriteCache::GetDefault()
+{
+    static auto cache = make_shared<SpriteCache>();
+    return cache;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file Sprite.h
+ * @author Ismail Abdi
+ *
+ * An image shared by every item that displays it.
+ */
+
+#ifndef AQUARIUM_SPRITE_H
+#define AQUARIUM_SPRITE_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AlphaMask.h"
+
+/**
+ * An image shared by every item that displays it.
+ *
+ * Holds the decoded image once, plus lazily built bitmaps for
+ * both orientations and a chain of half-size mip levels used
+ * when the aquarium is zoomed out.
+ *
+ * A sprite can be created before it is decoded so the decoding
+ * can happen on a worker thread. Until it is ready it knows its
+ * size (read from the PNG header), draws as a placeholder outline
+ * and has an empty mask, so nothing can hit or overlap it.
+ */
+class Sprite {
+private:
+    /// One level of the mip chain
+    struct Level {
+        /// The image at this level
+        wxImage mImage;
+
+        /// Bitmaps for the normal [0] and mirrored [1] orientation
+        std::unique_ptr<wxBitmap> mBitmaps[2];
+    };
+
+    /// The image file
+    std::wstring mFilename;
+
+    /// Mip levels; level 0 is the full size image
+    std::vector<std::unique_ptr<Level>> mLevels;
+
+    /// The full size image in level 0. It stays put while levels
+    /// are added, so other threads can read it through this.
+    wxImage *mFullImage = nullptr;
+
+    /// Width of the full size image, known before it is decoded
+    std::atomic<int> mWidth{0};
+
+    /// Height of the full size image, known before it is decoded
+    std::atomic<int> mHeight{0};
+
+    /// Set once the image, masks and colour are all decoded
+    std::atomic<bool> mReady{false};
+
+    /// Makes sure the image is only decoded once
+    std::once_flag mDecodeOnce;
+
+    /// Average colour of the opaque pixels, used for point rendering
+    wxColour mColour;
+
+    /// Opacity of the normal [0] and mirrored [1] full size image
+    AlphaMask mMasks[2];
+
+    void BuildLevel(size_t level);
+
+    void DecodeImage();
+
+public:
+    Sprite(const std::wstring &filename, bool decode = true);
+
+    /// Copy constructor (disabled)
+    Sprite(const Sprite &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const Sprite &) = delete;
+
+    void Decode();
+
+    /**
+     * Has the image been decoded yet?
+     * @return True once the sprite can be drawn
+     */
+    bool IsReady() const { return mReady.load(std::memory_order_acquire); }
+
+    /**
+     * Get the image file this sprite was loaded from
+     * @return Filename
+     */
+    const std::wstring &GetFilename() const { return mFilename; }
+
+    /**
+     * Get the full size image, decoding it now if it isn't ready.
+     * Any thread can read the image once it is decoded.
+     * @return Pointer to the image
+     */
+    wxImage *GetImage()
+    {
+        Decode();
+        return mFullImage;
+    }
+
+    /**
+     * Width of the full size image
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth.load(std::memory_order_relaxed); }
+
+    /**
+     * Height of the full size image
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight.load(std::memory_order_relaxed); }
+
+    const wxColour &GetColour() const;
+
+    const AlphaMask &GetMask(bool mirror) const;
+
+    wxBitmap *GetBitmap(bool mirror, int level = 0);
+
+    void Draw(wxDC *dc, bool mirror, double left, double top, double zoom);
+
+    void Stretch(wxDC *dc, bool mirror, double left, double top, double width, double height);
+
+    int GetLevelCount() const;
+
+    size_t GetByteSize() const;
+
+    static int LevelForZoom(double zoom);
+};
+
+/**
+ * Cache of sprites by filename.
+ */
+class SpriteCache {
+private:
+    /// The loaded sprites
+    std::map<std::wstring, std::shared_ptr<Sprite>> mSprites;
+
+    /// Protects mSprites
+    std::mutex mMutex;
+
+    std::shared_ptr<Sprite> Find(const std::wstring &filename, bool &created);
+
+public:
+    std::shared_ptr<Sprite> Get(const std::wstring &filename);
+
+    std::shared_ptr<Sprite> Preload(const std::wstring &filename);
+
+    /**
+     * Number of sprites loaded
+     * @return Sprite count
+     */
+    size_t GetCount()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSprites.size();
+    }
+
+    size_t GetByteSize();
+
+    static std::shared_ptr<SpriteCache> GetDefault();
+};
+
+#endif //AQUARIUM_SPRITE_H
@@ -0,0 +1,71 @@
+/**
+ * @file StateHash.h
+ * @author Ismail Abdi
+ *
+ * Running hash of simulation state.
+ */
+
+#ifndef AQUARIUM_STATEHASH_H
+#define AQUARIUM_STATEHASH_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Running hash of simulation state.
+ *
+ * Hashes the exact bit patterns of the values added, so two
+ * states only hash the same if they are bit-for-bit identical.
+ */
+class StateHash {
+private:
+    /// The hash so far
+    uint64_t mHash;
+
+public:
+    /// Starting value for an empty hash
+    static const uint64_t Seed = 0xcbf29ce484222325ull;
+
+    /**
+     * Constructor
+     * @param hash Value to start from
+     */
+    explicit StateHash(uint64_t hash = Seed) : mHash(hash) {}
+
+    /**
+     * Add a 64-bit value to the hash
+     * @param value Value to add
+     */
+    void Add(uint64_t value)
+    {
+        // One multiply-xorshift round per word (from splitmix64)
+        mHash ^= value + 0x9e3779b97f4a7c15ull + (mHash << 6) + (mHash >> 2);
+        mHash *= 0xbf58476d1ce4e5b9ull;
+        mHash ^= mHash >> 31;
+    }
+
+    /**
+     * Add a double to the hash
+     * @param value Value to add
+     */
+    void Add(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Add(bits);
+    }
+
+    /**
+     * Add a flag to the hash
+     * @param value Value to add
+     */
+    void Add(bool value) { Add((uint64_t)(value ? 1 : 0)); }
+
+    /**
+     * Get the hash
+     * @return Hash of everything added
+     */
+    uint64_t Get() const { return mHash; }
+};
+
+#endif //AQUARIUM_STATEHASH_H
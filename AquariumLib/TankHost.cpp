@@ -0,0 +1,235 @@
+/**
+ * @file TankHost.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "TankHost.h"
+#include "Aquarium.h"
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param pool Pool to update the tanks on
+ */
+TankHost::TankHost(std::shared_ptr<ThreadPool> pool) : mPool(pool), mLastTick(chrono::steady_clock::now())
+{
+}
+
+/**
+ * Add a new empty tank
+ * @return Index of the new tank
+ */
+size_t TankHost::Add()
+{
+    auto tank = make_unique<Tank>();
+    tank->mAquarium = make_shared<Aquarium>();
+    tank->mAquarium->SetTank(mTanks.size() + 1);
+    if (mMemoryBudget > 0)
+    {
+        tank->mAquarium->SetMemoryBudget(mMemoryBudget);
+    }
+
+    mTanks.push_back(move(tank));
+    return mTanks.size() - 1;
+}
+
+/**
+ * Get the cache every tank's images come from
+ * @return Sprite cache
+ */
+std::shared_ptr<SpriteCache> TankHost::GetSprites() const
+{
+    return SpriteCache::GetDefault();
+}
+
+/**
+ * Estimate the memory every tank is using, by category.
+ *
+ * The tanks share one sprite cache, so its pixels are only
+ * counted once. Call between updates, on the thread that draws.
+ *
+ * @return Bytes in use by all of the tanks
+ */
+MemoryUsage TankHost::GetMemoryUsage() const
+{
+    MemoryUsage total;
+    total.mPixels = GetSprites()->GetByteSize();
+    for (auto &tank : mTanks)
+    {
+        total += tank->mAquarium->GetMemoryUsage(false);
+    }
+
+    return total;
+}
+
+/**
+ * Give every tank, and any added later, a budget for its items.
+ * @param bytes Budget of each tank in bytes, 0 for no limit
+ */
+void TankHost::SetMemoryBudget(size_t bytes)
+{
+    mMemoryBudget = bytes;
+    for (auto &tank : mTanks)
+    {
+        tank->mAquarium->SetMemoryBudget(bytes);
+    }
+}
+
+/**
+ * Memory used by the images of every tank: the shared sprites,
+ * counted once, and each tank's scaled background. Call between
+ * updates, on the thread that draws.
+ * @return Size in bytes
+ */
+size_t TankHost::GetPixelBytes() const
+{
+    size_t bytes = GetSprites()->GetByteSize();
+    for (auto &tank : mTanks)
+    {
+        bytes += tank->mAquarium->GetBackgroundBytes();
+    }
+
+    return bytes;
+}
+
+/**
+ * Reduce the detail of every tank while the images use more than
+ * the pixel budget, so no more mip levels or bitmaps are made for
+ * small items. Bitmaps already made are kept, so once over the
+ * budget the tanks stay at reduced detail until it is raised.
+ */
+void TankHost::CheckPixelBudget()
+{
+    bool reduced = mPixelBudget > 0 && GetPixelBytes() >= mPixelBudget;
+    for (auto &tank : mTanks)
+    {
+        tank->mAquarium->SetReducedDetail(reduced);
+    }
+}
+
+/**
+ * Advance every tank by some wall-clock time.
+ *
+ * Each tank's clock turns the wall-clock time into simulated time
+ * first, then the tanks are updated in parallel. Returns once they
+ * have all been updated. Held tanks are left alone. Call on the
+ * thread that draws.
+ *
+ * @param wallElapsed Wall-clock seconds since the last update
+ */
+void TankHost::Update(double wallElapsed)
+{
+    vector<double> elapsed(mTanks.size());
+    for (size_t i = 0; i < mTanks.size(); i++)
+    {
+        if (!mTanks[i]->mHeld)
+        {
+            elapsed[i] = mTanks[i]->mClock.Advance(wallElapsed);
+        }
+    }
+
+    mPool->ParallelFor(mTanks.size(), 1, [this, &elapsed](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto &tank = *mTanks[i];
+            if (tank.mHeld)
+            {
+                continue;
+            }
+
+            double start = ThreadCpuTime();
+            tank.mAquarium->Update(elapsed[i]);
+            tank.mLastCpuTime = ThreadCpuTime() - start;
+            tank.mCpuTime += tank.mLastCpuTime;
+        }
+    });
+
+    // Images are shared by every tank, so they are budgeted here
+    // rather than by each aquarium, once nothing is updating
+    CheckPixelBudget();
+}
+
+/**
+ * Advance every tank by the wall-clock time since the last tick
+ */
+void TankHost::Tick()
+{
+    auto now = chrono::steady_clock::now();
+    double wallElapsed = chrono::duration<double>(now - mLastTick).count();
+    mLastTick = now;
+    Update(wallElapsed);
+}
+
+/**
+ * Don't count the wall-clock time up to now in the next tick,
+ * after something held up the GUI thread.
+ */
+void TankHost::ResetTime()
+{
+    mLastTick = chrono::steady_clock::now();
+}
+
+/**
+ * Is nothing moving in any tank?
+ *
+ * A tank is still if it is held, its clock is paused with no steps
+ * waiting or none of its items change as time passes, and nothing
+ * has been posted to it.
+ *
+ * @return True if another frame would look the same as the last
+ */
+bool TankHost::IsIdle() const
+{
+    for (auto &tank : mTanks)
+    {
+        if (tank->mHeld)
+        {
+            continue;
+        }
+
+        if (tank->mAquarium->HasPosted() || ((!tank->mClock.IsPaused() || tank->mClock.HasPendingSteps()) && tank->mAquarium->IsAnimated()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * CPU time used by the calling thread
+ * @return CPU seconds since the thread started
+ */
+double TankHost::ThreadCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    {
+        return 0;
+    }
+
+    // FILETIMEs count 100ns intervals
+    auto ticks = [](const FILETIME &time) {
+        return ((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) * 1e-7;
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+    {
+        return 0;
+    }
+
+    return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
@@ -0,0 +1,176 @@
+/**
+ * @file TankHost.h
+ * @author Ismail Abdi
+ *
+ * Runs several aquariums side by side in one process.
+ */
+
+#ifndef AQUARIUM_TANKHOST_H
+#define AQUARIUM_TANKHOST_H
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "SimulationClock.h"
+#include "MemoryUsage.h"
+
+class Aquarium;
+class SpriteCache;
+class ThreadPool;
+
+/**
+ * Runs several aquariums side by side in one process.
+ *
+ * Every tank has its own aquarium and simulation clock, so each
+ * can be paused or sped up on its own. An update advances all of
+ * them at once, one tank per task on the thread pool. The tanks
+ * are independent, so they need no locking between them, and all
+ * of them draw their images from the same sprite cache.
+ *
+ * The CPU time each tank's updates take is measured on the thread
+ * that ran them, so a busy tank shows up even when the pool
+ * hides it in the wall-clock time.
+ */
+class TankHost {
+private:
+    /// One aquarium and its bookkeeping
+    struct Tank {
+        /// The aquarium
+        std::shared_ptr<Aquarium> mAquarium;
+
+        /// Converts wall-clock time into simulated time for this tank
+        SimulationClock mClock;
+
+        /// CPU seconds spent updating this tank in total
+        double mCpuTime = 0;
+
+        /// CPU seconds the last update of this tank took
+        double mLastCpuTime = 0;
+
+        /// True while something else is running this tank
+        bool mHeld = false;
+    };
+
+    /// The tanks
+    std::vector<std::unique_ptr<Tank>> mTanks;
+
+    /// Pool the tanks are updated on
+    std::shared_ptr<ThreadPool> mPool;
+
+    /// Wall-clock time of the last Tick
+    std::chrono::steady_clock::time_point mLastTick;
+
+    /// Memory budget of each tank's items in bytes, 0 for no limit
+    size_t mMemoryBudget = 0;
+
+    /// Most image memory all the tanks together may use at full detail, 0 for no limit
+    size_t mPixelBudget = 0;
+
+    void CheckPixelBudget();
+
+public:
+    explicit TankHost(std::shared_ptr<ThreadPool> pool);
+
+    /// Copy constructor (disabled)
+    TankHost(const TankHost &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const TankHost &) = delete;
+
+    size_t Add();
+
+    /**
+     * Number of tanks
+     * @return Tank count
+     */
+    size_t GetCount() const { return mTanks.size(); }
+
+    /**
+     * Get the pool the tanks are updated on
+     * @return Thread pool
+     */
+    std::shared_ptr<ThreadPool> GetPool() const { return mPool; }
+
+    /**
+     * Get the aquarium in a tank
+     * @param tank Tank index
+     * @return Aquarium
+     */
+    std::shared_ptr<Aquarium> GetAquarium(size_t tank) const { return mTanks[tank]->mAquarium; }
+
+    /**
+     * Get the simulation clock of a tank
+     * @param tank Tank index
+     * @return Clock
+     */
+    SimulationClock &GetClock(size_t tank) { return mTanks[tank]->mClock; }
+
+    /**
+     * CPU time spent updating a tank
+     * @param tank Tank index
+     * @return CPU seconds in total
+     */
+    double GetCpuTime(size_t tank) const { return mTanks[tank]->mCpuTime; }
+
+    /**
+     * CPU time the last update of a tank took
+     * @param tank Tank index
+     * @return CPU seconds
+     */
+    double GetLastCpuTime(size_t tank) const { return mTanks[tank]->mLastCpuTime; }
+
+    /**
+     * Hold a tank while something else runs it forward, like a
+     * video export. Updates skip a held tank, and its clock
+     * doesn't advance, while the other tanks carry on.
+     * @param tank Tank index
+     * @param held True to hold the tank, false to release it
+     */
+    void SetHeld(size_t tank, bool held) { mTanks[tank]->mHeld = held; }
+
+    /**
+     * Is a tank being held?
+     * @param tank Tank index
+     * @return True if updates skip the tank
+     */
+    bool IsHeld(size_t tank) const { return mTanks[tank]->mHeld; }
+
+    std::shared_ptr<SpriteCache> GetSprites() const;
+
+    MemoryUsage GetMemoryUsage() const;
+
+    void SetMemoryBudget(size_t bytes);
+
+    /**
+     * Get the memory budget of each tank's items
+     * @return Budget in bytes, 0 for no limit
+     */
+    size_t GetMemoryBudget() const { return mMemoryBudget; }
+
+    size_t GetPixelBytes() const;
+
+    /**
+     * Set the most image memory the tanks may use together before
+     * they draw small items as points. Checked after each update.
+     * @param bytes Budget in bytes, 0 for no limit
+     */
+    void SetPixelBudget(size_t bytes) { mPixelBudget = bytes; }
+
+    /**
+     * Get the most image memory the tanks may use together at full detail
+     * @return Budget in bytes, 0 for no limit
+     */
+    size_t GetPixelBudget() const { return mPixelBudget; }
+
+    void Update(double wallElapsed);
+
+    void Tick();
+
+    void ResetTime();
+
+    bool IsIdle() const;
+
+    static double ThreadCpuTime();
+};
+
+#endif //AQUARIUM_TANKHOST_H
@@ -0,0 +1,174 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "ThreadPool.h"
+#include <atomic>
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param threads Number of worker threads, or 0 to use one
+ * per hardware thread (less the calling thread)
+ */
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+    {
+        auto hardware = thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < threads; i++)
+    {
+        mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+/**
+ * Destructor. Finishes any queued tasks, then joins the workers.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+
+    for (auto &worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * Body of each worker thread
+ */
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(mMutex);
+            mWake.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+            if (mTasks.empty())
+            {
+                return;
+            }
+
+            task = move(mTasks.front());
+            mTasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+/**
+ * Queue a task to run on one of the workers
+ * @param task The task to run
+ */
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mTasks.push_back(move(task));
+    }
+    mWake.notify_one();
+}
+
+/**
+ * Run body over [0, count) split into chunks of about grain items.
+ *
+ * Returns when every chunk has completed. The chunks may run in
+ * any order and on any thread, including the caller's.
+ *
+ * @param count Number of items
+ * @param grain Minimum items per chunk
+ * @param body Called as body(begin, end) for each chunk
+ */
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body)
+{
+    if (grain == 0)
+    {
+        grain = 1;
+    }
+
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || mWorkers.empty())
+    {
+        if (count > 0)
+        {
+            body(0, count);
+        }
+        return;
+    }
+
+    /// State shared with the helpers, which may outlive this call
+    /// if they are dequeued after all chunks have been claimed
+    struct Loop {
+        atomic<size_t> mNext{0};
+        atomic<size_t> mDone{0};
+        size_t mChunks = 0;
+        size_t mCount = 0;
+        size_t mGrain = 0;
+        const function<void(size_t, size_t)> *mBody = nullptr;
+        mutex mMutex;
+        condition_variable mFinished;
+
+        /// Claim and run chunks until none are left
+        void Run()
+        {
+            for (;;)
+            {
+                size_t chunk = mNext.fetch_add(1);
+                if (chunk >= mChunks)
+                {
+                    return;
+                }
+
+                size_t begin = chunk * mGrain;
+                size_t end = begin + mGrain < mCount ? begin + mGrain : mCount;
+                (*mBody)(begin, end);
+
+                if (mDone.fetch_add(1) + 1 == mChunks)
+                {
+                    lock_guard<mutex> lock(mMutex);
+                    mFinished.notify_all();
+                }
+            }
+        }
+    };
+
+    auto loop = make_shared<Loop>();
+    loop->mChunks = chunks;
+    loop->mCount = count;
+    loop->mGrain = grain;
+    loop->mBody = &body;
+
+    size_t helpers = min(chunks - 1, mWorkers.size());
+    for (size_t i = 0; i < helpers; i++)
+    {
+        Submit([loop] { loop->Run(); });
+    }
+
+    loop->Run();
+
+    unique_lock<mutex> lock(loop->mMutex);
+    loop->mFinished.wait(lock, [&loop] { return loop->mDone.load() == loop->mChunks; });
+}
+
+/**
+ * Get the process-wide pool shared by all aquariums
+ * @return The default pool
+ */
+std::shared_ptr<ThreadPool> ThreadPool::GetDefault()
+{
+    static auto pool = make_shared<ThreadPool>();
+    return pool;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file ThreadPool.h
+ * @author Ismail Abdi
+ *
+ * A small fixed-size pool of worker threads.
+ */
+
+#ifndef AQUARIUM_THREADPOOL_H
+#define AQUARIUM_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A small fixed-size pool of worker threads.
+ *
+ * ParallelFor lets the calling thread claim chunks too, so it
+ * never blocks waiting on work that hasn't started. That makes it
+ * safe to call ParallelFor from inside a task running on the pool.
+ */
+class ThreadPool {
+private:
+    /// The worker threads
+    std::vector<std::thread> mWorkers;
+
+    /// Tasks waiting for a worker
+    std::deque<std::function<void()>> mTasks;
+
+    /// Protects mTasks and mStopping
+    std::mutex mMutex;
+
+    /// Signalled when a task is queued or the pool is stopping
+    std::condition_variable mWake;
+
+    /// True when the destructor has asked the workers to exit
+    bool mStopping = false;
+
+    void WorkerLoop();
+
+public:
+    explicit ThreadPool(unsigned threads = 0);
+
+    virtual ~ThreadPool();
+
+    /// Copy constructor (disabled)
+    ThreadPool(const ThreadPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ThreadPool &) = delete;
+
+    /**
+     * Number of worker threads in the pool
+     * @return Worker count
+     */
+    unsigned GetThreadCount() const { return (unsigned)mWorkers.size(); }
+
+    void Submit(std::function<void()> task);
+
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body);
+
+    static std::shared_ptr<ThreadPool> GetDefault();
+};
+
+#endif //AQUARIUM_THREADPOOL_H
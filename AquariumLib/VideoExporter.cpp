@@ -0,0 +1,308 @@
+/**
+ * @file VideoExporter.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "VideoExporter.h"
+#include "Aquarium.h"
+#include "ThreadPool.h"
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Full range BT.601 luma of a pixel, in 8.8 fixed point
+ * @param rgb The pixel's red, green and blue bytes
+ * @return Luma
+ */
+static inline unsigned char Luma(const unsigned char *rgb)
+{
+    return (unsigned char)((77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2] + 128) >> 8);
+}
+
+/**
+ * Constructor
+ * @param pool Pool to encode the frames on
+ */
+VideoExporter::VideoExporter(std::shared_ptr<ThreadPool> pool) : mPool(pool)
+{
+    // One frame for each worker to encode, and one more waiting
+    mMaxInFlight = max<size_t>(pool->GetThreadCount() + 1, 2);
+}
+
+/**
+ * Destructor. Waits for any frames still being encoded, since
+ * the tasks use this object.
+ */
+VideoExporter::~VideoExporter()
+{
+    while (!mInFlight.empty())
+    {
+        Retire();
+    }
+
+    if (mFile != nullptr)
+    {
+        fclose(mFile);
+    }
+}
+
+/**
+ * Run the simulation and render it to a file.
+ *
+ * The first frame is the aquarium as it is now. Each frame after
+ * that is one fixed timestep further on, so the aquarium is left
+ * frames / frame rate simulated seconds ahead of where it started.
+ *
+ * For a PNG sequence, path is the start of the filenames, and
+ * frame N is written to path-NNNNNN.png. For Y4M it is the video
+ * file. Y4M frames must have an even width and height, so an odd
+ * sized tank loses its last column or row.
+ *
+ * If the progress function cancels the export, the frames already
+ * rendered are still written, and the aquarium is left where the
+ * last of them put it.
+ *
+ * @param aquarium Aquarium to run
+ * @param path Where to write the frames
+ * @param frames Number of frames to write
+ * @return True if every frame was written, false on failure or if cancelled
+ */
+bool VideoExporter::Export(Aquarium &aquarium, const std::string &path, long frames)
+{
+    auto start = chrono::steady_clock::now();
+    mFrames = 0;
+    mRenderTime = 0;
+    mTotalTime = 0;
+    mCancelled = false;
+
+    int width = aquarium.GetWidth();
+    int height = aquarium.GetHeight();
+    if (mFormat == Format::Y4m)
+    {
+        width -= width % 2;
+        height -= height % 2;
+    }
+
+    if (width <= 0 || height <= 0 || mFrameRate <= 0)
+    {
+        return false;
+    }
+
+    if (mFormat == Format::Y4m)
+    {
+        mFile = fopen(path.c_str(), "wb");
+        if (mFile == nullptr)
+        {
+            return false;
+        }
+
+        fprintf(mFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", width, height, mFrameRate);
+    }
+
+    double step = 1.0 / mFrameRate;
+    auto format = mFormat;
+    bool ok = true;
+
+    wxBitmap bitmap(width, height, 24);
+    wxMemoryDC dc;
+    wxBrush background(*wxWHITE);
+    for (long frame = 0; frame < frames && ok; frame++)
+    {
+        auto renderStart = chrono::steady_clock::now();
+
+        // Exported frames can't have placeholders in them
+        aquarium.WaitForImages();
+
+        dc.SelectObject(bitmap);
+        dc.SetBackground(background);
+        dc.Clear();
+        aquarium.OnDraw(&dc);
+        dc.SelectObject(wxNullBitmap);
+        auto image = make_shared<wxImage>(bitmap.ConvertToImage());
+
+        aquarium.Update(step);
+        mRenderTime += chrono::duration<double>(chrono::steady_clock::now() - renderStart).count();
+
+        // Wait for the oldest frame if too many are in flight
+        while (mInFlight.size() >= mMaxInFlight && ok)
+        {
+            ok = Retire();
+        }
+
+        if (!ok)
+        {
+            break;
+        }
+
+        auto pending = make_shared<PendingFrame>();
+        pending->mFrame = frame;
+        mInFlight.push_back(pending);
+
+        mPool->Submit([this, pending, image, path, format] {
+            bool encoded;
+            if (format == Format::PngSequence)
+            {
+                // Failures are reported by the return value
+                wxLogNull noLog;
+                encoded = image->SaveFile(wxString(GetPngFilename(path, pending->mFrame)), wxBITMAP_TYPE_PNG);
+            }
+            else
+            {
+                int w = image->GetWidth();
+                int h = image->GetHeight();
+                pending->mData.resize((size_t)w * h * 3 / 2);
+                ToYuv420(image->GetData(), w, h, pending->mData.data());
+                encoded = true;
+            }
+
+            lock_guard<mutex> lock(mMutex);
+            pending->mOk = encoded;
+            pending->mDone = true;
+            mFinished.notify_all();
+        });
+
+        if (mOnProgress && !mOnProgress(frame + 1, frames))
+        {
+            mCancelled = true;
+            ok = false;
+        }
+    }
+
+    while (!mInFlight.empty())
+    {
+        ok = Retire() && ok;
+    }
+
+    if (mFile != nullptr)
+    {
+        ok = fclose(mFile) == 0 && ok;
+        mFile = nullptr;
+    }
+
+    mTotalTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ok && mFrames == frames;
+}
+
+/**
+ * Load a tank file into an aquarium of its own and render it.
+ *
+ * This is the export without any window, for rendering from the
+ * command line. The aquarium is the size of the background, and
+ * waits for every image before each frame like Export.
+ *
+ * @param tankFile The .aqua file to load
+ * @param path Where to write the frames, as for Export
+ * @param seconds Simulated seconds to render
+ * @return False if the file couldn't be loaded or the export failed
+ */
+bool VideoExporter::ExportFile(const std::wstring &tankFile, const std::string &path, double seconds)
+{
+    mFrames = 0;
+    Aquarium aquarium;
+    if (seconds <= 0 || !aquarium.Load(tankFile))
+    {
+        return false;
+    }
+
+    return Export(aquarium, path, lround(seconds * mFrameRate));
+}
+
+/**
+ * Wait for the oldest frame in flight to be encoded, and
+ * write it if it is a Y4M frame.
+ * @return True if the frame was encoded and written
+ */
+bool VideoExporter::Retire()
+{
+    auto pending = mInFlight.front();
+    mInFlight.pop_front();
+
+    {
+        unique_lock<mutex> lock(mMutex);
+        mFinished.wait(lock, [&pending] { return pending->mDone; });
+    }
+
+    if (!pending->mOk)
+    {
+        return false;
+    }
+
+    if (mFormat == Format::Y4m && mFile != nullptr)
+    {
+        if (fputs("FRAME\n", mFile) < 0 ||
+                fwrite(pending->mData.data(), 1, pending->mData.size(), mFile) != pending->mData.size())
+        {
+            return false;
+        }
+    }
+
+    mFrames++;
+    return true;
+}
+
+/**
+ * Get the filename a frame of a PNG sequence is written to
+ * @param path Start of the filenames
+ * @param frame Frame number
+ * @return Filename
+ */
+std::string VideoExporter::GetPngFilename(const std::string &path, long frame)
+{
+    char number[32];
+    snprintf(number, sizeof(number), "-%06ld.png", frame);
+    return path + number;
+}
+
+/**
+ * Convert an RGB image to planar YUV 4:2:0.
+ *
+ * Uses the full range BT.601 coefficients from JPEG, in 8.8 fixed
+ * point. Each chroma sample is the average of a 2x2 block.
+ *
+ * @param rgb Packed RGB pixels, 3 bytes each
+ * @param width Image width, which must be even
+ * @param height Image height, which must be even
+ * @param yuv Output: width * height luma bytes followed by the
+ * quarter size U and V planes
+ */
+void VideoExporter::ToYuv420(const unsigned char *rgb, int width, int height, unsigned char *yuv)
+{
+    auto luma = yuv;
+    auto u = luma + (size_t)width * height;
+    auto v = u + (size_t)(width / 2) * (height / 2);
+
+    for (int y = 0; y < height; y += 2)
+    {
+        auto row0 = rgb + (size_t)y * width * 3;
+        auto row1 = row0 + (size_t)width * 3;
+        auto luma0 = luma + (size_t)y * width;
+        auto luma1 = luma0 + width;
+
+        for (int x = 0; x < width; x += 2)
+        {
+            int red = 0, green = 0, blue = 0;
+            for (auto p : {row0 + x * 3, row0 + x * 3 + 3, row1 + x * 3, row1 + x * 3 + 3})
+            {
+                red += p[0];
+                green += p[1];
+                blue += p[2];
+            }
+
+            luma0[x] = Luma(row0 + x * 3);
+            luma0[x + 1] = Luma(row0 + x * 3 + 3);
+            luma1[x] = Luma(row1 + x * 3);
+            luma1[x + 1] = Luma(row1 + x * 3 + 3);
+
+            // The sums are four pixels each, so shift by two more bits
+            int cb = (-43 * red - 85 * green + 128 * blue + (128 << 10) + 512) >> 10;
+            int cr = (128 * red - 107 * green - 21 * blue + (128 << 10) + 512) >> 10;
+            *u++ = (unsigned char)min(max(cb, 0), 255);
+            *v++ = (unsigned char)min(max(cr, 0), 255);
+        }
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file VideoExporter.h
+ * @author Ismail Abdi
+ *
+ * Renders a run of the simulation to a PNG sequence or a Y4M video.
+ */
+
+#ifndef AQUARIUM_VIDEOEXPORTER_H
+#define AQUARIUM_VIDEOEXPORTER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Aquarium;
+class ThreadPool;
+
+/**
+ * Renders a run of the simulation to a PNG sequence or a Y4M video.
+ *
+ * The aquarium is updated at a fixed timestep and drawn into an
+ * offscreen bitmap, with no window involved. Drawing has to stay on
+ * the calling thread, but compressing a frame doesn't, so each
+ * rendered frame is handed to the thread pool to encode while the
+ * next one is updated and drawn. A few frames can be in flight at
+ * once; after that the renderer waits for the oldest.
+ *
+ * PNG frames are written by the tasks that encode them. Y4M frames
+ * are converted to YUV 4:2:0 on the pool and written to the file in
+ * order by the calling thread.
+ *
+ * A long export can be watched and cancelled through a progress
+ * callback, which is called on the rendering thread after each
+ * frame is handed off.
+ */
+class VideoExporter {
+public:
+    /// Kinds of output
+    enum class Format {PngSequence, Y4m};
+
+private:
+    /// A frame handed to the pool to encode
+    struct PendingFrame {
+        /// Frame number
+        long mFrame = 0;
+
+        /// Encoded YUV data, for Y4M
+        std::vector<unsigned char> mData;
+
+        /// True once the task has finished with the frame
+        bool mDone = false;
+
+        /// True if the frame was encoded (and for PNG, written)
+        bool mOk = false;
+    };
+
+    /// Pool the frames are encoded on
+    std::shared_ptr<ThreadPool> mPool;
+
+    /// Kind of output
+    Format mFormat = Format::PngSequence;
+
+    /// Frames per second of simulated time
+    int mFrameRate = 30;
+
+    /// Largest number of frames being encoded at once
+    size_t mMaxInFlight;
+
+    /// Frames handed to the pool, oldest first
+    std::deque<std::shared_ptr<PendingFrame>> mInFlight;
+
+    /// Protects the PendingFrame objects while tasks run
+    std::mutex mMutex;
+
+    /// Signalled when a task finishes a frame
+    std::condition_variable mFinished;
+
+    /// The Y4M file being written
+    FILE *mFile = nullptr;
+
+    /// Frames written so far
+    long mFrames = 0;
+
+    /// Wall-clock seconds spent updating and drawing
+    double mRenderTime = 0;
+
+    /// Wall-clock seconds the whole export took
+    double mTotalTime = 0;
+
+    /// Called with the frames rendered so far, returns false to cancel
+    std::function<bool(long frame, long frames)> mOnProgress;
+
+    /// True if the last export was cancelled
+    bool mCancelled = false;
+
+    bool Retire();
+
+public:
+    explicit VideoExporter(std::shared_ptr<ThreadPool> pool);
+
+    virtual ~VideoExporter();
+
+    /// Copy constructor (disabled)
+    VideoExporter(const VideoExporter &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const VideoExporter &) = delete;
+
+    /**
+     * Set the kind of output
+     * @param format PNG sequence or Y4M video
+     */
+    void SetFormat(Format format) { mFormat = format; }
+
+    /**
+     * Get the kind of output
+     * @return Output format
+     */
+    Format GetFormat() const { return mFormat; }
+
+    /**
+     * Set the frame rate. Each frame advances the simulation by
+     * one over this many seconds.
+     * @param rate Frames per second
+     */
+    void SetFrameRate(int rate) { mFrameRate = rate; }
+
+    /**
+     * Get the frame rate
+     * @return Frames per second
+     */
+    int GetFrameRate() const { return mFrameRate; }
+
+    /**
+     * Set a function to call after each frame is rendered. It is
+     * given the frames rendered so far and the total, and returns
+     * false to stop the export.
+     * @param onProgress Function to call, or nullptr for none
+     */
+    void SetOnProgress(std::function<bool(long frame, long frames)> onProgress) { mOnProgress = onProgress; }
+
+    bool Export(Aquarium &aquarium, const std::string &path, long frames);
+
+    bool ExportFile(const std::wstring &tankFile, const std::string &path, double seconds);
+
+    static std::string GetPngFilename(const std::string &path, long frame);
+
+    static void ToYuv420(const unsigned char *rgb, int width, int height, unsigned char *yuv);
+
+    /**
+     * Number of frames written by the last export
+     * @return Frame count
+     */
+    long GetFrames() const { return mFrames; }
+
+    /**
+     * Was the last export cancelled by the progress function?
+     * @return True if cancelled
+     */
+    bool IsCancelled() const { return mCancelled; }
+
+    /**
+     * Wall-clock seconds the last export spent updating and drawing
+     * @return Seconds
+     */
+    double GetRenderTime() const { return mRenderTime; }
+
+    /**
+     * Wall-clock seconds the last export took from start to finish
+     * @return Seconds
+     */
+    double GetTotalTime() const { return mTotalTime; }
+
+    /**
+     * Frames written per wall-clock second by the last export
+     * @return Frames per second
+     */
+    double GetFramesPerSecond() const { return mTotalTime > 0 ? mFrames / mTotalTime : 0; }
+};
+
+#endif //AQUARIUM_VIDEOEXPORTER_H
@@ -0,0 +1,46 @@
+/**
+ * @file Viewport.cpp
+ * @author Ismail Abdi
+ */
+
+#include "pch.h"
+#include "Viewport.h"
+#include <algorithm>
+
+/**
+ * Move the view.
+ * @param dx Screen pixels to drag the picture to the right
+ * @param dy Screen pixels to drag the picture down
+ */
+void Viewport::Pan(double dx, double dy)
+{
+    mX -= dx / mZoom;
+    mY -= dy / mZoom;
+}
+
+/**
+ * Change the zoom, keeping one screen point fixed.
+ * @param zoom New zoom factor, clamped to MinZoom..MaxZoom
+ * @param x Screen X that should show the same aquarium X after
+ * @param y Screen Y that should show the same aquarium Y after
+ */
+void Viewport::SetZoom(double zoom, double x, double y)
+{
+    zoom = std::clamp(zoom, MinZoom, MaxZoom);
+
+    double fixedX = ToAquariumX(x);
+    double fixedY = ToAquariumY(y);
+    mZoom = zoom;
+    mX = fixedX - x / mZoom;
+    mY = fixedY - y / mZoom;
+}
+
+/**
+ * Go back to no pan and no zoom
+ */
+void Viewport::Reset()
+{
+    mX = 0;
+    mY = 0;
+    mZoom = 1;
+}
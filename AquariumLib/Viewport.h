@@ -0,0 +1,144 @@
+/**
+ * @file Viewport.h
+ * @author Ismail Abdi
+ *
+ * The part of the aquarium shown in a view.
+ */
+
+#ifndef AQUARIUM_VIEWPORT_H
+#define AQUARIUM_VIEWPORT_H
+
+/**
+ * The part of the aquarium shown in a view.
+ *
+ * Maps between screen pixels and aquarium pixels for a
+ * pan offset and a zoom factor.
+ */
+class Viewport {
+private:
+    /// Aquarium X at the left edge of the view
+    double mX = 0;
+
+    /// Aquarium Y at the top edge of the view
+    double mY = 0;
+
+    /// Screen pixels per aquarium pixel
+    double mZoom = 1;
+
+    /// Width of the view in screen pixels
+    int mWidth = 0;
+
+    /// Height of the view in screen pixels
+    int mHeight = 0;
+
+public:
+    /// Smallest zoom factor allowed
+    static constexpr double MinZoom = 1.0 / 64;
+
+    /// Largest zoom factor allowed
+    static constexpr double MaxZoom = 8;
+
+    /**
+     * Set the size of the view
+     * @param width Width in screen pixels
+     * @param height Height in screen pixels
+     */
+    void SetSize(int width, int height) { mWidth = width; mHeight = height; }
+
+    /**
+     * Width of the view
+     * @return Width in screen pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Height of the view
+     * @return Height in screen pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Get the zoom factor
+     * @return Screen pixels per aquarium pixel
+     */
+    double GetZoom() const { return mZoom; }
+
+    /**
+     * Aquarium X at the left edge of the view
+     * @return X in aquarium pixels
+     */
+    double GetLeft() const { return mX; }
+
+    /**
+     * Aquarium Y at the top edge of the view
+     * @return Y in aquarium pixels
+     */
+    double GetTop() const { return mY; }
+
+    /**
+     * Aquarium X at the right edge of the view
+     * @return X in aquarium pixels
+     */
+    double GetRight() const { return mX + mWidth / mZoom; }
+
+    /**
+     * Aquarium Y at the bottom edge of the view
+     * @return Y in aquarium pixels
+     */
+    double GetBottom() const { return mY + mHeight / mZoom; }
+
+    /**
+     * Convert a screen X to an aquarium X
+     * @param x X in screen pixels
+     * @return X in aquarium pixels
+     */
+    double ToAquariumX(double x) const { return mX + x / mZoom; }
+
+    /**
+     * Convert a screen Y to an aquarium Y
+     * @param y Y in screen pixels
+     * @return Y in aquarium pixels
+     */
+    double ToAquariumY(double y) const { return mY + y / mZoom; }
+
+    /**
+     * Convert an aquarium X to a screen X
+     * @param x X in aquarium pixels
+     * @return X in screen pixels
+     */
+    double ToScreenX(double x) const { return (x - mX) * mZoom; }
+
+    /**
+     * Convert an aquarium Y to a screen Y
+     * @param y Y in aquarium pixels
+     * @return Y in screen pixels
+     */
+    double ToScreenY(double y) const { return (y - mY) * mZoom; }
+
+    /**
+     * Is any part of a rectangle in the view?
+     * @param left Left edge in aquarium pixels
+     * @param top Top edge in aquarium pixels
+     * @param right Right edge in aquarium pixels
+     * @param bottom Bottom edge in aquarium pixels
+     * @return True if the rectangle overlaps the view
+     */
+    bool IsVisible(double left, double top, double right, double bottom) const
+    {
+        return right >= mX && bottom >= mY && left <= GetRight() && top <= GetBottom();
+    }
+
+    /**
+     * Is the view showing the aquarium at its natural size?
+     * @return True if there is no pan or zoom
+     */
+    bool IsIdentity() const { return mX == 0 && mY == 0 && mZoom == 1; }
+
+    void Pan(double dx, double dy);
+
+    void SetZoom(double zoom, double x, double y);
+
+    void Reset();
+};
+
+#endif //AQUARIUM_VIEWPORT_H
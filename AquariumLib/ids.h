@@ -10,10 +10,28 @@
 
 
 enum IDs {
- IDM_ADDFISHBETA = wxID_HIGHEST + 1,
- IDM_ADDFISHNEMO,
- IDM_ADDFISHGOLDEEN,
- IDM_ADDDECORCASTLE,
+ IDM_ADDSPECIES = wxID_HIGHEST + 1,
+ IDM_ADDSPECIESLAST = IDM_ADDSPECIES + 99,
+ IDM_SCHOOLING,
+ IDM_ZOOMIN,
+ IDM_ZOOMOUT,
+ IDM_ZOOMRESET,
+ IDM_PAUSE,
+ IDM_STEP,
+ IDM_FASTFORWARD,
+ IDM_SPEED,
+ IDM_SPEEDLAST = IDM_SPEED + 7,
+ IDM_RECORD,
+ IDM_STOPRECORDING,
+ IDM_REPLAY,
+ IDM_NEWTANK,
+ IDM_PUBLISHFRAMES,
+ IDM_EXPORTVIDEO,
+ IDM_SAVEMETRICS,
+ IDM_FRAMERATE,
+ IDM_FRAMERATELAST = IDM_FRAMERATE + 7,
+ IDM_MEMORYBUDGET,
+ IDM_IMAGEBUDGET,
 };
 
 
@@ -0,0 +1,88 @@
+/**
+ * @file main.cpp
+ * @author Ismail Abdi
+ *
+ * Reference consumer for frames published by the aquarium.
+ *
+ * Usage: aqframes [name] [frames]
+ *
+ * Maps the shared memory ring (by default /aquarium-tank-1, as
+ * published by View > Publish Frames), follows the newest frame
+ * and reports the frame rate, the latency from publishing to
+ * reading and any frames that were missed or overwritten while
+ * being read. The pixels are read in place; a checksum of each
+ * frame stands in for whatever a real compositor does with them.
+ */
+
+#include <FrameRingReader.h>
+#include <FrameRingWriter.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Program entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char *argv[])
+{
+    string name = argc > 1 ? argv[1] : "/aquarium-tank-1";
+    long frames = argc > 2 ? atol(argv[2]) : 300;
+
+    FrameRingReader reader;
+    while (!reader.Open(name))
+    {
+        printf("Waiting for %s...\n", name.c_str());
+        this_thread::sleep_for(chrono::seconds(1));
+    }
+
+    uint64_t next = reader.GetPublished();
+    long read = 0, missed = 0, torn = 0;
+    double totalLatency = 0, maxLatency = 0;
+    while (read < frames)
+    {
+        FrameRingReader::Frame frame;
+        if (!reader.Latest(frame) || frame.mFrame < next)
+        {
+            this_thread::sleep_for(chrono::microseconds(500));
+            continue;
+        }
+
+        double latency = (FrameRingWriter::Now() - frame.mTimestamp) * 1e-6;
+
+        unsigned long checksum = 0;
+        for (int y = 0; y < frame.mHeight; y++)
+        {
+            const unsigned char *row = frame.mPixels + (size_t)y * frame.mStride;
+            for (int x = 0; x < frame.mWidth * 3; x++)
+            {
+                checksum = checksum * 31 + row[x];
+            }
+        }
+
+        if (!reader.IsCurrent(frame))
+        {
+            torn++;
+            continue;
+        }
+
+        missed += (long)(frame.mFrame - next);
+        next = frame.mFrame + 1;
+        read++;
+        totalLatency += latency;
+        maxLatency = latency > maxLatency ? latency : maxLatency;
+        printf("frame %llu %dx%d checksum %08lx latency %.2f ms\n", (unsigned long long)frame.mFrame,
+                frame.mWidth, frame.mHeight, checksum & 0xffffffff, latency);
+    }
+
+    printf("%ld frames, %ld missed, %ld overwritten while reading, latency %.2f ms average, %.2f ms worst\n",
+            read, missed, torn, totalLatency / read, maxLatency);
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AlphaMask.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Make a mask with random opaque pixels
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param random Random number generator
+ * @param alpha Receives the alpha channel the mask was built from
+ * @return The mask
+ */
+static AlphaMask RandomMask(int width, int height, mt19937 &random, vector<unsigned char> &alpha)
+{
+    uniform_int_distribution<> distribution(0, 255);
+    alpha.resize((size_t)width * height);
+    for (auto &a : alpha)
+    {
+        // Mostly transparent so overlaps are not a foregone conclusion
+        a = distribution(random) > 240 ? 255 : 0;
+    }
+
+    return AlphaMask(width, height, alpha.data());
+}
+
+TEST(AlphaMaskTest, FromAlpha)
+{
+    // A 3x2 image; only alphas at or above 128 count as opaque
+    vector<unsigned char> alpha = {0, 127, 128,
+                                   255, 0, 200};
+    AlphaMask mask(3, 2, alpha.data());
+
+    ASSERT_FALSE(mask.IsOpaque(0, 0));
+    ASSERT_FALSE(mask.IsOpaque(1, 0));
+    ASSERT_TRUE(mask.IsOpaque(2, 0));
+    ASSERT_TRUE(mask.IsOpaque(0, 1));
+    ASSERT_FALSE(mask.IsOpaque(1, 1));
+    ASSERT_TRUE(mask.IsOpaque(2, 1));
+    ASSERT_EQ(3u, mask.CountOpaque());
+
+    // Outside the mask is never opaque
+    ASSERT_FALSE(mask.IsOpaque(-1, 0));
+    ASSERT_FALSE(mask.IsOpaque(3, 0));
+    ASSERT_FALSE(mask.IsOpaque(0, 2));
+}
+
+TEST(AlphaMaskTest, Mirror)
+{
+    mt19937 random(42);
+    vector<unsigned char> alpha;
+    auto mask = RandomMask(125, 117, random, alpha);
+    auto mirror = mask.Mirror();
+
+    ASSERT_EQ(mask.CountOpaque(), mirror.CountOpaque());
+    for (int y = 0; y < 117; y++)
+    {
+        for (int x = 0; x < 125; x++)
+        {
+            ASSERT_EQ(mask.IsOpaque(x, y), mirror.IsOpaque(124 - x, y));
+        }
+    }
+}
+
+TEST(AlphaMaskTest, OverlapsMatchesPixels)
+{
+    mt19937 random(7);
+    vector<unsigned char> alpha1, alpha2;
+    auto mask1 = RandomMask(150, 40, random, alpha1);
+    auto mask2 = RandomMask(70, 30, random, alpha2);
+
+    uniform_int_distribution<> offsetX(-80, 160);
+    uniform_int_distribution<> offsetY(-35, 45);
+    for (int trial = 0; trial < 500; trial++)
+    {
+        int dx = offsetX(random);
+        int dy = offsetY(random);
+
+        bool expected = false;
+        for (int y = 0; y < 30 && !expected; y++)
+        {
+            for (int x = 0; x < 70 && !expected; x++)
+            {
+                expected = mask2.IsOpaque(x, y) && mask1.IsOpaque(x + dx, y + dy);
+            }
+        }
+
+        ASSERT_EQ(expected, mask1.Overlaps(mask2, dx, dy)) << "Offset " << dx << ", " << dy;
+        ASSERT_EQ(expected, mask2.Overlaps(mask1, -dx, -dy)) << "Reversed offset " << dx << ", " << dy;
+    }
+}
+
+TEST(AlphaMaskTest, Benchmark)
+{
+    mt19937 random(1);
+    vector<unsigned char> alpha;
+    auto mask = RandomMask(125, 117, random, alpha);
+
+    const int Tests = 10000000;
+    size_t hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < Tests; i++)
+    {
+        hits += mask.IsOpaque(i % 131, (i / 131) % 121);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Hit tests/sec: " << Tests / seconds << endl;
+    ASSERT_GT(hits, 0u);
+}
@@ -0,0 +1,150 @@
+/**
+ * @file AnimationClipTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <AnimationClip.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <Sprite.h>
+#include <SpeciesRegistry.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+/// The two frames of the Magnemo animation
+const vector<wstring> MagnemoFrames = {L"images/magnemo.png", L"images/magnemo-a.png"};
+
+TEST(AnimationClipTest, FrameAt)
+{
+    AnimationClip clip(make_shared<SpriteCache>(), MagnemoFrames);
+    ASSERT_EQ(2u, clip.GetFrameCount());
+
+    ASSERT_EQ(0u, clip.FrameAt(0));
+    ASSERT_EQ(0u, clip.FrameAt(0.99));
+    ASSERT_EQ(1u, clip.FrameAt(1));
+    ASSERT_EQ(1u, clip.FrameAt(1.5));
+    ASSERT_EQ(0u, clip.FrameAt(2));
+    ASSERT_EQ(1u, clip.FrameAt(1001));
+    ASSERT_EQ(1u, clip.FrameAt(-0.5));
+    ASSERT_EQ(0u, clip.FrameAt(-1.5));
+}
+
+TEST(AnimationClipTest, Lazy)
+{
+    auto sprites = make_shared<SpriteCache>();
+    AnimationClip clip(sprites, MagnemoFrames);
+
+    // Nothing is decoded until it is used
+    ASSERT_EQ(0u, clip.GetDecodedCount());
+    ASSERT_EQ(0u, sprites->GetCount());
+
+    auto frame = clip.GetFrame(1);
+    ASSERT_NE(nullptr, frame);
+    ASSERT_EQ(1u, clip.GetDecodedCount());
+    ASSERT_EQ(sprites->Get(L"images/magnemo-a.png").get(), frame);
+
+    ASSERT_EQ(frame, clip.GetFrame(1));
+    ASSERT_EQ(1u, clip.GetDecodedCount());
+
+    ASSERT_NE(frame, clip.GetFrame(0));
+    ASSERT_EQ(2u, clip.GetDecodedCount());
+}
+
+TEST(AnimationClipTest, Items)
+{
+    auto registry = make_shared<SpeciesRegistry>();
+
+    Species species;
+    species.mName = L"blinker";
+    species.mBehavior = L"fish";
+    species.mFrames = MagnemoFrames;
+    species.mFrameRate = 4;
+    auto blinker = registry->Add(species);
+    ASSERT_NE(nullptr, blinker->mClip);
+    ASSERT_EQ(MagnemoFrames[0], blinker->mImage);
+
+    Aquarium aquarium;
+    aquarium.SetSpecies(registry);
+
+    vector<shared_ptr<Item>> items;
+    for (int i = 0; i < 20; i++)
+    {
+        items.push_back(aquarium.Spawn(L"blinker"));
+    }
+
+    // Every item draws from the same two shared frames, and the
+    // random phases mean both frames are showing at once
+    auto &clip = *blinker->mClip;
+    auto frame0 = clip.GetFrame(0);
+    auto frame1 = clip.GetFrame(1);
+    int showing0 = 0;
+    for (auto &item : items)
+    {
+        auto frame = item->GetFrame();
+        ASSERT_TRUE(frame == frame0 || frame == frame1);
+        if (frame == frame0)
+        {
+            showing0++;
+        }
+    }
+    ASSERT_GT(showing0, 0);
+    ASSERT_LT(showing0, 20);
+
+    // One frame time later every item has moved on a frame
+    vector<Sprite *> before;
+    for (auto &item : items)
+    {
+        before.push_back(item->GetFrame());
+    }
+
+    aquarium.Update(0.25);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        ASSERT_NE(before[i], items[i]->GetFrame());
+    }
+
+    // Items of an unanimated species just use their image
+    auto castle = aquarium.Spawn(L"castle");
+    ASSERT_EQ(castle->GetSprite().get(), castle->GetFrame());
+}
+
+TEST(AnimationClipTest, WaitForImages)
+{
+    // A frame no other test has used, added to the shared cache but
+    // not decoded, the way the asset loader leaves it
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+    auto second = (path + L"/wait-frame.png").ToStdWstring();
+    ASSERT_TRUE(wxCopyFile(MagnemoFrames[1], second));
+    auto sprite = SpriteCache::GetDefault()->Preload(second);
+    ASSERT_FALSE(sprite->IsReady());
+
+    auto registry = make_shared<SpeciesRegistry>();
+    Species species;
+    species.mName = L"waiter";
+    species.mBehavior = L"fish";
+    species.mFrames = {MagnemoFrames[0], second};
+    species.mFrameRate = 4;
+    registry->Add(species);
+
+    Aquarium aquarium;
+    aquarium.SetSpecies(registry);
+    for (int i = 0; i < 20; i++)
+    {
+        aquarium.Spawn(L"waiter");
+    }
+
+    // Whichever frame each item is showing is ready to draw
+    aquarium.WaitForImages();
+    for (auto &item : aquarium.GetItems())
+    {
+        ASSERT_TRUE(item->GetFrame()->IsReady());
+    }
+    ASSERT_TRUE(sprite->IsReady());
+}
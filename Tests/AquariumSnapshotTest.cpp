@@ -0,0 +1,148 @@
+/**
+ * @file AquariumSnapshotTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <AquariumSnapshot.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <SpeciesRegistry.h>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <wx/filename.h>
+
+using namespace std;
+
+/**
+ * Read a whole file
+ * @param filename File to read
+ * @return Contents
+ */
+static string ReadFile(const wxString &filename)
+{
+    ifstream file(filename.ToStdString(), ios::binary);
+    stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST(AquariumSnapshotTest, Sharing)
+{
+    Aquarium aquarium;
+    aquarium.Seed(3);
+
+    // Three full chunks of decor, then one fish on its own
+    for (size_t i = 0; i < AquariumSnapshot::ChunkSize * 3; i++)
+    {
+        aquarium.Spawn(L"castle");
+    }
+    auto fish = aquarium.Spawn(L"nemo");
+
+    // Updating alone doesn't take a snapshot
+    aquarium.Update(0.03);
+    ASSERT_EQ(nullptr, aquarium.GetSnapshot());
+
+    auto first = aquarium.Publish();
+    ASSERT_NE(nullptr, first);
+    ASSERT_EQ(first, aquarium.GetSnapshot());
+    ASSERT_EQ(AquariumSnapshot::ChunkSize * 3 + 1, first->GetCount());
+    ASSERT_EQ(4u, first->GetChunks().size());
+    ASSERT_EQ(fish->GetX(), first->GetItem(first->GetCount() - 1).mX);
+
+    // Only the fish's chunk is copied the next time
+    aquarium.Update(0.03);
+    auto second = aquarium.Publish();
+    ASSERT_EQ(first->GetEpoch() + 1, second->GetEpoch());
+    ASSERT_EQ(3u, second->GetSharedChunks());
+    for (size_t c = 0; c < 3; c++)
+    {
+        ASSERT_EQ(first->GetChunks()[c], second->GetChunks()[c]);
+    }
+    ASSERT_NE(first->GetChunks()[3], second->GetChunks()[3]);
+
+    // The old snapshot still shows where the fish was
+    ASSERT_NE(first->GetItem(first->GetCount() - 1).mX, second->GetItem(second->GetCount() - 1).mX);
+    ASSERT_EQ(fish->GetX(), second->GetItem(second->GetCount() - 1).mX);
+
+    // Without the fish, nothing changes, so the same snapshot is still current
+    aquarium.Remove(fish);
+    aquarium.Update(0.03);
+    auto third = aquarium.Publish();
+    ASSERT_EQ(3u, third->GetSharedChunks());
+    aquarium.Update(0.03);
+    ASSERT_EQ(third, aquarium.Publish());
+}
+
+TEST(AquariumSnapshotTest, Save)
+{
+    Aquarium aquarium;
+    aquarium.Seed(5);
+    for (auto type : {L"beta", L"castle", L"nemo", L"goldeen"})
+    {
+        aquarium.Spawn(type);
+    }
+    aquarium.Update(0.5);
+
+    // A snapshot saved on another thread matches the aquarium saved directly
+    auto path = wxFileName::GetTempDir();
+    auto direct = path + L"/snapshot-direct.aqua";
+    auto threaded = path + L"/snapshot-threaded.aqua";
+    ASSERT_TRUE(aquarium.Save(direct));
+
+    auto snapshot = aquarium.Publish();
+    bool saved = false;
+    thread saver([&] { saved = snapshot->Save(threaded); });
+    saver.join();
+    ASSERT_TRUE(saved);
+    ASSERT_EQ(ReadFile(direct), ReadFile(threaded));
+}
+
+TEST(AquariumSnapshotTest, Concurrent)
+{
+    Aquarium aquarium;
+    aquarium.Seed(9);
+    for (int i = 0; i < 200; i++)
+    {
+        aquarium.Spawn(i % 4 == 0 ? L"castle" : L"beta");
+    }
+    aquarium.Update(0);
+    aquarium.Publish();
+
+    // A reader walks snapshots while the aquarium updates.
+    // Each snapshot it sees is complete and in order.
+    atomic<bool> done{false};
+    bool consistent = true;
+    uint64_t lastEpoch = 0;
+    thread reader([&] {
+        while (!done)
+        {
+            auto snapshot = aquarium.GetSnapshot();
+            size_t count = 0;
+            for (auto &chunk : snapshot->GetChunks())
+            {
+                for (auto &state : *chunk)
+                {
+                    consistent = consistent && state.mSpecies != nullptr;
+                    count++;
+                }
+            }
+            consistent = consistent && count == 200 && snapshot->GetEpoch() >= lastEpoch;
+            lastEpoch = snapshot->GetEpoch();
+        }
+    });
+
+    for (int i = 0; i < 500; i++)
+    {
+        aquarium.Update(1.0 / 30);
+        aquarium.Publish();
+    }
+    done = true;
+    reader.join();
+
+    ASSERT_TRUE(consistent);
+    ASSERT_EQ(500u, aquarium.GetSnapshot()->GetEpoch());
+}
@@ -288,4 +288,76 @@ TEST_F(AquariumTest, Load) {
     TestAllTypes(file3);
 }
 
+TEST_F(AquariumTest, FastForward)
+{
+    Aquarium aquarium;
+    PopulateAllTypes(&aquarium);
+
+    // An hour of simulated time should take well under a minute
+    double rate = aquarium.FastForward(60 * 60, 1.0 / 30);
+    cout << "Simulated seconds per second: " << rate << endl;
+    ASSERT_GT(rate, 60);
+
+    for (auto item : aquarium.GetItems())
+    {
+        ASSERT_GE(item->GetX(), 0);
+        ASSERT_LE(item->GetX(), aquarium.GetWidth());
+        ASSERT_GE(item->GetY(), 0);
+        ASSERT_LE(item->GetY(), aquarium.GetHeight());
+    }
+}
 
+TEST_F(AquariumTest, Revision)
+{
+    Aquarium aquarium;
+    auto castle = aquarium.Spawn(L"castle");
+
+    // Time passing doesn't change a tank of decor
+    auto revision = aquarium.GetRevision();
+    aquarium.Update(1);
+    ASSERT_EQ(revision, aquarium.GetRevision());
+
+    // Dragging, raising and resizing do
+    aquarium.MoveItem(castle, 200, 200);
+    ASSERT_NE(revision, aquarium.GetRevision());
+    revision = aquarium.GetRevision();
+    aquarium.MoveToEnd(castle);
+    ASSERT_NE(revision, aquarium.GetRevision());
+    revision = aquarium.GetRevision();
+    aquarium.SetSize(500, 400);
+    ASSERT_NE(revision, aquarium.GetRevision());
+
+    // Once there is a fish, every update is a change
+    aquarium.Spawn(L"nemo");
+    revision = aquarium.GetRevision();
+    aquarium.Update(0.03);
+    ASSERT_NE(revision, aquarium.GetRevision());
+
+    // Unless no time passed
+    revision = aquarium.GetRevision();
+    aquarium.Update(0);
+    ASSERT_EQ(revision, aquarium.GetRevision());
+
+    aquarium.Clear();
+    ASSERT_NE(revision, aquarium.GetRevision());
+
+    // Loading a file with no items is a change too
+    aquarium.Spawn(L"castle");
+    aquarium.Update(0);
+    revision = aquarium.GetRevision();
+    ASSERT_TRUE(aquarium.LoadData("<aqua/>"));
+    ASSERT_NE(revision, aquarium.GetRevision());
+    ASSERT_TRUE(aquarium.GetItems().empty());
+}
+
+TEST_F(AquariumTest, LoadInvalid)
+{
+    Aquarium aquarium;
+    aquarium.Spawn(L"castle");
+
+    // Neither XML that isn't an aquarium nor text that isn't XML
+    // loads, and the tank keeps what it had
+    ASSERT_FALSE(aquarium.LoadData("<notaqua><item type=\"nemo\"/></notaqua>"));
+    ASSERT_FALSE(aquarium.LoadData("not xml"));
+    ASSERT_EQ(1u, aquarium.GetItems().size());
+}
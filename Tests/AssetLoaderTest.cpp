@@ -0,0 +1,81 @@
+/**
+ * @file AssetLoaderTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <AssetLoader.h>
+#include <Aquarium.h>
+#include <SpeciesRegistry.h>
+#include <Sprite.h>
+#include <ThreadPool.h>
+
+using namespace std;
+
+TEST(AssetLoaderTest, Preload)
+{
+    SpriteCache sprites;
+    auto sprite = sprites.Preload(L"images/beta.png");
+
+    // The size is known before the image is decoded, but
+    // nothing can hit it yet
+    ASSERT_FALSE(sprite->IsReady());
+    ASSERT_EQ(125, sprite->GetWidth());
+    ASSERT_EQ(117, sprite->GetHeight());
+    ASSERT_FALSE(sprite->GetMask(false).IsOpaque(62, 58));
+
+    // Getting it doesn't wait for it
+    ASSERT_EQ(sprite, sprites.Get(L"images/beta.png"));
+    ASSERT_FALSE(sprite->IsReady());
+
+    sprite->Decode();
+    ASSERT_TRUE(sprite->IsReady());
+    ASSERT_TRUE(sprite->GetImage()->IsOk());
+    ASSERT_EQ(125, sprite->GetWidth());
+    ASSERT_TRUE(sprite->GetMask(false).IsOpaque(62, 58));
+
+    // Anything else is decoded as soon as it is asked for
+    ASSERT_TRUE(sprites.Get(L"images/nemo.png")->IsReady());
+}
+
+TEST(AssetLoaderTest, Load)
+{
+    auto sprites = make_shared<SpriteCache>();
+    SpeciesRegistry registry;
+
+    {
+        AssetLoader loader(sprites, make_shared<ThreadPool>(4));
+        loader.Load(registry);
+
+        // Every image is in the cache straight away
+        auto background = sprites->Get(Aquarium::BackgroundImage);
+        ASSERT_EQ(1024, background->GetWidth());
+        ASSERT_EQ(800, background->GetHeight());
+        for (auto &species : registry.GetSpecies())
+        {
+            ASSERT_NE(0, sprites->Get(species->mImage)->GetWidth());
+        }
+
+        loader.Wait();
+        ASSERT_TRUE(loader.IsDone());
+        ASSERT_GT(loader.GetLoadTime(), 0);
+        ASSERT_TRUE(background->IsReady());
+        for (auto &species : registry.GetSpecies())
+        {
+            ASSERT_TRUE(sprites->Get(species->mImage)->IsReady());
+        }
+
+        // Loading them again has nothing to do
+        loader.Load(registry);
+        ASSERT_TRUE(loader.IsDone());
+    }
+
+    // An image that can't be loaded still finishes
+    AssetLoader loader(sprites, make_shared<ThreadPool>(2));
+    loader.Load({L"images/missing.png"});
+    loader.Wait();
+    auto missing = sprites->Get(L"images/missing.png");
+    ASSERT_TRUE(missing->IsReady());
+    ASSERT_EQ(0, missing->GetWidth());
+}
@@ -0,0 +1,301 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <BehaviorScript.h>
+#include <ScriptRunner.h>
+#include <Aquarium.h>
+#include <FishNemo.h>
+#include <FishScripted.h>
+#include <SpeciesRegistry.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Run "vx = expression" for one fish at (3, 4)
+ * @param expression Expression to evaluate
+ * @return The value it gave vx
+ */
+static double Evaluate(const wstring &expression)
+{
+    wstring error;
+    auto script = BehaviorScript::Compile(L"vx = " + expression, error);
+    EXPECT_NE(script, nullptr) << wxString(error);
+    if (script == nullptr)
+    {
+        return NAN;
+    }
+
+    BehaviorScript::Batch batch;
+    script->Prepare(batch, 1);
+    for (size_t v = 0; v < BehaviorScript::BuiltinCount; v++)
+    {
+        batch.Column(v)[0] = 0;
+    }
+    batch.Column(BehaviorScript::X)[0] = 3;
+    batch.Column(BehaviorScript::Y)[0] = 4;
+    script->Run(batch);
+    return batch.Column(BehaviorScript::SpeedX)[0];
+}
+
+/**
+ * Make a registry with a scripted species
+ * @param name Species name
+ * @param script Behaviour script
+ * @return Registry with the built in species and the scripted one
+ */
+static shared_ptr<SpeciesRegistry> ScriptedRegistry(const wstring &name, const wstring &script)
+{
+    auto registry = make_shared<SpeciesRegistry>();
+    Species species = *registry->Find(L"nemo");
+    species.mName = name;
+    species.mBehavior = L"script";
+    species.mScript = script;
+    EXPECT_NE(registry->Add(species), nullptr);
+    return registry;
+}
+
+TEST(BehaviorScriptTest, Errors)
+{
+    const wchar_t *bad[] = {
+        L"x = 1",               // Only vx, vy, dx and dy can be assigned
+        L"vx =",
+        L"vx = 1 +",
+        L"vx = speed",          // Unknown variable
+        L"vx = a; a = 1",       // Read before it is assigned
+        L"vx = sin(1",
+        L"vx = min(1)",
+        L"vx = tan(1)",         // Unknown function
+        L"vx = 1 2",
+        L"vx = (1 + 2",
+        L"= 1"};
+
+    for (auto source : bad)
+    {
+        wstring error;
+        ASSERT_EQ(BehaviorScript::Compile(source, error), nullptr) << wxString(source);
+        ASSERT_FALSE(error.empty());
+    }
+
+    // Empty scripts and comments are fine
+    wstring error;
+    ASSERT_NE(BehaviorScript::Compile(L"", error), nullptr);
+    ASSERT_NE(BehaviorScript::Compile(L"# nothing\n\n  ;", error), nullptr);
+}
+
+TEST(BehaviorScriptTest, Expressions)
+{
+    ASSERT_DOUBLE_EQ(Evaluate(L"1 + 2 * 3"), 7);
+    ASSERT_DOUBLE_EQ(Evaluate(L"(1 + 2) * 3"), 9);
+    ASSERT_DOUBLE_EQ(Evaluate(L"10 - 4 - 3"), 3);
+    ASSERT_DOUBLE_EQ(Evaluate(L"8 / 4 / 2"), 1);
+    ASSERT_DOUBLE_EQ(Evaluate(L"-2 * -x"), 6);
+    ASSERT_DOUBLE_EQ(Evaluate(L"1.5e1"), 15);
+
+    ASSERT_DOUBLE_EQ(Evaluate(L"x < y"), 1);
+    ASSERT_DOUBLE_EQ(Evaluate(L"x >= y"), 0);
+    ASSERT_DOUBLE_EQ(Evaluate(L"x <= 3"), 1);
+    ASSERT_DOUBLE_EQ(Evaluate(L"x != 3"), 0);
+    ASSERT_DOUBLE_EQ(Evaluate(L"x == 3 ? 10 : 20"), 10);
+    ASSERT_DOUBLE_EQ(Evaluate(L"x > y ? 10 : y > 3 ? 30 : 40"), 30);
+
+    ASSERT_DOUBLE_EQ(Evaluate(L"sqrt(x * x + y * y)"), 5);
+    ASSERT_NEAR(Evaluate(L"sin(0) + cos(0)"), 1, 1e-10);
+    ASSERT_DOUBLE_EQ(Evaluate(L"abs(x - y)"), 1);
+    ASSERT_DOUBLE_EQ(Evaluate(L"min(x, y) + max(x, y)"), 7);
+    ASSERT_DOUBLE_EQ(Evaluate(L"clamp(10, 0, y)"), 4);
+    ASSERT_DOUBLE_EQ(Evaluate(L"clamp(-10, 0, y)"), 0);
+}
+
+TEST(BehaviorScriptTest, Batch)
+{
+    wstring error;
+    auto script = BehaviorScript::Compile(L"twice = x * 2\nvx = twice + 1; vy = twice * y", error);
+    ASSERT_NE(script, nullptr) << wxString(error);
+    ASSERT_EQ(script->GetVariableCount(), BehaviorScript::BuiltinCount + 1);
+    ASSERT_FALSE(script->UsesNeighbors());
+
+    BehaviorScript::Batch batch;
+    script->Prepare(batch, 100);
+    ASSERT_EQ(batch.GetCount(), 100u);
+    for (size_t i = 0; i < 100; i++)
+    {
+        batch.Column(BehaviorScript::X)[i] = (double)i;
+        batch.Column(BehaviorScript::Y)[i] = 2;
+    }
+
+    script->Run(batch);
+    for (size_t i = 0; i < 100; i++)
+    {
+        ASSERT_DOUBLE_EQ(batch.Column(BehaviorScript::SpeedX)[i], i * 2.0 + 1);
+        ASSERT_DOUBLE_EQ(batch.Column(BehaviorScript::SpeedY)[i], i * 4.0);
+    }
+
+    ASSERT_TRUE(BehaviorScript::Compile(L"vx = vx + nvx", error)->UsesNeighbors());
+}
+
+TEST(BehaviorScriptTest, MatchesFish)
+{
+    // A script that does nothing swims like a plain fish
+    Aquarium aquarium;
+    aquarium.SetSize(800, 600);
+    aquarium.SetSpecies(ScriptedRegistry(L"plain", L""));
+
+    auto scripted = dynamic_pointer_cast<Fish>(aquarium.CreateItem(L"plain"));
+    auto plain = make_shared<Fish>(&aquarium, aquarium.GetSpecies()->Find(L"plain"));
+    ASSERT_NE(dynamic_pointer_cast<FishScripted>(scripted), nullptr);
+    aquarium.Add(scripted);
+    aquarium.Add(plain);
+    aquarium.WaitForImages();
+
+    for (auto fish : {scripted, plain})
+    {
+        fish->SetLocation(300, 200);
+        fish->SetSpeed(80, 25);
+    }
+
+    for (int i = 0; i < 1000; i++)
+    {
+        aquarium.Update(0.03);
+        ASSERT_DOUBLE_EQ(scripted->GetX(), plain->GetX()) << "Tick " << i;
+        ASSERT_DOUBLE_EQ(scripted->GetY(), plain->GetY()) << "Tick " << i;
+        ASSERT_EQ(scripted->IsMirror(), plain->IsMirror()) << "Tick " << i;
+    }
+}
+
+TEST(BehaviorScriptTest, Retune)
+{
+    // Tuning a species' script changes how the fish already swimming move
+    Aquarium aquarium;
+    aquarium.SetSize(1000, 1000);
+    auto registry = ScriptedRegistry(L"drifter", L"vx = 0; vy = 0");
+    aquarium.SetSpecies(registry);
+
+    auto fish = aquarium.Spawn(L"drifter");
+    fish->SetLocation(500, 500);
+    aquarium.Update(0.03);
+    ASSERT_DOUBLE_EQ(500, fish->GetX());
+
+    Species tuned = *registry->Find(L"drifter");
+    tuned.mScript = L"vx = 0; vy = 0; dx = 10";
+    ASSERT_NE(registry->Add(tuned), nullptr);
+    aquarium.Update(0.03);
+    ASSERT_DOUBLE_EQ(510, fish->GetX());
+}
+
+TEST(BehaviorScriptTest, Neighbors)
+{
+    Aquarium aquarium;
+    aquarium.SetSize(1000, 1000);
+    aquarium.SetSpecies(ScriptedRegistry(L"counter", L"vx = n; vy = nx"));
+
+    const double locations[][2] = {{200, 200}, {250, 200}, {800, 800}};
+    vector<shared_ptr<Fish>> fish;
+    for (auto &location : locations)
+    {
+        auto item = dynamic_pointer_cast<Fish>(aquarium.Spawn(L"counter"));
+        item->SetLocation(location[0], location[1]);
+        fish.push_back(item);
+    }
+
+    aquarium.Update(0.03);
+    ASSERT_DOUBLE_EQ(fish[0]->GetSpeedX(), 1);
+    ASSERT_DOUBLE_EQ(fish[0]->GetSpeedY(), 30);     // 50 to the right, but limited to 30
+    ASSERT_DOUBLE_EQ(fish[1]->GetSpeedX(), 1);
+    ASSERT_DOUBLE_EQ(fish[1]->GetSpeedY(), -30);
+    ASSERT_DOUBLE_EQ(fish[2]->GetSpeedX(), 0);
+    ASSERT_DOUBLE_EQ(fish[2]->GetSpeedY(), 0);
+
+    // Nothing moves while paused
+    auto x = fish[0]->GetX();
+    aquarium.Update(0);
+    ASSERT_EQ(fish[0]->GetX(), x);
+}
+
+TEST(BehaviorScriptTest, NotANumber)
+{
+    // Scripts that make NaN and infinity don't lose the fish
+    Aquarium aquarium;
+    aquarium.SetSize(1000, 1000);
+    aquarium.SetSchooling(true);
+    aquarium.SetSpecies(ScriptedRegistry(L"broken", L"vx = sqrt(vx - 100); vy = vy / 0; dx = 0 / 0; dy = n / 0"));
+
+    vector<shared_ptr<Item>> fish;
+    for (int i = 0; i < 10; i++)
+    {
+        auto item = aquarium.Spawn(L"broken");
+        item->SetLocation(200 + i * 20, 300);
+        fish.push_back(item);
+    }
+
+    for (int tick = 0; tick < 100; tick++)
+    {
+        aquarium.Update(0.03);
+    }
+
+    for (auto &item : fish)
+    {
+        ASSERT_TRUE(isfinite(item->GetX()));
+        ASSERT_TRUE(isfinite(item->GetY()));
+    }
+}
+
+TEST(BehaviorScriptTest, Benchmark)
+{
+    // The Nemo wave as a script, against the native FishNemo::Update
+    const size_t count = 2000;
+    const int updates = 200;
+    const double elapsed = 0.03;
+
+    Aquarium aquarium;
+    aquarium.SetSize(1600, 900);
+    aquarium.SetSpecies(ScriptedRegistry(L"scripted-nemo", L"dy = amplitude * sin(frequency * x * 0.01) * dt"));
+
+    vector<shared_ptr<Item>> native, scripted;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto nemo = make_shared<FishNemo>(&aquarium);
+        nemo->SetLocation(100 + i % 1400, 100 + i % 700);
+        native.push_back(nemo);
+
+        auto script = aquarium.CreateItem(L"scripted-nemo");
+        script->SetLocation(100 + i % 1400, 100 + i % 700);
+        scripted.push_back(script);
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int u = 0; u < updates; u++)
+    {
+        for (auto &item : native)
+        {
+            item->Update(elapsed);
+        }
+    }
+    auto middle = chrono::steady_clock::now();
+
+    ScriptRunner runner;
+    runner.Group(scripted);
+    for (int u = 0; u < updates; u++)
+    {
+        runner.Run(u * elapsed, elapsed, aquarium.GetWidth(), aquarium.GetHeight());
+    }
+    auto end = chrono::steady_clock::now();
+
+    double fishUpdates = (double)count * updates;
+    double nativeTime = chrono::duration<double, nano>(middle - start).count() / fishUpdates;
+    double scriptTime = chrono::duration<double, nano>(end - middle).count() / fishUpdates;
+    cout << "Native FishNemo::Update: " << nativeTime << " ns per fish" << endl;
+    cout << "Scripted Nemo: " << scriptTime << " ns per fish ("
+         << scriptTime / nativeTime << "x native)" << endl;
+
+    ASSERT_EQ(runner.GetCount(), count);
+
+    // Both swim within the tank
+    for (auto &item : scripted)
+    {
+        ASSERT_GE(item->GetY(), 0);
+        ASSERT_LE(item->GetY(), aquarium.GetHeight());
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file CommandQueueTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <CommandQueue.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(CommandQueueTest, Order)
+{
+    CommandQueue<int> queue;
+    ASSERT_TRUE(queue.IsEmpty());
+    ASSERT_EQ(0u, queue.Drain([](int) {}));
+
+    for (int i = 0; i < 5; i++)
+    {
+        queue.Push(i);
+    }
+    ASSERT_FALSE(queue.IsEmpty());
+
+    // Commands come out in the order they went in
+    vector<int> drained;
+    ASSERT_EQ(5u, queue.Drain([&drained](int command) { drained.push_back(command); }));
+    ASSERT_EQ((vector<int>{0, 1, 2, 3, 4}), drained);
+    ASSERT_TRUE(queue.IsEmpty());
+
+    // Anything left is freed with the queue
+    auto shared = make_shared<int>(1);
+    {
+        CommandQueue<shared_ptr<int>> owner;
+        owner.Push(shared);
+        ASSERT_EQ(2, shared.use_count());
+    }
+    ASSERT_EQ(1, shared.use_count());
+}
+
+TEST(CommandQueueTest, Concurrent)
+{
+    const int Producers = 4;
+    const int PerProducer = 20000;
+
+    // Each command is a producer number and a sequence number
+    CommandQueue<pair<int, int>> queue;
+    vector<thread> producers;
+    for (int p = 0; p < Producers; p++)
+    {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PerProducer; i++)
+            {
+                queue.Push({p, i});
+            }
+        });
+    }
+
+    // Drain while they push. Each producer's commands arrive
+    // exactly once and in the order it pushed them.
+    vector<int> next(Producers, 0);
+    bool ordered = true;
+    int total = 0;
+    auto handle = [&](const pair<int, int> &command) {
+        ordered = ordered && command.second == next[command.first];
+        next[command.first] = command.second + 1;
+        total++;
+    };
+
+    while (total < Producers * PerProducer)
+    {
+        queue.Drain(handle);
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(Producers * PerProducer, total);
+    ASSERT_TRUE(queue.IsEmpty());
+}
+
+TEST(CommandQueueTest, Aquarium)
+{
+    Aquarium aquarium;
+    aquarium.Seed(7);
+
+    // Posts from other threads wait for the next update
+    thread spawner([&aquarium] {
+        for (int i = 0; i < 10; i++)
+        {
+            aquarium.Post([](Aquarium &a) { a.Spawn(L"nemo"); });
+        }
+        aquarium.Post([](Aquarium &a) { a.Spawn(L"castle"); });
+    });
+    spawner.join();
+
+    ASSERT_TRUE(aquarium.HasPosted());
+    ASSERT_EQ(0u, aquarium.GetItems().size());
+
+    aquarium.Update(0);
+    ASSERT_FALSE(aquarium.HasPosted());
+    ASSERT_EQ(11u, aquarium.GetItems().size());
+
+    // Moves and removes go through the same way
+    auto castle = aquarium.GetItems().back();
+    aquarium.Post([castle](Aquarium &a) { a.MoveItem(castle, 300, 250); });
+    aquarium.Post([castle](Aquarium &a) { a.MoveToEnd(castle); });
+    aquarium.Update(0);
+    ASSERT_DOUBLE_EQ(300, castle->GetX());
+    ASSERT_DOUBLE_EQ(250, castle->GetY());
+
+    aquarium.Post([castle](Aquarium &a) { a.Remove(castle); });
+    aquarium.Update(0);
+    ASSERT_EQ(10u, aquarium.GetItems().size());
+
+    // Whatever runs the updates hears about each post
+    atomic<int> posted{0};
+    aquarium.SetOnPosted([&posted] { posted++; });
+    thread poster([&aquarium] { aquarium.Post([](Aquarium &a) { a.Clear(); }); });
+    poster.join();
+    ASSERT_EQ(1, posted);
+    ASSERT_EQ(10u, aquarium.GetItems().size());
+    aquarium.Update(0);
+    ASSERT_TRUE(aquarium.GetItems().empty());
+}
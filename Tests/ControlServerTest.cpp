@@ -0,0 +1,215 @@
+/**
+ * @file ControlServerTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <ControlServer.h>
+#include <Metrics.h>
+#include <TankHost.h>
+#include <Aquarium.h>
+#include <ThreadPool.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <wx/filename.h>
+
+using namespace std;
+
+/**
+ * Send a request to a server on this machine
+ * @param port Port the server listens on
+ * @param method HTTP method
+ * @param target Path and query
+ * @param body Output: body of the response
+ * @return HTTP status code, or 0 if there was no response
+ */
+static int Request(int port, const string &method, const string &target, string &body)
+{
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    if (connect(client, (sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(client);
+        return 0;
+    }
+
+    auto request = method + " " + target + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+    send(client, request.data(), request.size(), 0);
+
+    string response;
+    char buffer[1024];
+    ssize_t received;
+    while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0)
+    {
+        response.append(buffer, received);
+    }
+    close(client);
+
+    auto headerEnd = response.find("\r\n\r\n");
+    if (response.compare(0, 9, "HTTP/1.0 ") != 0 || headerEnd == string::npos)
+    {
+        return 0;
+    }
+
+    body = response.substr(headerEnd + 4);
+    return stoi(response.substr(9, 3));
+}
+
+TEST(ControlServerTest, Percentiles)
+{
+    vector<double> times;
+    for (int i = 1; i <= 100; i++)
+    {
+        times.push_back(i / 1000.0);
+    }
+
+    // Nearest rank: half of 1..100 are no bigger than 50
+    auto percentiles = ControlServer::Measure(times);
+    ASSERT_NEAR(50, percentiles.mP50, 0.0001);
+    ASSERT_NEAR(95, percentiles.mP95, 0.0001);
+    ASSERT_NEAR(99, percentiles.mP99, 0.0001);
+
+    // With too few times to tell apart, the percentiles round up
+    percentiles = ControlServer::Measure({0.003, 0.001, 0.002});
+    ASSERT_NEAR(2, percentiles.mP50, 0.0001);
+    ASSERT_NEAR(3, percentiles.mP95, 0.0001);
+    ASSERT_NEAR(1, ControlServer::Measure({0.001}).mP99, 0.0001);
+
+    ASSERT_EQ(0, ControlServer::Measure({}).mP99);
+}
+
+TEST(ControlServerTest, Status)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    host.Add();
+    host.GetAquarium(1)->Spawn(L"beta");
+    host.GetAquarium(1)->Spawn(L"beta");
+    host.GetAquarium(1)->Spawn(L"castle");
+    host.GetClock(1).SetSpeed(2);
+
+    ControlServer server;
+    ASSERT_TRUE(server.Start(0));
+    ASSERT_NE(0, server.GetPort());
+
+    string body;
+    ASSERT_EQ(200, Request(server.GetPort(), "GET", "/status", body));
+    ASSERT_EQ("{\"frame_ms\":{\"p50\":0,\"p95\":0,\"p99\":0},\"tanks\":[]}", body);
+
+    host.Update(0.03);
+    server.Sample(host);
+    server.Publish(host);
+
+    ASSERT_EQ(200, Request(server.GetPort(), "GET", "/tanks/2", body));
+    ASSERT_NE(string::npos, body.find("\"tank\":2,")) << body;
+    ASSERT_NE(string::npos, body.find("\"items\":3,")) << body;
+    ASSERT_NE(string::npos, body.find("\"species\":{\"beta\":2,\"castle\":1}")) << body;
+    ASSERT_NE(string::npos, body.find("\"speed\":2,")) << body;
+    ASSERT_NE(string::npos, body.find("\"update_ms\":{\"p50\":")) << body;
+
+    // Items come from the snapshot the tank published
+    ASSERT_EQ(200, Request(server.GetPort(), "GET", "/tanks/2/items", body));
+    ASSERT_EQ(0u, body.find("{\"epoch\":")) << body;
+    ASSERT_NE(string::npos, body.find("{\"type\":\"castle\",\"x\":")) << body;
+    ASSERT_EQ(405, Request(server.GetPort(), "POST", "/tanks/2/items", body));
+
+    ASSERT_EQ(200, Request(server.GetPort(), "GET", "/status", body));
+    ASSERT_NE(string::npos, body.find("\"tank\":1,")) << body;
+    ASSERT_NE(string::npos, body.find("\"tank\":2,")) << body;
+
+    ASSERT_EQ(404, Request(server.GetPort(), "GET", "/tanks/3", body));
+    ASSERT_EQ(404, Request(server.GetPort(), "GET", "/tanks/x", body));
+    ASSERT_EQ(404, Request(server.GetPort(), "GET", "/fish", body));
+    ASSERT_EQ(405, Request(server.GetPort(), "POST", "/status", body));
+    ASSERT_EQ(8, server.GetRequests());
+
+    server.Stop();
+    ASSERT_FALSE(server.IsRunning());
+    ASSERT_EQ(0, Request(server.GetPort(), "GET", "/status", body));
+}
+
+TEST(ControlServerTest, Commands)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    auto aquarium = host.GetAquarium(0);
+
+    ControlServer server;
+    ASSERT_TRUE(server.Start(0));
+    server.Publish(host);
+    auto port = server.GetPort();
+
+    string body;
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/spawn?species=nemo&count=3", body));
+    ASSERT_EQ("{\"queued\":true}", body);
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/spawn?species=castle", body));
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/pause", body));
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/speed?value=4", body));
+    ASSERT_EQ(400, Request(port, "POST", "/tanks/1/speed?value=-1", body));
+    ASSERT_EQ(400, Request(port, "POST", "/tanks/1/spawn", body));
+    ASSERT_EQ(404, Request(port, "POST", "/tanks/1/explode", body));
+    ASSERT_EQ(405, Request(port, "GET", "/tanks/1/clear", body));
+
+    // Nothing changes until the GUI thread applies the commands
+    ASSERT_TRUE(aquarium->GetItems().empty());
+    ASSERT_EQ(4u, server.Apply(host));
+    ASSERT_EQ(4u, aquarium->GetItems().size());
+    ASSERT_TRUE(host.GetClock(0).IsPaused());
+    ASSERT_EQ(4, host.GetClock(0).GetSpeed());
+    ASSERT_EQ(0u, server.Apply(host));
+
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/remove?species=nemo&count=2", body));
+    server.Apply(host);
+    server.Publish(host);
+    ASSERT_EQ(200, Request(port, "GET", "/tanks/1", body));
+    ASSERT_NE(string::npos, body.find("\"species\":{\"castle\":1,\"nemo\":1}")) << body;
+    ASSERT_NE(string::npos, body.find("\"paused\":true")) << body;
+
+    // Save, clear and load back, with an escaped filename
+    auto filename = wxFileName::GetTempDir() + L"/control api.aqua";
+    auto escaped = filename.ToStdString();
+    for (auto space = escaped.find(' '); space != string::npos; space = escaped.find(' '))
+    {
+        escaped.replace(space, 1, "%20");
+    }
+
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/save?file=" + escaped, body));
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/clear", body));
+    ASSERT_EQ(2u, server.Apply(host));
+    ASSERT_TRUE(aquarium->GetItems().empty());
+
+    // The save is written on the pool, from the items as they were before the clear
+    while (server.IsSaving())
+    {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(wxFileName::FileExists(filename));
+
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/load?file=" + escaped, body));
+    ASSERT_EQ(202, Request(port, "POST", "/tanks/1/pause?on=0", body));
+    server.Apply(host);
+    ASSERT_EQ(2u, aquarium->GetItems().size());
+    ASSERT_FALSE(host.GetClock(0).IsPaused());
+}
+
+TEST(ControlServerTest, Metrics)
+{
+    auto metrics = make_shared<Metrics>();
+    metrics->Counter("test_requests_total", "Requests").Add(3);
+
+    ControlServer server(metrics);
+    ASSERT_TRUE(server.Start(0));
+
+    string body;
+    ASSERT_EQ(200, Request(server.GetPort(), "GET", "/metrics", body));
+    ASSERT_EQ("# HELP test_requests_total Requests\n# TYPE test_requests_total counter\ntest_requests_total 3\n", body);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file DivergenceCheckerTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <DivergenceChecker.h>
+#include <ThreadPool.h>
+
+using namespace std;
+
+/// Simulated seconds per tick
+const double TickTime = 1.0 / 30;
+
+/// Item types spawned by the tests, in order
+const wchar_t *SpawnTypes[] = {L"beta", L"nemo", L"goldeen", L"castle"};
+
+/**
+ * Fill an aquarium with a mix of items
+ * @param aquarium Aquarium to fill
+ * @param count Number of items to add
+ */
+static void Populate(Aquarium &aquarium, int count)
+{
+    aquarium.Seed(7);
+    for (int i = 0; i < count; i++)
+    {
+        aquarium.Spawn(SpawnTypes[i % 4]);
+    }
+}
+
+TEST(DivergenceCheckerTest, ParallelSchoolingMatchesSerial)
+{
+    Aquarium reference;
+    Aquarium candidate;
+    Populate(reference, 300);
+    Populate(candidate, 300);
+
+    reference.GetSchool().SetThreadPool(nullptr);
+    reference.SetSchooling(true);
+
+    candidate.GetSchool().SetThreadPool(make_shared<ThreadPool>(4));
+    candidate.GetSchool().SetParallelThreshold(1);
+    candidate.SetSchooling(true);
+
+    DivergenceChecker checker(reference, candidate);
+    ASSERT_TRUE(checker.Run(300, TickTime)) << "Diverged at tick " << checker.GetTick()
+            << " item " << checker.GetItem();
+    ASSERT_FALSE(checker.HasDiverged());
+    ASSERT_EQ(300, checker.GetTicks());
+}
+
+TEST(DivergenceCheckerTest, FindsItem)
+{
+    Aquarium reference;
+    Aquarium candidate;
+    Populate(reference, 8);
+    Populate(candidate, 8);
+
+    DivergenceChecker checker(reference, candidate);
+    ASSERT_TRUE(checker.Run(10, TickTime));
+
+    // The smallest change to one fish is caught on the next tick
+    auto fish = candidate.GetItems()[5];
+    fish->SetLocation(fish->GetX() + 1e-9, fish->GetY());
+
+    ASSERT_FALSE(checker.Run(10, TickTime));
+    ASSERT_TRUE(checker.HasDiverged());
+    ASSERT_EQ(11, checker.GetTick());
+    ASSERT_EQ(5, checker.GetItem());
+
+    // Once diverged the checker stops running
+    ASSERT_FALSE(checker.Run(10, TickTime));
+    ASSERT_EQ(11, checker.GetTicks());
+}
+
+TEST(DivergenceCheckerTest, ZOrder)
+{
+    Aquarium reference;
+    Aquarium candidate;
+    Populate(reference, 4);
+    Populate(candidate, 4);
+
+    candidate.MoveToEnd(candidate.GetItems()[1]);
+
+    DivergenceChecker checker(reference, candidate);
+    ASSERT_FALSE(checker.Run(1, TickTime));
+    ASSERT_EQ(0, checker.GetTick());
+    ASSERT_EQ(1, checker.GetItem());
+}
+
+TEST(DivergenceCheckerTest, ItemCount)
+{
+    Aquarium reference;
+    Aquarium candidate;
+    Populate(reference, 4);
+    Populate(candidate, 5);
+
+    DivergenceChecker checker(reference, candidate);
+    ASSERT_FALSE(checker.Check());
+    ASSERT_EQ(0, checker.GetTick());
+    ASSERT_EQ(4, checker.GetItem());
+}
@@ -0,0 +1,117 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <FastMath.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+TEST(FastMathTest, Accuracy)
+{
+    double worst = 0;
+
+    // Densely over the angles wave motion uses
+    for (double x = -100; x < 100; x += 0.0001)
+    {
+        worst = max(worst, fabs(FastSin(x) - sin(x)));
+        worst = max(worst, fabs(FastCos(x) - cos(x)));
+    }
+
+    // Around the points where the reduction changes
+    for (int k = -1000; k <= 1000; k++)
+    {
+        for (double x : {k * TwoPi / 4, nextafter(k * TwoPi / 4, 0.0), nextafter(k * TwoPi / 4, 1e9)})
+        {
+            worst = max(worst, fabs(FastSin(x) - sin(x)));
+            worst = max(worst, fabs(FastCos(x) - cos(x)));
+        }
+    }
+
+    // And randomly over the whole range
+    mt19937 random;
+    uniform_real_distribution<> distribution(-FastSinRange, FastSinRange);
+    for (int i = 0; i < 1000000; i++)
+    {
+        double x = distribution(random);
+        worst = max(worst, fabs(FastSin(x) - sin(x)));
+        worst = max(worst, fabs(FastCos(x) - cos(x)));
+    }
+
+    cout << "Largest error: " << worst << endl;
+    ASSERT_LT(worst, FastSinMaxError);
+
+    // Zero and odd symmetry are exact
+    ASSERT_EQ(FastSin(0), 0);
+    ASSERT_EQ(FastSin(-0.25), -FastSin(0.25));
+    ASSERT_NEAR(FastCos(0), 1, FastSinMaxError);
+}
+
+TEST(FastMathTest, Arrays)
+{
+    vector<double> x(1001), result(x.size());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        x[i] = i * 0.37 - 150;
+    }
+
+    FastSin(x.data(), result.data(), x.size());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        ASSERT_EQ(result[i], FastSin(x[i]));
+    }
+
+    // In place
+    FastCos(x.data(), x.data(), x.size());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        ASSERT_EQ(x[i], FastCos(i * 0.37 - 150));
+    }
+}
+
+TEST(FastMathTest, Benchmark)
+{
+    // A wave phase for each of 100k fish
+    const size_t count = 100000;
+    const int repeats = 50;
+    vector<double> phase(count), result(count);
+    mt19937 random;
+    uniform_real_distribution<> distribution(0, TwoPi);
+    for (auto &p : phase)
+    {
+        p = distribution(random);
+    }
+
+    double check = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            result[i] = sin(phase[i] + r);
+        }
+        check += result[r];
+    }
+    auto middle = chrono::steady_clock::now();
+
+    for (int r = 0; r < repeats; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            result[i] = FastSin(phase[i] + r);
+        }
+        check -= result[r];
+    }
+    auto end = chrono::steady_clock::now();
+
+    double values = (double)count * repeats;
+    double stdTime = chrono::duration<double, nano>(middle - start).count() / values;
+    double fastTime = chrono::duration<double, nano>(end - middle).count() / values;
+    cout << "std::sin: " << stdTime << " ns, FastSin: " << fastTime << " ns ("
+         << stdTime / fastTime << "x faster)" << endl;
+
+    ASSERT_NEAR(check, 0, repeats * FastSinMaxError);
+}
@@ -41,4 +41,18 @@ TEST(FishBetaTest, HitTest) {
 
  // Test: On a transparent pixel of the fish
  ASSERT_FALSE(fish.HitTest(100 - 125/2 + 17, 200 - 117/2 + 16));
+}
+
+TEST(FishBetaTest, MirroredHitTest) {
+ Aquarium aquarium;
+ FishBeta fish(&aquarium);
+ fish.SetLocation(100, 200);
+
+ // Image pixel (40, 10) is opaque, but (84, 10) on the other side is not
+ ASSERT_TRUE(fish.HitTest(78, 152));
+
+ // Once mirrored, the transparent pixel is the one under the mouse
+ fish.SetMirror(true);
+ ASSERT_FALSE(fish.HitTest(78, 152));
+ ASSERT_TRUE(fish.HitTest(100, 200));
 }
\ No newline at end of file
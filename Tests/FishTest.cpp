@@ -0,0 +1,125 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishNemo.h>
+#include <FishGoldeen.h>
+
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Assert that a fish is entirely inside the aquarium
+ * @param aquarium The aquarium
+ * @param fish The fish to test
+ * @param tick Tick number for the failure message
+ */
+static void AssertInside(Aquarium &aquarium, Fish *fish, long tick)
+{
+    double halfWidth = fish->GetFishBitmap()->GetWidth() / 2.0;
+    double halfHeight = fish->GetFishBitmap()->GetHeight() / 2.0;
+
+    ASSERT_GE(fish->GetX() - halfWidth, 0) << "Left of tank at tick " << tick;
+    ASSERT_LE(fish->GetX() + halfWidth, aquarium.GetWidth()) << "Right of tank at tick " << tick;
+    ASSERT_GE(fish->GetY() - halfHeight, 0) << "Above tank at tick " << tick;
+    ASSERT_LE(fish->GetY() + halfHeight, aquarium.GetHeight()) << "Below tank at tick " << tick;
+}
+
+TEST(FishTest, BetaSpeedBounded)
+{
+    Aquarium aquarium;
+    auto fish = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish);
+
+    // An hour of simulated time would have reached ~29000 px/s before
+    for (int i = 0; i < 120000; i++)
+    {
+        fish->Update(0.03);
+        ASSERT_LE(fabs(fish->GetSpeedX()), fish->GetSpeedLimitX());
+    }
+
+    ASSERT_NEAR(fish->GetSpeedLimitX(), fabs(fish->GetSpeedX()), 0.0001);
+}
+
+TEST(FishTest, LargeStepBounces)
+{
+    Aquarium aquarium;
+    auto fish = make_shared<FishGoldeen>(&aquarium);
+    aquarium.Add(fish);
+    fish->SetLocation(500, 400);
+    fish->SetSpeed(200, 10);
+
+    // Far enough in one step to cross the whole tank several times
+    fish->Update(30);
+    AssertInside(aquarium, fish.get(), 0);
+
+    // Mirroring always matches the direction of travel
+    fish->SetSpeed(200, 10);
+    fish->SetLocation(aquarium.GetWidth() - 100, 400);
+    fish->Update(0.5);
+    ASSERT_LT(fish->GetSpeedX(), 0) << "Expected to have bounced off the right wall";
+}
+
+TEST(FishTest, NemoWave)
+{
+    // The wave moves on with the distance swum, wherever the fish is
+    Aquarium aquarium1, aquarium2;
+    auto nemo1 = make_shared<FishNemo>(&aquarium1);
+    auto nemo2 = make_shared<FishNemo>(&aquarium2);
+    aquarium1.Add(nemo1);
+    aquarium2.Add(nemo2);
+    nemo1->SetLocation(300, 300);
+    nemo2->SetLocation(500, 300);
+    nemo1->SetSpeed(50, 5);
+    nemo2->SetSpeed(50, 5);
+
+    double phase = nemo1->GetMotion().mPhase;
+    ASSERT_EQ(phase, nemo2->GetMotion().mPhase);
+
+    for (int i = 0; i < 20; i++)
+    {
+        nemo1->Update(0.03);
+        nemo2->Update(0.03);
+        ASSERT_DOUBLE_EQ(nemo1->GetY(), nemo2->GetY()) << "Tick " << i;
+        ASSERT_DOUBLE_EQ(nemo1->GetX() + 200, nemo2->GetX()) << "Tick " << i;
+    }
+
+    // 30 pixels across at 2 waves per 100 pixels
+    ASSERT_NEAR(nemo1->GetMotion().mPhase, fmod(phase + 0.6, TwoPi), 1e-9);
+}
+
+TEST(FishTest, Soak)
+{
+    Aquarium aquarium;
+
+    vector<shared_ptr<Fish>> fish;
+    fish.push_back(make_shared<FishBeta>(&aquarium));
+    fish.push_back(make_shared<FishBeta>(&aquarium));
+    fish.push_back(make_shared<FishNemo>(&aquarium));
+    fish.push_back(make_shared<FishNemo>(&aquarium));
+    fish.push_back(make_shared<FishGoldeen>(&aquarium));
+    fish.push_back(make_shared<FishGoldeen>(&aquarium));
+    for (auto f : fish)
+    {
+        aquarium.Add(f);
+    }
+
+    const long Ticks = 1000000;
+    for (long tick = 0; tick < Ticks; tick++)
+    {
+        // Mostly normal frames, with the odd long stall thrown in
+        double elapsed = tick % 9973 == 0 ? 12.5 : 0.001 + (tick % 50) * 0.001;
+        aquarium.Update(elapsed);
+
+        for (auto &f : fish)
+        {
+            AssertInside(aquarium, f.get(), tick);
+        }
+
+        if (HasFatalFailure())
+        {
+            return;
+        }
+    }
+}
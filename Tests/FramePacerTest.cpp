@@ -0,0 +1,101 @@
+/**
+ * @file FramePacerTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <FramePacer.h>
+
+using namespace std;
+
+/**
+ * Time a number of milliseconds after a start time
+ * @param start Start time
+ * @param ms Milliseconds after it
+ * @return Time point
+ */
+static FramePacer::Clock::time_point At(FramePacer::Clock::time_point start, double ms)
+{
+    return start + chrono::duration_cast<FramePacer::Clock::duration>(chrono::duration<double, milli>(ms));
+}
+
+TEST(FramePacerTest, Deadlines)
+{
+    FramePacer pacer;
+    pacer.SetTargetRate(50);
+    auto start = FramePacer::Clock::now();
+
+    // The time a frame takes comes out of the wait for the next
+    ASSERT_DOUBLE_EQ(0, pacer.BeginFrame(At(start, 0)));
+    ASSERT_EQ(15, pacer.EndFrame(At(start, 5), false));
+    ASSERT_NEAR(0.005, pacer.GetCost(), 1e-9);
+
+    // A late frame makes the next wait shorter, not later
+    ASSERT_NEAR(0.003, pacer.BeginFrame(At(start, 23)), 1e-9);
+    ASSERT_EQ(12, pacer.EndFrame(At(start, 28), false));
+    ASSERT_EQ(0u, pacer.GetSkipped());
+}
+
+TEST(FramePacerTest, Overload)
+{
+    FramePacer pacer;
+    pacer.SetTargetRate(100);
+    auto start = FramePacer::Clock::now();
+
+    // A frame that runs just past the next deadline is
+    // followed straight away, with nothing skipped
+    pacer.BeginFrame(At(start, 0));
+    ASSERT_EQ(1, pacer.EndFrame(At(start, 12), false));
+    ASSERT_EQ(0u, pacer.GetSkipped());
+
+    // One that runs past several skips the ones it missed
+    // and picks up from the last deadline that passed
+    pacer.BeginFrame(At(start, 12));
+    ASSERT_EQ(1, pacer.EndFrame(At(start, 45), false));
+    ASSERT_EQ(2u, pacer.GetSkipped());
+
+    ASSERT_NEAR(0.005, pacer.BeginFrame(At(start, 45)), 1e-9);
+    ASSERT_EQ(4, pacer.EndFrame(At(start, 46), false));
+    ASSERT_EQ(2u, pacer.GetSkipped());
+}
+
+TEST(FramePacerTest, Idle)
+{
+    FramePacer pacer;
+    pacer.SetTargetRate(60);
+    pacer.SetIdleRate(4);
+    auto start = FramePacer::Clock::now();
+
+    pacer.BeginFrame(At(start, 0));
+    ASSERT_EQ(250, pacer.EndFrame(At(start, 0), true));
+
+    // A change brings the next frame forward to now
+    ASSERT_TRUE(pacer.Wake(At(start, 40)));
+    ASSERT_DOUBLE_EQ(0, pacer.BeginFrame(At(start, 40)));
+    ASSERT_EQ(17, pacer.EndFrame(At(start, 40), false));
+
+    // While running at the target rate there is nothing to wake
+    ASSERT_FALSE(pacer.Wake(At(start, 45)));
+
+    // Rates are kept sensible
+    pacer.SetTargetRate(0);
+    ASSERT_GT(pacer.GetTargetRate(), 0);
+}
+
+TEST(FramePacerTest, FramesPerSecond)
+{
+    FramePacer pacer;
+    pacer.SetTargetRate(20);
+    auto start = FramePacer::Clock::now();
+
+    double time = 0;
+    for (int i = 0; i < 40; i++)
+    {
+        pacer.BeginFrame(At(start, time));
+        time += pacer.EndFrame(At(start, time + 2), false) + 2;
+    }
+
+    ASSERT_NEAR(20, pacer.GetFramesPerSecond(), 0.5);
+    ASSERT_NEAR(0.002, pacer.GetCost(), 1e-9);
+}
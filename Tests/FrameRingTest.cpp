@@ -0,0 +1,194 @@
+/**
+ * @file FrameRingTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <FrameRingReader.h>
+#include <FrameRingWriter.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+
+/// Size of the test frames
+const int FrameWidth = 64;
+
+/// Size of the test frames
+const int FrameHeight = 48;
+
+/**
+ * Make a ring name no other test run will be using
+ * @param test Name of the test
+ * @return Shared memory name
+ */
+static string RingName(const string &test)
+{
+    return "/aquarium-test-" + test + "-" + to_string(getpid());
+}
+
+/**
+ * Fill a frame with a pattern that depends on the frame number
+ * @param frame Frame number
+ * @param stride Bytes per row, at least FrameWidth * 3
+ * @return Pixels
+ */
+static vector<unsigned char> MakeFrame(uint64_t frame, int stride)
+{
+    vector<unsigned char> pixels((size_t)stride * FrameHeight, 0xee);
+    for (int y = 0; y < FrameHeight; y++)
+    {
+        for (int x = 0; x < FrameWidth * 3; x++)
+        {
+            pixels[(size_t)y * stride + x] = (unsigned char)(frame * 7 + x + y * 3);
+        }
+    }
+
+    return pixels;
+}
+
+/**
+ * Check a frame read from a ring has the pattern MakeFrame gave it
+ * @param frame Frame read from the ring
+ * @return True if every pixel is right
+ */
+static bool CheckFrame(const FrameRingReader::Frame &frame)
+{
+    if (frame.mWidth != FrameWidth || frame.mHeight != FrameHeight || frame.mStride != FrameWidth * 3)
+    {
+        return false;
+    }
+
+    for (int y = 0; y < FrameHeight; y++)
+    {
+        for (int x = 0; x < FrameWidth * 3; x++)
+        {
+            if (frame.mPixels[(size_t)y * frame.mStride + x] != (unsigned char)(frame.mFrame * 7 + x + y * 3))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+TEST(FrameRingTest, Integrity)
+{
+    auto name = RingName("integrity");
+    FrameRingWriter writer;
+    ASSERT_TRUE(writer.Create(name, 3, FrameWidth * FrameHeight * 3));
+
+    FrameRingReader reader;
+    ASSERT_TRUE(reader.Open(name));
+    ASSERT_EQ(3u, reader.GetSlotCount());
+
+    FrameRingReader::Frame frame;
+    ASSERT_FALSE(reader.Latest(frame));
+
+    // Rows are packed when they are published
+    auto before = FrameRingWriter::Now();
+    ASSERT_TRUE(writer.Publish(MakeFrame(0, FrameWidth * 3 + 5).data(), FrameWidth, FrameHeight, FrameWidth * 3 + 5));
+    ASSERT_TRUE(reader.Latest(frame));
+    ASSERT_EQ(0u, frame.mFrame);
+    ASSERT_GE(frame.mTimestamp, before);
+    ASSERT_LE(frame.mTimestamp, FrameRingWriter::Now());
+    ASSERT_TRUE(CheckFrame(frame));
+    ASSERT_TRUE(reader.IsCurrent(frame));
+
+    for (uint64_t i = 1; i < 4; i++)
+    {
+        ASSERT_TRUE(writer.Publish(MakeFrame(i, FrameWidth * 3).data(), FrameWidth, FrameHeight, FrameWidth * 3));
+    }
+    ASSERT_EQ(4u, reader.GetPublished());
+
+    // Frame 0's slot now holds frame 3
+    ASSERT_FALSE(reader.IsCurrent(frame));
+    ASSERT_FALSE(reader.Get(0, frame));
+    ASSERT_FALSE(reader.Get(4, frame));
+    for (uint64_t i = 1; i < 4; i++)
+    {
+        ASSERT_TRUE(reader.Get(i, frame));
+        ASSERT_EQ(i, frame.mFrame);
+        ASSERT_TRUE(CheckFrame(frame));
+    }
+
+    // Frames too big for the ring are dropped
+    vector<unsigned char> big((size_t)FrameWidth * 2 * FrameHeight * 3);
+    ASSERT_FALSE(writer.Publish(big.data(), FrameWidth * 2, FrameHeight, FrameWidth * 6));
+    ASSERT_EQ(4u, writer.GetPublished());
+
+    // The ring goes away when the writer closes
+    writer.Close();
+    FrameRingReader late;
+    ASSERT_FALSE(late.Open(name));
+}
+
+TEST(FrameRingTest, Concurrent)
+{
+    auto name = RingName("concurrent");
+    FrameRingWriter writer;
+    ASSERT_TRUE(writer.Create(name, 2, FrameWidth * FrameHeight * 3));
+
+    const uint64_t frames = 2000;
+    vector<vector<unsigned char>> pixels;
+    for (uint64_t i = 0; i < 256; i++)
+    {
+        pixels.push_back(MakeFrame(i, FrameWidth * 3));
+    }
+
+    atomic<bool> done(false);
+    long checked = 0, bad = 0;
+    double totalLatency = 0;
+    thread consumer([&] {
+        FrameRingReader reader;
+        while (!reader.Open(name))
+        {
+            this_thread::yield();
+        }
+
+        uint64_t last = ~0ull;
+        while (!done)
+        {
+            FrameRingReader::Frame frame;
+            if (!reader.Latest(frame) || frame.mFrame == last)
+            {
+                continue;
+            }
+
+            auto now = FrameRingWriter::Now();
+            bool good = CheckFrame(frame);
+
+            // Only frames that weren't overwritten while we read them count
+            if (reader.IsCurrent(frame))
+            {
+                last = frame.mFrame;
+                checked++;
+                bad += good ? 0 : 1;
+                totalLatency += (now - frame.mTimestamp) * 1e-6;
+            }
+        }
+    });
+
+    // With only two slots the writer laps the reader all the time
+    for (uint64_t i = 0; i < frames; i++)
+    {
+        ASSERT_TRUE(writer.Publish(pixels[i % 256].data(), FrameWidth, FrameHeight, FrameWidth * 3));
+        if (i % 16 == 0)
+        {
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+    }
+
+    done = true;
+    consumer.join();
+
+    ASSERT_EQ(frames, writer.GetPublished());
+    ASSERT_GT(checked, 0);
+    ASSERT_EQ(0, bad) << "Torn frames were accepted";
+    ASSERT_LT(totalLatency / checked, 50.0) << "Average latency in ms";
+}
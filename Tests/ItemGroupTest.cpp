@@ -0,0 +1,144 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <ItemGroup.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishNemo.h>
+#include <FishGoldeen.h>
+#include <DecorCastle.h>
+#include <SpeciesRegistry.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Fill an aquarium with a mix of fish and decor, in a jumbled drawing order
+ * @param aquarium Aquarium to fill
+ * @param count Number of fish of each kind
+ * @return The items, in drawing order
+ */
+static vector<shared_ptr<Item>> Populate(Aquarium &aquarium, size_t count)
+{
+    aquarium.Seed(7);
+    aquarium.SetSize(1600, 900);
+
+    vector<shared_ptr<Item>> items;
+    for (size_t i = 0; i < count; i++)
+    {
+        items.push_back(make_shared<FishNemo>(&aquarium));
+        items.push_back(make_shared<FishBeta>(&aquarium));
+        items.push_back(make_shared<FishGoldeen>(&aquarium));
+        if (i % 10 == 0)
+        {
+            items.push_back(make_shared<DecorCastle>(&aquarium));
+        }
+    }
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        items[i]->SetLocation(100 + (i * 37) % 1400, 100 + (i * 53) % 700);
+    }
+
+    return items;
+}
+
+TEST(ItemGroupTest, Groups)
+{
+    Aquarium aquarium;
+    auto items = Populate(aquarium, 20);
+
+    ItemGroups groups;
+    groups.Update(items, 0.03);
+    ASSERT_EQ(groups.GetGroupCount(), 3u);
+    ASSERT_EQ(groups.GetOtherCount(), 2u);      // The castles
+
+    // Removed items are left out once the groups are invalidated
+    items.resize(3);
+    groups.Invalidate();
+    groups.Update(items, 0.03);
+    ASSERT_EQ(groups.GetGroupCount(), 3u);
+    ASSERT_EQ(groups.GetOtherCount(), 1u);
+}
+
+TEST(ItemGroupTest, SameAsVirtual)
+{
+    // Updating a class at a time moves every item the same as
+    // updating them one at a time in drawing order
+    Aquarium aquarium1, aquarium2;
+    auto items1 = Populate(aquarium1, 50);
+    auto items2 = Populate(aquarium2, 50);
+
+    ItemGroups groups;
+    for (int tick = 0; tick < 500; tick++)
+    {
+        groups.Update(items1, 0.03);
+        for (auto &item : items2)
+        {
+            item->Update(0.03);
+        }
+    }
+
+    for (size_t i = 0; i < items1.size(); i++)
+    {
+        ASSERT_EQ(items1[i]->GetX(), items2[i]->GetX()) << "Item " << i;
+        ASSERT_EQ(items1[i]->GetY(), items2[i]->GetY()) << "Item " << i;
+        ASSERT_EQ(items1[i]->GetStateHash(), items2[i]->GetStateHash()) << "Item " << i;
+    }
+}
+
+TEST(ItemGroupTest, SpritePolicy)
+{
+    // Animated species of a built in behaviour get the animated sprite policy
+    auto registry = make_shared<SpeciesRegistry>();
+    Species species = *registry->Find(L"nemo");
+    species.mName = L"flicker";
+    species.mFrames = {L"images/magnemo.png", L"images/magnemo-a.png"};
+    registry->Add(species);
+
+    Aquarium aquarium;
+    aquarium.SetSpecies(registry);
+    auto nemo = aquarium.CreateItem(L"nemo");
+    auto flicker = aquarium.CreateItem(L"flicker");
+    ASSERT_NE(dynamic_pointer_cast<FishNemo>(nemo), nullptr);
+    ASSERT_EQ(dynamic_pointer_cast<FishNemo>(flicker), nullptr);
+
+    // It still swims in a wave
+    using AnimatedNemo = FishT<NemoMotion, AnimatedSprite>;
+    auto animated = dynamic_pointer_cast<AnimatedNemo>(flicker);
+    ASSERT_NE(animated, nullptr);
+    ASSERT_EQ(animated->GetMotion().mWaveAmplitude, species.mWaveAmplitude);
+}
+
+TEST(ItemGroupTest, Benchmark)
+{
+    Aquarium aquarium;
+    auto items = Populate(aquarium, 10000);
+    const int updates = 100;
+
+    auto start = chrono::steady_clock::now();
+    for (int u = 0; u < updates; u++)
+    {
+        for (auto &item : items)
+        {
+            item->Update(0.03);
+        }
+    }
+    auto middle = chrono::steady_clock::now();
+
+    ItemGroups groups;
+    for (int u = 0; u < updates; u++)
+    {
+        groups.Update(items, 0.03);
+    }
+    auto end = chrono::steady_clock::now();
+
+    double itemUpdates = (double)items.size() * updates;
+    cout << "Virtual Update: " << chrono::duration<double, nano>(middle - start).count() / itemUpdates
+         << " ns per item" << endl;
+    cout << "Grouped Update: " << chrono::duration<double, nano>(end - middle).count() / itemUpdates
+         << " ns per item" << endl;
+
+    ASSERT_EQ(groups.GetGroupCount(), 3u);
+}
@@ -0,0 +1,241 @@
+/**
+ * @file MemoryUsageTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <MemoryUsage.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <TankHost.h>
+#include <ThreadPool.h>
+#include <wx/filename.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+
+/// The heap can be measured with mallinfo2
+#define HEAP_MEASURED
+
+/**
+ * Bytes the allocator has handed out on this thread's arena and
+ * not had back, including blocks big enough to be mapped directly
+ * @return Bytes in use
+ */
+static size_t HeapInUse()
+{
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+#endif
+
+using namespace std;
+
+/// Most memory each fish may add, pixels aside
+const size_t PerFishTarget = 512;
+
+TEST(MemoryUsageTest, SharedSprites)
+{
+    Aquarium aquarium;
+    aquarium.Seed(3);
+    aquarium.SetSchooling(true);
+
+    // One of each first, so every sprite is already loaded
+    auto kinds = {L"beta", L"nemo", L"goldeen"};
+    for (auto kind : kinds)
+    {
+        ASSERT_NE(aquarium.Spawn(kind), nullptr);
+    }
+    aquarium.Update(0.03);
+    auto before = aquarium.GetMemoryUsage();
+#ifdef HEAP_MEASURED
+    auto heapBefore = HeapInUse();
+#endif
+
+    const size_t count = 3000;
+    for (size_t i = 0; i < count; i++)
+    {
+        aquarium.Spawn(i % 3 == 0 ? L"beta" : (i % 3 == 1 ? L"nemo" : L"goldeen"));
+    }
+    aquarium.Update(0.03);
+    auto after = aquarium.GetMemoryUsage();
+#ifdef HEAP_MEASURED
+    auto heapAfter = HeapInUse();
+#endif
+
+    // Every fish of a species draws the one sprite the first of them loaded
+    auto &items = aquarium.GetItems();
+    for (size_t i = 3; i < items.size(); i++)
+    {
+        ASSERT_EQ(items[i]->GetSprite(), items[i % 3]->GetSprite()) << "Item " << i;
+    }
+
+    // So more fish don't mean more pixels
+    ASSERT_EQ(after.mPixels, before.mPixels);
+
+    // By the estimate, each fish adds its object and list entries,
+    // and nothing the size of an image
+    size_t perFish = (after.GetTotal() - after.mPixels - (before.GetTotal() - before.mPixels)) / count;
+    ASSERT_GE(perFish, sizeof(FishBeta));
+    ASSERT_LT(perFish, PerFishTarget);
+
+#ifdef HEAP_MEASURED
+    // The allocator agrees. The fish are spawned on this thread, so
+    // everything they allocate comes from the arena measured here.
+    size_t heapPerFish = (heapAfter - heapBefore) / count;
+    ASSERT_GE(heapPerFish, sizeof(FishBeta));
+    ASSERT_LT(heapPerFish, PerFishTarget);
+#endif
+}
+
+/**
+ * Spawn fish into an aquarium until it refuses
+ * @param aquarium Aquarium to fill
+ * @return Number of fish spawned
+ */
+static size_t Fill(Aquarium &aquarium)
+{
+    size_t spawned = 0;
+    while (aquarium.Spawn(L"beta") != nullptr && spawned < 1000)
+    {
+        spawned++;
+    }
+
+    return spawned;
+}
+
+TEST(MemoryUsageTest, Budget)
+{
+    Aquarium aquarium;
+    aquarium.Spawn(L"beta");
+    aquarium.Update(0);
+
+    // Room for about 100 more fish
+    aquarium.SetMemoryBudget(aquarium.GetMemoryUsed() + 100 * sizeof(FishBeta));
+    ASSERT_FALSE(aquarium.IsOverBudget());
+
+    size_t spawned = Fill(aquarium);
+    ASSERT_TRUE(aquarium.IsOverBudget());
+    ASSERT_GT(spawned, 50u);
+    ASSERT_LE(spawned, 100u);
+    ASSERT_EQ(aquarium.GetItems().size(), spawned + 1);
+
+    // Updating doesn't change what counts against the budget
+    aquarium.Update(0.03);
+    ASSERT_TRUE(aquarium.IsOverBudget());
+    ASSERT_TRUE(aquarium.Spawn(L"beta") == nullptr);
+
+    // Removing a fish makes room for exactly one more
+    aquarium.Remove(aquarium.GetItems().back());
+    ASSERT_FALSE(aquarium.IsOverBudget());
+    ASSERT_TRUE(aquarium.Spawn(L"beta") != nullptr);
+    ASSERT_TRUE(aquarium.Spawn(L"beta") == nullptr);
+
+    // Another tank with the same budget takes the same number of fish
+    Aquarium other;
+    other.Spawn(L"beta");
+    other.SetMemoryBudget(aquarium.GetMemoryBudget());
+    ASSERT_EQ(spawned, Fill(other));
+
+    // Fish already in the tank are kept, and lifting the budget lets more in
+    aquarium.SetMemoryBudget(0);
+    ASSERT_FALSE(aquarium.IsOverBudget());
+    ASSERT_TRUE(aquarium.Spawn(L"beta") != nullptr);
+    ASSERT_EQ(aquarium.GetItems().size(), spawned + 2);
+
+    // Clearing the tank frees it all
+    aquarium.Clear();
+    ASSERT_EQ(0u, aquarium.GetMemoryUsed());
+}
+
+TEST(MemoryUsageTest, LoadBudget)
+{
+    Aquarium full;
+    for (int i = 0; i < 100; i++)
+    {
+        full.Spawn(L"beta");
+    }
+
+    auto filename = wxFileName::GetTempDir() + L"/memory-budget.aqua";
+    ASSERT_TRUE(full.Save(filename));
+
+    // A load stops adding items once the budget is used up, and says how many it left out
+    Aquarium aquarium;
+    aquarium.SetMemoryBudget(full.GetMemoryUsed() / 2);
+    ASSERT_TRUE(aquarium.Load(filename));
+    ASSERT_TRUE(aquarium.IsOverBudget());
+    ASSERT_GT(aquarium.GetItems().size(), 40u);
+    ASSERT_LT(aquarium.GetItems().size(), 60u);
+    ASSERT_EQ(100u, aquarium.GetItems().size() + aquarium.GetLoadRefused());
+
+    // Adding directly is refused as well
+    ASSERT_FALSE(aquarium.Add(aquarium.CreateItem(L"beta")));
+
+    // With room for everything, nothing is left out
+    aquarium.SetMemoryBudget(0);
+    ASSERT_TRUE(aquarium.Load(filename));
+    ASSERT_EQ(100u, aquarium.GetItems().size());
+    ASSERT_EQ(0u, aquarium.GetLoadRefused());
+}
+
+TEST(MemoryUsageTest, Xml)
+{
+    Aquarium aquarium;
+    ASSERT_EQ(aquarium.GetMemoryUsage().mXml, 0u);
+    for (int i = 0; i < 100; i++)
+    {
+        aquarium.Spawn(L"beta");
+    }
+
+    // A node per item at the least
+    auto filename = wxFileName::GetTempDir() + L"/memory-usage.aqua";
+    ASSERT_TRUE(aquarium.Save(filename));
+    auto saved = aquarium.GetMemoryUsage().mXml;
+    ASSERT_GT(saved, 100 * sizeof(wxXmlNode));
+
+    // Loading holds the text as well as the tree
+    Aquarium loaded;
+    ASSERT_TRUE(loaded.Load(filename));
+    ASSERT_GT(loaded.GetMemoryUsage().mXml, saved);
+
+    // The largest so far is kept
+    aquarium.Clear();
+    ASSERT_TRUE(aquarium.Save(filename));
+    ASSERT_EQ(aquarium.GetMemoryUsage().mXml, saved);
+}
+
+TEST(MemoryUsageTest, TankHost)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    host.Add();
+    host.GetAquarium(0)->Spawn(L"beta");
+    host.GetAquarium(1)->Spawn(L"beta");
+
+    // Both tanks draw from the same sprites, so they are counted once
+    auto total = host.GetMemoryUsage();
+    auto tank = host.GetAquarium(0)->GetMemoryUsage();
+    ASSERT_EQ(total.mPixels, tank.mPixels);
+    ASSERT_EQ(total.mItems, 2 * tank.mItems);
+
+    // Tanks added later get the budget too
+    host.SetMemoryBudget(1);
+    host.Add();
+    ASSERT_EQ(host.GetAquarium(2)->GetMemoryBudget(), 1u);
+    host.GetAquarium(2)->Spawn(L"beta");
+    ASSERT_TRUE(host.GetAquarium(2)->Spawn(L"beta") == nullptr);
+
+    // Over the image budget every tank draws small items as points
+    ASSERT_GT(host.GetPixelBytes(), 0u);
+    host.SetPixelBudget(host.GetPixelBytes());
+    host.Update(0.03);
+    for (size_t t = 0; t < host.GetCount(); t++)
+    {
+        ASSERT_TRUE(host.GetAquarium(t)->IsReducedDetail());
+    }
+
+    host.SetPixelBudget(0);
+    host.Update(0.03);
+    ASSERT_FALSE(host.GetAquarium(0)->IsReducedDetail());
+}
@@ -0,0 +1,158 @@
+/**
+ * @file MetricsTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <Metrics.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <Sprite.h>
+
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <wx/filename.h>
+
+using namespace std;
+
+TEST(MetricsTest, Registry)
+{
+    Metrics metrics;
+    auto &counter = metrics.Counter("test_things_total", "Things");
+    ASSERT_EQ(&counter, &metrics.Counter("test_things_total", "Things"));
+    counter.Add();
+    counter.Add(4);
+    ASSERT_EQ(5u, counter.Get());
+
+    metrics.Gauge("test_level", "Level").Set(2.5);
+
+    auto &histogram = metrics.Histogram("test_seconds", "Times", {0.1, 1});
+    histogram.Observe(0.05);
+    histogram.Observe(0.1);
+    histogram.Observe(0.5);
+    histogram.Observe(7);
+    ASSERT_EQ(4u, histogram.GetCount());
+    ASSERT_NEAR(7.65, histogram.GetSum(), 0.000001);
+    ASSERT_EQ(2u, histogram.GetCumulative(0));
+    ASSERT_EQ(3u, histogram.GetCumulative(1));
+    ASSERT_EQ(4u, histogram.GetCumulative(2));
+
+    ASSERT_EQ("# HELP test_things_total Things\n"
+              "# TYPE test_things_total counter\n"
+              "test_things_total 5\n"
+              "# HELP test_level Level\n"
+              "# TYPE test_level gauge\n"
+              "test_level 2.5\n"
+              "# HELP test_seconds Times\n"
+              "# TYPE test_seconds histogram\n"
+              "test_seconds_bucket{le=\"0.1\"} 2\n"
+              "test_seconds_bucket{le=\"1\"} 3\n"
+              "test_seconds_bucket{le=\"+Inf\"} 4\n"
+              "test_seconds_sum 7.65\n"
+              "test_seconds_count 4\n", metrics.ToPrometheus());
+}
+
+TEST(MetricsTest, Labels)
+{
+    // Series of one metric are written together, under one help and type
+    Metrics metrics;
+    metrics.Counter("test_things_total", "Things", Metrics::Label("tank", "1")).Add(2);
+    metrics.Gauge("test_level", "Level").Set(1);
+    metrics.Counter("test_things_total", "Things", Metrics::Label("tank", "2")).Add(3);
+    metrics.Histogram("test_seconds", "Times", {1}, Metrics::Label("tank", "2")).Observe(0.5);
+    ASSERT_EQ(2u, metrics.Counter("test_things_total", "", Metrics::Label("tank", "1")).Get());
+
+    ASSERT_EQ("# HELP test_things_total Things\n"
+              "# TYPE test_things_total counter\n"
+              "test_things_total{tank=\"1\"} 2\n"
+              "test_things_total{tank=\"2\"} 3\n"
+              "# HELP test_level Level\n"
+              "# TYPE test_level gauge\n"
+              "test_level 1\n"
+              "# HELP test_seconds Times\n"
+              "# TYPE test_seconds histogram\n"
+              "test_seconds_bucket{tank=\"2\",le=\"1\"} 1\n"
+              "test_seconds_bucket{tank=\"2\",le=\"+Inf\"} 1\n"
+              "test_seconds_sum{tank=\"2\"} 0.5\n"
+              "test_seconds_count{tank=\"2\"} 1\n", metrics.ToPrometheus());
+
+    ASSERT_EQ("name=\"a\\\\b\\\"c\\n\"", Metrics::Label("name", "a\\b\"c\n"));
+}
+
+TEST(MetricsTest, Threads)
+{
+    Metrics metrics;
+    auto &counter = metrics.Counter("test_total", "Count");
+    auto &histogram = metrics.Histogram("test_seconds", "Times");
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; i++)
+            {
+                counter.Add();
+                histogram.Observe(0.001);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(40000u, counter.Get());
+    ASSERT_EQ(40000u, histogram.GetCount());
+    ASSERT_NEAR(40, histogram.GetSum(), 0.000001);
+}
+
+TEST(MetricsTest, Aquarium)
+{
+    auto metrics = Metrics::GetDefault();
+
+    Aquarium aquarium;
+    auto fish = aquarium.Spawn(L"beta");
+    aquarium.Update(0.01);
+
+    auto &updates = metrics->Counter("aquarium_updates_total", "");
+    auto &turns = metrics->Counter("aquarium_item_turns_total", "");
+    auto &hits = metrics->Counter("aquarium_sprite_cache_hits_total", "");
+    auto updateCount = updates.Get();
+    auto turnCount = turns.Get();
+    auto hitCount = hits.Get();
+
+    aquarium.Update(0.01);
+    aquarium.Update(0.01);
+    ASSERT_EQ(updateCount + 2, updates.Get());
+
+    // Only a change of direction is a turn
+    fish->SetMirror(!fish->IsMirror());
+    fish->SetMirror(fish->IsMirror());
+    ASSERT_EQ(turnCount + 1, turns.Get());
+
+    aquarium.Spawn(L"beta");
+    ASSERT_GT(hits.Get(), hitCount);
+
+    auto text = metrics->ToPrometheus();
+    ASSERT_NE(string::npos, text.find("# TYPE aquarium_update_seconds histogram\n"));
+
+    // Each tank's updates are counted on their own
+    Aquarium tank;
+    tank.SetTank(7);
+    auto &tankUpdates = metrics->Counter("aquarium_updates_total", "", Metrics::Label("tank", "7"));
+    auto tankCount = tankUpdates.Get();
+    updateCount = updates.Get();
+    tank.Update(0.01);
+    ASSERT_EQ(tankCount + 1, tankUpdates.Get());
+    ASSERT_EQ(updateCount, updates.Get());
+    ASSERT_NE(string::npos, metrics->ToPrometheus().find("aquarium_update_seconds_count{tank=\"7\"} "));
+
+    auto filename = (wxFileName::GetTempDir() + L"/aquarium-metrics.prom").ToStdString();
+    ASSERT_TRUE(metrics->Dump(filename));
+    ifstream file(filename, ios::binary);
+    string dumped((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    ASSERT_NE(string::npos, dumped.find("aquarium_updates_total "));
+}
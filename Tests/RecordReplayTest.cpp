@@ -0,0 +1,261 @@
+/**
+ * @file RecordReplayTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <SimulationRecorder.h>
+#include <SimulationReplayer.h>
+#include <SpeciesRegistry.h>
+
+#include <fstream>
+#include <iterator>
+#include <wx/filename.h>
+
+using namespace std;
+
+/// Simulated seconds per tick in the recorded sessions
+const double TickTime = 1.0 / 30;
+
+/**
+ * Create a path to a place to put temporary files
+ * @return The temporary path
+ */
+static wxString TempPath()
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    return path;
+}
+
+/**
+ * Record a session that uses every kind of input
+ * @param filename Trace file to write
+ * @return State hash at the end of the session
+ */
+static uint64_t RecordSession(const wxString &filename)
+{
+    // A saved file for the session to load part way through
+    Aquarium saved;
+    saved.Spawn(L"castle");
+    saved.Spawn(L"nemo");
+    saved.Spawn(L"beta");
+    auto savedFile = TempPath() + L"/replay.aqua";
+    saved.Save(savedFile);
+
+    Aquarium aquarium;
+    aquarium.Seed(1234);
+
+    auto recorder = make_shared<SimulationRecorder>();
+    EXPECT_TRUE(recorder->Open(filename.ToStdString(), aquarium.GetSeed()));
+    aquarium.SetRecorder(recorder);
+
+    aquarium.Spawn(L"beta");
+    aquarium.Spawn(L"nemo");
+    aquarium.Spawn(L"goldeen");
+    for (int i = 0; i < 60; i++)
+    {
+        aquarium.Update(TickTime);
+    }
+
+    aquarium.MoveItem(aquarium.GetItems()[0], 500, 300);
+    aquarium.MoveToEnd(aquarium.GetItems()[1]);
+    aquarium.SetSchooling(true);
+    aquarium.SetSize(1600, 900);
+    for (int i = 0; i < 60; i++)
+    {
+        aquarium.Update(TickTime);
+    }
+
+    aquarium.Load(savedFile);
+    aquarium.Spawn(L"goldeen");
+    aquarium.Remove(aquarium.GetItems()[1]);
+    for (int i = 0; i < 60; i++)
+    {
+        aquarium.Update(TickTime);
+    }
+
+    recorder->Close();
+    EXPECT_EQ(180, recorder->GetTicks());
+    return aquarium.GetStateHash();
+}
+
+TEST(RecordReplayTest, Replay)
+{
+    auto filename = TempPath() + L"/session.aqtr";
+    auto hash = RecordSession(filename);
+
+    SimulationReplayer replayer;
+    ASSERT_TRUE(replayer.Open(filename.ToStdString()));
+    ASSERT_EQ(1234u, replayer.GetSeed());
+
+    // Replay into an aquarium in a different state from the recording
+    Aquarium aquarium;
+    aquarium.Spawn(L"castle");
+    aquarium.Update(TickTime);
+
+    ASSERT_TRUE(replayer.Replay(aquarium));
+    ASSERT_EQ(180, replayer.GetTicks());
+    ASSERT_EQ(-1, replayer.GetFirstMismatch());
+    ASSERT_FALSE(replayer.IsTruncated());
+    ASSERT_EQ(hash, aquarium.GetStateHash());
+    ASSERT_EQ(3u, aquarium.GetItems().size());
+    ASSERT_EQ(1600, aquarium.GetWidth());
+    ASSERT_EQ(900, aquarium.GetHeight());
+}
+
+TEST(RecordReplayTest, Divergence)
+{
+    auto filename = TempPath() + L"/session.aqtr";
+    RecordSession(filename);
+
+    // Read the trace and corrupt the hash of the last tick
+    ifstream in(filename.ToStdString(), ios::binary);
+    string trace((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    trace[trace.size() - 1] ^= 1;
+
+    auto tampered = TempPath() + L"/tampered.aqtr";
+    ofstream out(tampered.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size());
+    out.close();
+
+    SimulationReplayer replayer;
+    ASSERT_TRUE(replayer.Open(tampered.ToStdString()));
+
+    Aquarium aquarium;
+    ASSERT_FALSE(replayer.Replay(aquarium));
+    ASSERT_EQ(179, replayer.GetFirstMismatch());
+
+    // A different seed changes the fish speeds, so the
+    // very first tick no longer matches
+    trace[6] ^= 1;
+    out.open(tampered.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size());
+    out.close();
+
+    ASSERT_TRUE(replayer.Open(tampered.ToStdString()));
+    ASSERT_FALSE(replayer.Replay(aquarium));
+    ASSERT_EQ(0, replayer.GetFirstMismatch());
+}
+
+TEST(RecordReplayTest, Truncated)
+{
+    auto filename = TempPath() + L"/session.aqtr";
+    RecordSession(filename);
+
+    SimulationReplayer replayer;
+    ASSERT_FALSE(replayer.Open((TempPath() + L"/missing.aqtr").ToStdString()));
+
+    // Cut the last tick record in half
+    ifstream in(filename.ToStdString(), ios::binary);
+    string trace((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    auto truncated = TempPath() + L"/truncated.aqtr";
+    ofstream out(truncated.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size() - 8);
+    out.close();
+
+    ASSERT_TRUE(replayer.Open(truncated.ToStdString()));
+
+    Aquarium aquarium;
+    ASSERT_FALSE(replayer.Replay(aquarium));
+    ASSERT_TRUE(replayer.IsTruncated());
+    ASSERT_EQ(179, replayer.GetTicks());
+    ASSERT_EQ(-1, replayer.GetFirstMismatch());
+}
+
+TEST(RecordReplayTest, NewerVersion)
+{
+    auto filename = TempPath() + L"/session.aqtr";
+    RecordSession(filename);
+
+    ifstream in(filename.ToStdString(), ios::binary);
+    string trace((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    // A record type added after this version is reported as such, not as damage
+    auto newer = TempPath() + L"/newer.aqtr";
+    ofstream out(newer.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size());
+    out.put((char)200);
+    out.close();
+
+    SimulationReplayer replayer;
+    ASSERT_TRUE(replayer.Open(newer.ToStdString()));
+    ASSERT_FALSE(replayer.IsUnsupportedVersion());
+
+    Aquarium aquarium;
+    ASSERT_FALSE(replayer.Replay(aquarium));
+    ASSERT_EQ(200, replayer.GetUnknownRecord());
+    ASSERT_FALSE(replayer.IsTruncated());
+    ASSERT_EQ(180, replayer.GetTicks());
+
+    // A trace with a later format version isn't replayed at all
+    trace[4] = (char)(SimulationRecorder::Version + 1);
+    out.open(newer.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size());
+    out.close();
+
+    ASSERT_FALSE(replayer.Open(newer.ToStdString()));
+    ASSERT_TRUE(replayer.IsUnsupportedVersion());
+    ASSERT_EQ(SimulationRecorder::Version + 1, replayer.GetVersion());
+
+    // Nor is a file that isn't a trace, which has no version to report
+    trace[0] ^= 1;
+    out.open(newer.ToStdString(), ios::binary);
+    out.write(trace.data(), trace.size());
+    out.close();
+
+    ASSERT_FALSE(replayer.Open(newer.ToStdString()));
+    ASSERT_FALSE(replayer.IsUnsupportedVersion());
+}
+
+TEST(RecordReplayTest, ScriptTime)
+{
+    // A script that reads the time replays the same, even when
+    // the tank had been running before the recording started
+    auto registry = make_shared<SpeciesRegistry>();
+    Species species = *registry->Find(L"nemo");
+    species.mName = L"clock";
+    species.mBehavior = L"script";
+    species.mScript = L"vy = 30 * sin(t)";
+    ASSERT_NE(registry->Add(species), nullptr);
+
+    Aquarium aquarium;
+    aquarium.SetSpecies(registry);
+    for (int i = 0; i < 100; i++)
+    {
+        aquarium.Update(TickTime);
+    }
+
+    aquarium.Seed(42);
+    ASSERT_EQ(0, aquarium.GetTime());
+
+    auto filename = TempPath() + L"/script-time.aqtr";
+    auto recorder = make_shared<SimulationRecorder>();
+    ASSERT_TRUE(recorder->Open(filename.ToStdString(), aquarium.GetSeed()));
+    aquarium.SetRecorder(recorder);
+    aquarium.Spawn(L"clock");
+    for (int i = 0; i < 60; i++)
+    {
+        aquarium.Update(TickTime);
+    }
+    recorder->Close();
+
+    SimulationReplayer replayer;
+    ASSERT_TRUE(replayer.Open(filename.ToStdString()));
+    Aquarium replayed;
+    replayed.SetSpecies(registry);
+    ASSERT_TRUE(replayer.Replay(replayed));
+    ASSERT_EQ(-1, replayer.GetFirstMismatch());
+    ASSERT_EQ(aquarium.GetStateHash(), replayed.GetStateHash());
+}
@@ -0,0 +1,77 @@
+/**
+ * @file ScaledBackgroundTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <ScaledBackground.h>
+#include <Aquarium.h>
+#include <Fish.h>
+#include <Sprite.h>
+#include <ThreadPool.h>
+
+using namespace std;
+
+TEST(ScaledBackgroundTest, Scale)
+{
+    auto sprite = make_shared<Sprite>(Aquarium::BackgroundImage);
+    ScaledBackground background(sprite, make_shared<ThreadPool>(2));
+
+    // The first time a size is asked for it is made on a worker
+    ASSERT_EQ(nullptr, background.GetBitmap(1920, 1080));
+    background.Wait();
+    auto bitmap = background.GetBitmap(1920, 1080);
+    ASSERT_NE(nullptr, bitmap);
+    ASSERT_EQ(1920, bitmap->GetWidth());
+    ASSERT_EQ(1080, bitmap->GetHeight());
+    ASSERT_EQ(1, background.GetScaleCount());
+
+    // After that it is kept until the size changes
+    ASSERT_EQ(bitmap, background.GetBitmap(1920, 1080));
+    ASSERT_EQ(1, background.GetScaleCount());
+
+    ASSERT_EQ(nullptr, background.GetBitmap(7680, 4320));
+    ASSERT_EQ(nullptr, background.GetBitmap(7680, 4320));
+    background.Wait();
+    ASSERT_EQ(2, background.GetScaleCount());
+    ASSERT_EQ(7680, background.GetBitmap(7680, 4320)->GetWidth());
+}
+
+TEST(ScaledBackgroundTest, SharedSource)
+{
+    // Backgrounds scale from the sprite's image, decoding it if
+    // need be, rather than loading a copy of their own
+    auto sprite = make_shared<Sprite>(Aquarium::BackgroundImage, false);
+    auto pool = make_shared<ThreadPool>(2);
+    ScaledBackground first(sprite, pool);
+    ScaledBackground second(sprite, pool);
+
+    ASSERT_EQ(nullptr, first.GetBitmap(640, 480));
+    ASSERT_EQ(nullptr, second.GetBitmap(800, 600));
+    first.Wait();
+    second.Wait();
+    ASSERT_TRUE(sprite->IsReady());
+    ASSERT_EQ(640, first.GetBitmap(640, 480)->GetWidth());
+    ASSERT_EQ(600, second.GetBitmap(800, 600)->GetHeight());
+}
+
+TEST(ScaledBackgroundTest, TankSize)
+{
+    Aquarium aquarium;
+
+    // The tank starts out the size of the background
+    ASSERT_EQ(1024, aquarium.GetWidth());
+    ASSERT_EQ(800, aquarium.GetHeight());
+
+    auto fish = aquarium.Spawn(L"beta");
+    fish->SetLocation(1000, 700);
+
+    // Fish outside a smaller tank swim back in
+    aquarium.SetSize(400, 300);
+    ASSERT_EQ(400, aquarium.GetWidth());
+    ASSERT_EQ(300, aquarium.GetHeight());
+    aquarium.Update(0.01);
+    ASSERT_LE(fish->GetX(), 400);
+    ASSERT_LE(fish->GetY(), 300);
+}
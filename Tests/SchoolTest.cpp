@@ -0,0 +1,130 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishGoldeen.h>
+#include <School.h>
+#include <ThreadPool.h>
+
+#include <atomic>
+#include <cmath>
+
+using namespace std;
+
+TEST(SchoolTest, ParallelFor)
+{
+    ThreadPool pool(4);
+
+    vector<int> visits(10000, 0);
+    pool.ParallelFor(visits.size(), 64, [&visits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            visits[i]++;
+        }
+    });
+
+    for (auto v : visits)
+    {
+        ASSERT_EQ(1, v);
+    }
+
+    // Nested loops on the same pool must not deadlock
+    atomic<int> inner{0};
+    pool.ParallelFor(8, 1, [&pool, &inner](size_t, size_t) {
+        pool.ParallelFor(100, 10, [&inner](size_t begin, size_t end) {
+            inner += (int)(end - begin);
+        });
+    });
+    ASSERT_EQ(800, inner.load());
+}
+
+TEST(SchoolTest, Alignment)
+{
+    Aquarium aquarium;
+
+    // Two Betas close together swimming in different directions
+    auto fish1 = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish1);
+    fish1->SetLocation(400, 400);
+    fish1->SetSpeed(40, 0);
+
+    auto fish2 = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish2);
+    fish2->SetLocation(480, 400);
+    fish2->SetSpeed(0, 40);
+
+    vector<Fish*> fish = {fish1.get(), fish2.get()};
+    School school;
+    for (int i = 0; i < 20; i++)
+    {
+        school.Steer(fish, 0.03);
+    }
+
+    // Headings should have moved towards each other without changing speed
+    double angle1 = atan2(fish1->GetSpeedY(), fish1->GetSpeedX());
+    double angle2 = atan2(fish2->GetSpeedY(), fish2->GetSpeedX());
+    ASSERT_LT(fabs(angle1 - angle2), acos(0.0));
+    ASSERT_NEAR(40, hypot(fish1->GetSpeedX(), fish1->GetSpeedY()), 0.001);
+    ASSERT_NEAR(40, hypot(fish2->GetSpeedX(), fish2->GetSpeedY()), 0.001);
+}
+
+TEST(SchoolTest, OtherSpeciesIgnored)
+{
+    Aquarium aquarium;
+
+    // A Beta and a Goldeen far enough apart not to push on each other
+    auto beta = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(beta);
+    beta->SetLocation(400, 400);
+    beta->SetSpeed(40, 0);
+
+    auto goldeen = make_shared<FishGoldeen>(&aquarium);
+    aquarium.Add(goldeen);
+    goldeen->SetLocation(500, 400);
+    goldeen->SetSpeed(0, 150);
+
+    vector<Fish*> fish = {beta.get(), goldeen.get()};
+    School school;
+    school.Steer(fish, 0.03);
+
+    ASSERT_NEAR(40, beta->GetSpeedX(), 0.0001);
+    ASSERT_NEAR(0, beta->GetSpeedY(), 0.0001);
+}
+
+TEST(SchoolTest, ParallelMatchesSerial)
+{
+    Aquarium aquarium1;
+    Aquarium aquarium2;
+
+    vector<shared_ptr<FishBeta>> fish1, fish2;
+    vector<Fish*> school1, school2;
+    for (int i = 0; i < 1000; i++)
+    {
+        auto a = make_shared<FishBeta>(&aquarium1);
+        auto b = make_shared<FishBeta>(&aquarium2);
+        a->SetLocation(i % 50 * 20, i / 50 * 20);
+        b->SetLocation(i % 50 * 20, i / 50 * 20);
+        a->SetSpeed(20 + i % 7, i % 11 - 5);
+        b->SetSpeed(20 + i % 7, i % 11 - 5);
+        fish1.push_back(a);
+        fish2.push_back(b);
+        school1.push_back(a.get());
+        school2.push_back(b.get());
+    }
+
+    School serial;
+    serial.SetThreadPool(nullptr);
+
+    School parallel;
+    parallel.SetThreadPool(make_shared<ThreadPool>(4));
+    parallel.SetParallelThreshold(1);
+
+    serial.Steer(school1, 0.03);
+    parallel.Steer(school2, 0.03);
+
+    for (size_t i = 0; i < fish1.size(); i++)
+    {
+        ASSERT_EQ(fish1[i]->GetSpeedX(), fish2[i]->GetSpeedX());
+        ASSERT_EQ(fish1[i]->GetSpeedY(), fish2[i]->GetSpeedY());
+    }
+}
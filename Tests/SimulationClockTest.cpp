@@ -0,0 +1,59 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SimulationClock.h>
+
+TEST(SimulationClockTest, RealTime)
+{
+    SimulationClock clock;
+    ASSERT_NEAR(0.03, clock.Advance(0.03), 0.000001);
+    ASSERT_NEAR(0.03, clock.GetTime(), 0.000001);
+
+    // The stopwatch can't run backwards
+    ASSERT_NEAR(0, clock.Advance(-1), 0.000001);
+}
+
+TEST(SimulationClockTest, Speed)
+{
+    SimulationClock clock;
+    clock.SetSpeed(4);
+    ASSERT_NEAR(0.12, clock.Advance(0.03), 0.000001);
+
+    clock.SetSpeed(0.5);
+    ASSERT_NEAR(0.015, clock.Advance(0.03), 0.000001);
+    ASSERT_NEAR(0.135, clock.GetTime(), 0.000001);
+
+    // Speeds are clamped
+    clock.SetSpeed(1000);
+    ASSERT_NEAR(SimulationClock::MaxSpeed, clock.GetSpeed(), 0.000001);
+    clock.SetSpeed(0);
+    ASSERT_NEAR(SimulationClock::MinSpeed, clock.GetSpeed(), 0.000001);
+}
+
+TEST(SimulationClockTest, PauseAndStep)
+{
+    SimulationClock clock;
+    clock.SetStepSize(0.05);
+    clock.SetPaused(true);
+    ASSERT_TRUE(clock.IsPaused());
+    ASSERT_NEAR(0, clock.Advance(0.03), 0.000001);
+
+    // Each step advances exactly one step, whatever the wall time was
+    clock.Step();
+    ASSERT_TRUE(clock.HasPendingSteps());
+    ASSERT_NEAR(0.05, clock.Advance(5), 0.000001);
+    ASSERT_FALSE(clock.HasPendingSteps());
+    ASSERT_NEAR(0, clock.Advance(0.03), 0.000001);
+
+    // Steps queued between advances are taken one per advance
+    clock.Step();
+    clock.Step();
+    ASSERT_NEAR(0.05, clock.Advance(0.03), 0.000001);
+    ASSERT_NEAR(0.05, clock.Advance(0.03), 0.000001);
+    ASSERT_NEAR(0, clock.Advance(0.03), 0.000001);
+    ASSERT_NEAR(0.15, clock.GetTime(), 0.000001);
+
+    // Steps do nothing when running
+    clock.SetPaused(false);
+    clock.Step();
+    ASSERT_NEAR(0.03, clock.Advance(0.03), 0.000001);
+}
@@ -0,0 +1,157 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpatialGrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fill two vectors with random locations
+ * @param count Number of points
+ * @param size Width and height of the area
+ * @param xs X locations
+ * @param ys Y locations
+ */
+static void RandomPoints(size_t count, double size, vector<double> &xs, vector<double> &ys)
+{
+    mt19937 random(1234);
+    uniform_real_distribution<> distribution(0, size);
+    xs.resize(count);
+    ys.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        xs[i] = distribution(random);
+        ys[i] = distribution(random);
+    }
+}
+
+TEST(SpatialGridTest, Empty)
+{
+    SpatialGrid grid(100);
+    grid.Build(vector<double>(), vector<double>());
+
+    vector<size_t> result;
+    ASSERT_EQ(0u, grid.Query(50, 50, 100, result));
+}
+
+TEST(SpatialGridTest, MatchesBruteForce)
+{
+    vector<double> xs, ys;
+    RandomPoints(5000, 2000, xs, ys);
+
+    const double radius = 75;
+    SpatialGrid grid(radius);
+    grid.Build(xs, ys);
+    ASSERT_EQ(xs.size(), grid.GetCount());
+
+    vector<size_t> result;
+    for (size_t q = 0; q < xs.size(); q += 37)
+    {
+        grid.Query(xs[q], ys[q], radius, result);
+        sort(result.begin(), result.end());
+
+        vector<size_t> expected;
+        for (size_t i = 0; i < xs.size(); i++)
+        {
+            double dx = xs[i] - xs[q];
+            double dy = ys[i] - ys[q];
+            if (dx * dx + dy * dy <= radius * radius)
+            {
+                expected.push_back(i);
+            }
+        }
+
+        ASSERT_EQ(expected, result) << "Neighbours of point " << q;
+    }
+}
+
+TEST(SpatialGridTest, OutsideBounds)
+{
+    vector<double> xs = {0, 10, 500};
+    vector<double> ys = {0, 0, 500};
+
+    SpatialGrid grid(50);
+    grid.Build(xs, ys);
+
+    // A query point left of every stored point still finds the close ones
+    vector<size_t> result;
+    grid.Query(-20, 0, 50, result);
+    sort(result.begin(), result.end());
+    ASSERT_EQ(vector<size_t>({0, 1}), result);
+}
+
+TEST(SpatialGridTest, SparsePoints)
+{
+    // Two points very far apart must not allocate a giant grid
+    vector<double> xs = {0, 1e9};
+    vector<double> ys = {0, 1e9};
+
+    SpatialGrid grid(10);
+    grid.Build(xs, ys);
+
+    vector<size_t> result;
+    ASSERT_EQ(1u, grid.Query(1e9, 1e9, 10, result));
+    ASSERT_EQ(1u, result[0]);
+}
+
+TEST(SpatialGridTest, NonFinite)
+{
+    // Bad locations are never neighbours and don't upset the others
+    double nan = numeric_limits<double>::quiet_NaN();
+    double inf = numeric_limits<double>::infinity();
+    vector<double> xs = {nan, 0, 10, inf, 500};
+    vector<double> ys = {0, 0, 0, 5, nan};
+
+    SpatialGrid grid(50);
+    grid.Build(xs, ys);
+    ASSERT_EQ(5u, grid.GetCount());
+
+    vector<size_t> result;
+    grid.Query(0, 0, 50, result);
+    sort(result.begin(), result.end());
+    ASSERT_EQ(vector<size_t>({1, 2}), result);
+    ASSERT_EQ(0u, grid.Query(nan, 0, 50, result));
+
+    // Nothing but bad locations, and a span too wide to measure
+    grid.Build(vector<double>{nan, inf}, vector<double>{nan, -inf});
+    ASSERT_EQ(0u, grid.Query(0, 0, 50, result));
+    grid.Build(vector<double>{-1e308, 1e308}, vector<double>{0, 0});
+    ASSERT_EQ(1u, grid.Query(1e308, 0, 50, result));
+    ASSERT_EQ(1u, result[0]);
+}
+
+TEST(SpatialGridTest, Benchmark)
+{
+    // A large school spread over a large tank
+    vector<double> xs, ys;
+    RandomPoints(100000, 10000, xs, ys);
+
+    const double radius = 100;
+    SpatialGrid grid(radius);
+
+    auto start = chrono::steady_clock::now();
+    grid.Build(xs, ys);
+    auto built = chrono::steady_clock::now();
+
+    size_t found = 0;
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+        grid.ForEachNeighbor(xs[i], ys[i], radius, [&found](size_t, double, double, double) {
+            found++;
+        });
+    }
+    auto end = chrono::steady_clock::now();
+
+    double buildTime = chrono::duration<double>(built - start).count();
+    double queryTime = chrono::duration<double>(end - built).count();
+    cout << "Build " << xs.size() << " points: " << buildTime * 1000 << " ms" << endl;
+    cout << "Queries/sec: " << xs.size() / queryTime
+         << " (" << (double)found / xs.size() << " neighbours each)" << endl;
+
+    ASSERT_GE(found, xs.size());
+}
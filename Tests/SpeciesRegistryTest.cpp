@@ -0,0 +1,233 @@
+/**
+ * @file SpeciesRegistryTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <SpeciesRegistry.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishNemo.h>
+#include <DecorCastle.h>
+
+#include <fstream>
+#include <wx/filename.h>
+
+using namespace std;
+
+TEST(SpeciesRegistryTest, Builtins)
+{
+    Aquarium aquarium;
+    SpeciesRegistry registry;
+
+    for (auto name : {L"beta", L"nemo", L"goldeen", L"castle"})
+    {
+        auto species = registry.Find(name);
+        ASSERT_NE(nullptr, species) << "Missing species " << wxString(name);
+        ASSERT_EQ(name, species->mName);
+    }
+
+    ASSERT_TRUE(registry.Find(L"castle")->mDecor);
+    ASSERT_FALSE(registry.Find(L"beta")->mDecor);
+    ASSERT_EQ(nullptr, registry.Find(L"shark"));
+    ASSERT_EQ(nullptr, registry.Create(L"shark", &aquarium));
+
+    ASSERT_NE(nullptr, dynamic_pointer_cast<FishBeta>(registry.Create(L"beta", &aquarium)));
+    ASSERT_NE(nullptr, dynamic_pointer_cast<FishNemo>(registry.Create(L"nemo", &aquarium)));
+    ASSERT_NE(nullptr, dynamic_pointer_cast<DecorCastle>(registry.Create(L"castle", &aquarium)));
+
+    // The menus list the built in species in the order they always had
+    auto &order = registry.GetSpecies();
+    ASSERT_EQ(4u, order.size());
+    ASSERT_EQ(L"castle", order[0]->mName);
+    ASSERT_EQ(L"beta", order[1]->mName);
+    ASSERT_EQ(L"nemo", order[2]->mName);
+    ASSERT_EQ(L"goldeen", order[3]->mName);
+}
+
+TEST(SpeciesRegistryTest, StartingSpeeds)
+{
+    Aquarium aquarium;
+    auto species = aquarium.GetSpecies()->Find(L"nemo");
+
+    for (int i = 0; i < 100; i++)
+    {
+        auto fish = make_shared<FishNemo>(&aquarium);
+        ASSERT_EQ(species, fish->GetSpecies());
+        ASSERT_GE(fish->GetSpeedX(), species->mMinSpeedX);
+        ASSERT_LE(fish->GetSpeedX(), species->mMaxSpeedX);
+        ASSERT_GE(fish->GetSpeedY(), species->mMinSpeedY);
+        ASSERT_LE(fish->GetSpeedY(), species->mMaxSpeedY);
+        ASSERT_EQ(species->mSpeedLimitX, fish->GetSpeedLimitX());
+        ASSERT_EQ(&species->mSchool, &fish->GetSchoolParameters());
+    }
+}
+
+TEST(SpeciesRegistryTest, Replace)
+{
+    Aquarium aquarium;
+    SpeciesRegistry registry;
+
+    auto fish = dynamic_pointer_cast<Fish>(registry.Create(L"goldeen", &aquarium));
+    auto original = registry.Find(L"goldeen");
+
+    Species faster = *original;
+    faster.mSpeedLimitX = 400;
+    ASSERT_NE(nullptr, registry.Add(faster));
+
+    ASSERT_EQ(400, registry.Find(L"goldeen")->mSpeedLimitX);
+    ASSERT_EQ(4u, registry.GetSpecies().size());
+    ASSERT_EQ(L"goldeen", registry.GetSpecies()[3]->mName);
+
+    // Fish already swimming keep the species they were created with
+    ASSERT_EQ(original, fish->GetSpecies());
+
+    // A species needs a behaviour that exists
+    Species unknown;
+    unknown.mName = L"kraken";
+    unknown.mBehavior = L"kraken";
+    ASSERT_EQ(nullptr, registry.Add(unknown));
+    ASSERT_EQ(nullptr, registry.Find(L"kraken"));
+}
+
+TEST(SpeciesRegistryTest, Load)
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    auto filename = path + L"/species.xml";
+    ofstream file(filename.ToStdString());
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<species>"
+            "<fish name=\"eel\" label=\"&amp;Eel\" image=\"images/goldeen.png\""
+            " min-speed-x=\"5\" max-speed-x=\"10\" limit-x=\"15\" cohesion=\"0.9\"/>"
+            "<decor name=\"rock\" image=\"images/castle.png\"/>"
+            "<fish name=\"zippy\" image=\"images/nemo.png\" behavior=\"beta\"/>"
+            "</species>";
+    file.close();
+
+    SpeciesRegistry registry;
+    ASSERT_TRUE(registry.Load(filename));
+    ASSERT_EQ(7u, registry.GetSpecies().size());
+
+    auto eel = registry.Find(L"eel");
+    ASSERT_NE(nullptr, eel);
+    ASSERT_EQ(L"&Eel", eel->mLabel);
+    ASSERT_FALSE(eel->mDecor);
+    ASSERT_EQ(5, eel->mMinSpeedX);
+    ASSERT_EQ(15, eel->mSpeedLimitX);
+    ASSERT_EQ(0.9, eel->mSchool.mCohesion);
+
+    // Anything not given takes the defaults
+    Species defaults;
+    ASSERT_EQ(defaults.mSpeedLimitY, eel->mSpeedLimitY);
+    ASSERT_EQ(defaults.mSchool.mRadius, eel->mSchool.mRadius);
+
+    auto rock = registry.Find(L"rock");
+    ASSERT_TRUE(rock->mDecor);
+    ASSERT_EQ(L"rock", rock->mLabel);
+
+    Aquarium aquarium;
+    auto fish = dynamic_pointer_cast<Fish>(registry.Create(L"eel", &aquarium));
+    ASSERT_NE(nullptr, fish);
+    ASSERT_GE(fish->GetSpeedX(), 5);
+    ASSERT_LE(fish->GetSpeedX(), 10);
+    ASSERT_NE(nullptr, dynamic_pointer_cast<DecorCastle>(registry.Create(L"rock", &aquarium)));
+    ASSERT_NE(nullptr, dynamic_pointer_cast<FishBeta>(registry.Create(L"zippy", &aquarium)));
+
+    // Items save the type name of their species
+    wxXmlNode root(wxXML_ELEMENT_NODE, L"aqua");
+    auto node = fish->XmlSave(&root);
+    ASSERT_EQ(L"eel", node->GetAttribute(L"type"));
+}
+
+TEST(SpeciesRegistryTest, Tune)
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    auto registry = make_shared<SpeciesRegistry>();
+    Aquarium aquarium;
+    aquarium.SetSpecies(registry);
+
+    auto beta = dynamic_pointer_cast<FishBeta>(aquarium.Spawn(L"beta"));
+    auto nemo = dynamic_pointer_cast<FishNemo>(aquarium.Spawn(L"nemo"));
+    auto betaSpecies = registry->Find(L"beta");
+    auto nemoSpecies = registry->Find(L"nemo");
+    auto minSpeed = betaSpecies->mMinSpeedX;
+    auto version = registry->GetVersion();
+
+    auto filename = path + L"/tune.xml";
+    ofstream file(filename.ToStdString());
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<species>"
+            "<fish name=\"beta\" limit-x=\"20\"/>"
+            "<fish name=\"nemo\" cohesion=\"0.1\" wave-amplitude=\"0\"/>"
+            "</species>";
+    file.close();
+    ASSERT_TRUE(registry->Load(filename));
+
+    // A tuned copy replaces each species, keeping what the file didn't
+    // mention, and the species the fish have now is left alone
+    ASSERT_NE(version, registry->GetVersion());
+    auto tunedBeta = registry->Find(L"beta");
+    auto tunedNemo = registry->Find(L"nemo");
+    ASSERT_NE(betaSpecies, tunedBeta);
+    ASSERT_EQ(20, tunedBeta->mSpeedLimitX);
+    ASSERT_EQ(minSpeed, tunedBeta->mMinSpeedX);
+    ASSERT_EQ(L"beta", tunedBeta->mBehavior);
+    ASSERT_NE(20, betaSpecies->mSpeedLimitX);
+    ASSERT_EQ(0.1, tunedNemo->mSchool.mCohesion);
+    ASSERT_TRUE(SpeciesRegistry::IsTuning(*betaSpecies, *tunedBeta));
+
+    // It takes the old one's place in the menus
+    auto &order = registry->GetSpecies();
+    ASSERT_NE(order.end(), find(order.begin(), order.end(), tunedBeta));
+    ASSERT_EQ(order.end(), find(order.begin(), order.end(), betaSpecies));
+
+    // The fish move to the tuned species on the next tick
+    ASSERT_EQ(betaSpecies, beta->GetSpecies());
+    ASSERT_NE(20, beta->GetSpeedLimitX());
+    aquarium.Update(0.01);
+    ASSERT_EQ(tunedBeta, beta->GetSpecies());
+    ASSERT_EQ(tunedNemo, nemo->GetSpecies());
+    ASSERT_EQ(&tunedNemo->mSchool, &nemo->GetSchoolParameters());
+    ASSERT_EQ(20, beta->GetSpeedLimitX());
+    ASSERT_LE(fabs(beta->GetSpeedX()), 20);
+
+    // With no wave a Nemo only moves at its own speed
+    double y = nemo->GetY();
+    aquarium.Update(0.01);
+    ASSERT_NEAR(y + nemo->GetSpeedY() * 0.01, nemo->GetY(), 0.000001);
+
+    // Changing the image replaces the species instead
+    file.open(filename.ToStdString());
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<species><fish name=\"beta\" image=\"images/nemo.png\" limit-x=\"30\"/></species>";
+    file.close();
+    ASSERT_TRUE(registry->Reload());
+    ASSERT_NE(tunedBeta, registry->Find(L"beta"));
+    ASSERT_EQ(30, registry->Find(L"beta")->mSpeedLimitX);
+    ASSERT_FALSE(SpeciesRegistry::IsTuning(*tunedBeta, *registry->Find(L"beta")));
+    aquarium.Update(0.01);
+    ASSERT_EQ(tunedBeta, beta->GetSpecies());
+    ASSERT_EQ(20, beta->GetSpeedLimitX());
+
+    // A file that isn't a species file changes nothing, and isn't
+    // the file a reload reads
+    auto bad = path + L"/bad-species.xml";
+    file.open(bad.ToStdString());
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua/>";
+    file.close();
+    version = registry->GetVersion();
+    ASSERT_FALSE(registry->Load(bad));
+    ASSERT_EQ(version, registry->GetVersion());
+    ASSERT_EQ(filename, registry->GetFilename());
+}
@@ -0,0 +1,51 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <Sprite.h>
+
+using namespace std;
+
+TEST(SpriteTest, Shared)
+{
+    Aquarium aquarium;
+    FishBeta fish1(&aquarium);
+    FishBeta fish2(&aquarium);
+
+    // Every Beta draws from the same image
+    ASSERT_EQ(fish1.GetSprite(), fish2.GetSprite());
+    ASSERT_EQ(fish1.GetFishImage(), fish2.GetFishImage());
+
+    // Turning around doesn't need a bitmap of its own
+    fish1.SetMirror(true);
+    ASSERT_NE(fish1.GetFishBitmap(), fish2.GetFishBitmap());
+    fish2.SetMirror(true);
+    ASSERT_EQ(fish1.GetFishBitmap(), fish2.GetFishBitmap());
+}
+
+TEST(SpriteTest, MipLevels)
+{
+    Sprite sprite(L"images/beta.png");
+    ASSERT_EQ(125, sprite.GetWidth());
+    ASSERT_EQ(117, sprite.GetHeight());
+
+    // 125 -> 62 -> 31 -> 15 -> 7 -> 3 -> 1
+    ASSERT_EQ(7, sprite.GetLevelCount());
+
+    ASSERT_EQ(62, sprite.GetBitmap(false, 1)->GetWidth());
+    ASSERT_EQ(58, sprite.GetBitmap(false, 1)->GetHeight());
+    ASSERT_EQ(15, sprite.GetBitmap(true, 3)->GetWidth());
+
+    // Levels past the end are clamped to the smallest
+    ASSERT_EQ(1, sprite.GetBitmap(false, 20)->GetWidth());
+}
+
+TEST(SpriteTest, LevelForZoom)
+{
+    ASSERT_EQ(0, Sprite::LevelForZoom(4));
+    ASSERT_EQ(0, Sprite::LevelForZoom(1));
+    ASSERT_EQ(0, Sprite::LevelForZoom(0.6));
+    ASSERT_EQ(1, Sprite::LevelForZoom(0.5));
+    ASSERT_EQ(1, Sprite::LevelForZoom(0.3));
+    ASSERT_EQ(3, Sprite::LevelForZoom(0.125));
+}
@@ -0,0 +1,143 @@
+/**
+ * @file TankHostTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <TankHost.h>
+#include <Aquarium.h>
+#include <Item.h>
+#include <ThreadPool.h>
+#include <SpeciesRegistry.h>
+
+using namespace std;
+
+TEST(TankHostTest, Update)
+{
+    TankHost host(make_shared<ThreadPool>(4));
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_EQ((size_t)i, host.Add());
+    }
+    ASSERT_EQ(8u, host.GetCount());
+
+    // Each tank gets the same fish as a tank updated on its own
+    Aquarium reference;
+    reference.Seed(99);
+    for (size_t t = 0; t < host.GetCount(); t++)
+    {
+        auto aquarium = host.GetAquarium(t);
+        aquarium->Seed(99);
+        aquarium->SetSchooling(true);
+        for (auto type : {L"beta", L"nemo", L"goldeen", L"beta", L"nemo"})
+        {
+            aquarium->Spawn(type);
+        }
+    }
+    reference.SetSchooling(true);
+    for (auto type : {L"beta", L"nemo", L"goldeen", L"beta", L"nemo"})
+    {
+        reference.Spawn(type);
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        host.Update(1.0 / 30);
+        reference.Update(1.0 / 30);
+    }
+
+    // Updating in parallel doesn't change the result
+    for (size_t t = 0; t < host.GetCount(); t++)
+    {
+        ASSERT_EQ(reference.GetStateHash(), host.GetAquarium(t)->GetStateHash());
+        ASSERT_GT(host.GetCpuTime(t), 0);
+        ASSERT_GE(host.GetCpuTime(t), host.GetLastCpuTime(t));
+    }
+
+    // Every tank draws from the same images
+    auto first = host.GetAquarium(0);
+    auto last = host.GetAquarium(host.GetCount() - 1);
+    ASSERT_EQ(first->GetSprites(), last->GetSprites());
+    ASSERT_EQ(host.GetSprites(), first->GetSprites());
+    ASSERT_EQ(first->GetItems()[0]->GetSprite(), last->GetItems()[0]->GetSprite());
+}
+
+TEST(TankHostTest, Clocks)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    host.Add();
+
+    // Each tank keeps its own time
+    host.GetClock(1).SetPaused(true);
+    host.GetClock(0).SetSpeed(2);
+    host.Update(0.5);
+    ASSERT_DOUBLE_EQ(1.0, host.GetAquarium(0)->GetTime());
+    ASSERT_DOUBLE_EQ(0.0, host.GetAquarium(1)->GetTime());
+
+    host.GetClock(1).Step();
+    host.Update(0.5);
+    ASSERT_DOUBLE_EQ(2.0, host.GetAquarium(0)->GetTime());
+    ASSERT_DOUBLE_EQ(host.GetClock(1).GetStepSize(), host.GetAquarium(1)->GetTime());
+}
+
+TEST(TankHostTest, Held)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    host.Add();
+    host.GetAquarium(0)->Spawn(L"nemo");
+
+    // A held tank is left alone while the others carry on
+    host.SetHeld(0, true);
+    ASSERT_TRUE(host.IsHeld(0));
+    ASSERT_TRUE(host.IsIdle());
+    host.Update(0.5);
+    ASSERT_DOUBLE_EQ(0.0, host.GetAquarium(0)->GetTime());
+    ASSERT_DOUBLE_EQ(0.0, host.GetClock(0).GetTime());
+    ASSERT_DOUBLE_EQ(0.5, host.GetAquarium(1)->GetTime());
+
+    // Released, it picks up from where it was
+    host.SetHeld(0, false);
+    ASSERT_FALSE(host.IsIdle());
+    host.Update(0.5);
+    ASSERT_DOUBLE_EQ(0.5, host.GetAquarium(0)->GetTime());
+    ASSERT_DOUBLE_EQ(1.0, host.GetAquarium(1)->GetTime());
+}
+
+TEST(TankHostTest, Idle)
+{
+    TankHost host(make_shared<ThreadPool>(2));
+    host.Add();
+    host.Add();
+
+    // Empty tanks and decor don't move
+    ASSERT_TRUE(host.IsIdle());
+    host.GetAquarium(0)->Spawn(L"castle");
+    ASSERT_TRUE(host.IsIdle());
+
+    // Fish do, unless their tank is paused
+    host.GetAquarium(1)->Spawn(L"nemo");
+    ASSERT_FALSE(host.IsIdle());
+    host.GetClock(1).SetPaused(true);
+    ASSERT_TRUE(host.IsIdle());
+
+    // Until a step is waiting to be taken
+    host.GetClock(1).Step();
+    ASSERT_FALSE(host.IsIdle());
+    host.Update(0.03);
+    ASSERT_TRUE(host.IsIdle());
+
+    // So does animated decor
+    auto registry = make_shared<SpeciesRegistry>();
+    Species species;
+    species.mName = L"blinker";
+    species.mBehavior = L"decor";
+    species.mDecor = true;
+    species.mFrames = {L"images/magnemo.png", L"images/magnemo-a.png"};
+    registry->Add(species);
+    host.GetAquarium(0)->SetSpecies(registry);
+    host.GetAquarium(0)->Spawn(L"blinker");
+    ASSERT_FALSE(host.IsIdle());
+}
@@ -0,0 +1,174 @@
+/**
+ * @file VideoExporterTest.cpp
+ * @author Ismail Abdi
+ */
+
+#include <pch.h>
+#include <gtest/gtest.h>
+#include <VideoExporter.h>
+#include <Aquarium.h>
+#include <ThreadPool.h>
+
+#include <fstream>
+#include <wx/filename.h>
+
+using namespace std;
+
+/**
+ * Get a directory for the test output
+ * @return Directory path
+ */
+static wxString OutputPath()
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    return path;
+}
+
+TEST(VideoExporterTest, Yuv)
+{
+    // Two 2x2 blocks: white and red
+    const unsigned char rgb[] = {
+            255, 255, 255, 255, 255, 255, 255, 0, 0, 255, 0, 0,
+            255, 255, 255, 255, 255, 255, 255, 0, 0, 255, 0, 0};
+    unsigned char yuv[4 * 2 * 3 / 2];
+    VideoExporter::ToYuv420(rgb, 4, 2, yuv);
+
+    // Luma
+    ASSERT_EQ(255, yuv[0]);
+    ASSERT_EQ(255, yuv[5]);
+    ASSERT_EQ(77, yuv[2]);
+    ASSERT_EQ(77, yuv[7]);
+
+    // White has no colour; red is all Cr
+    ASSERT_EQ(128, yuv[8]);
+    ASSERT_EQ(128, yuv[10]);
+    ASSERT_NEAR(85, yuv[9], 1);
+    ASSERT_EQ(255, yuv[11]);
+}
+
+TEST(VideoExporterTest, Y4m)
+{
+    Aquarium aquarium;
+    aquarium.Seed(7);
+    aquarium.SetSize(161, 120);
+    aquarium.Spawn(L"beta");
+    aquarium.Spawn(L"nemo");
+
+    auto filename = (OutputPath() + L"/export.y4m").ToStdString();
+    VideoExporter exporter(make_shared<ThreadPool>(2));
+    exporter.SetFormat(VideoExporter::Format::Y4m);
+    exporter.SetFrameRate(25);
+    ASSERT_TRUE(exporter.Export(aquarium, filename, 10));
+    ASSERT_EQ(10, exporter.GetFrames());
+    ASSERT_GT(exporter.GetFramesPerSecond(), 0);
+
+    // Each frame moved the simulation on one timestep
+    ASSERT_NEAR(10.0 / 25, aquarium.GetTime(), 0.000001);
+
+    // An odd width loses its last column
+    ifstream file(filename, ios::binary);
+    string header;
+    getline(file, header);
+    ASSERT_EQ("YUV4MPEG2 W160 H120 F25:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL", header);
+
+    const size_t frameSize = 160 * 120 * 3 / 2;
+    vector<char> frame(frameSize);
+    vector<char> first;
+    for (int i = 0; i < 10; i++)
+    {
+        string marker;
+        getline(file, marker);
+        ASSERT_EQ("FRAME", marker);
+        ASSERT_TRUE(file.read(frame.data(), frameSize));
+        if (i == 0)
+        {
+            first = frame;
+        }
+    }
+
+    file.peek();
+    ASSERT_TRUE(file.eof());
+
+    // The fish swam
+    ASSERT_NE(first, frame);
+}
+
+TEST(VideoExporterTest, PngSequence)
+{
+    Aquarium aquarium;
+    aquarium.SetSize(200, 150);
+    aquarium.Spawn(L"castle");
+
+    auto path = (OutputPath() + L"/export").ToStdString();
+    ASSERT_EQ(path + "-000012.png", VideoExporter::GetPngFilename(path, 12));
+
+    VideoExporter exporter(make_shared<ThreadPool>(3));
+    ASSERT_TRUE(exporter.Export(aquarium, path, 6));
+    ASSERT_EQ(6, exporter.GetFrames());
+
+    for (long i = 0; i < 6; i++)
+    {
+        wxImage image;
+        ASSERT_TRUE(image.LoadFile(VideoExporter::GetPngFilename(path, i), wxBITMAP_TYPE_PNG));
+        ASSERT_EQ(200, image.GetWidth());
+        ASSERT_EQ(150, image.GetHeight());
+    }
+
+    // Nowhere to write is a failure, not a crash
+    ASSERT_FALSE(exporter.Export(aquarium, path + "/missing/frame", 3));
+    ASSERT_FALSE(exporter.IsCancelled());
+}
+
+TEST(VideoExporterTest, ExportFile)
+{
+    Aquarium aquarium;
+    aquarium.Spawn(L"beta");
+    aquarium.Spawn(L"castle");
+    auto tank = OutputPath() + L"/export-file.aqua";
+    ASSERT_TRUE(aquarium.Save(tank));
+
+    // Rendered straight from the file, with no view
+    VideoExporter exporter(make_shared<ThreadPool>(2));
+    exporter.SetFormat(VideoExporter::Format::Y4m);
+    exporter.SetFrameRate(20);
+    auto filename = (OutputPath() + L"/export-file.y4m").ToStdString();
+    ASSERT_TRUE(exporter.ExportFile(tank.ToStdWstring(), filename, 0.5));
+    ASSERT_EQ(10, exporter.GetFrames());
+
+    // A tank that can't be loaded renders nothing
+    ASSERT_FALSE(exporter.ExportFile((OutputPath() + L"/missing.aqua").ToStdWstring(), filename, 0.5));
+    ASSERT_EQ(0, exporter.GetFrames());
+}
+
+TEST(VideoExporterTest, Cancel)
+{
+    Aquarium aquarium;
+    aquarium.SetSize(160, 120);
+    aquarium.Spawn(L"beta");
+
+    // Stop after the fourth frame of a hundred
+    VideoExporter exporter(make_shared<ThreadPool>(2));
+    exporter.SetFormat(VideoExporter::Format::Y4m);
+    exporter.SetFrameRate(25);
+    long calls = 0;
+    exporter.SetOnProgress([&calls](long frame, long frames) {
+        calls++;
+        EXPECT_EQ(calls, frame);
+        EXPECT_EQ(100, frames);
+        return frame < 4;
+    });
+
+    auto filename = (OutputPath() + L"/cancel.y4m").ToStdString();
+    ASSERT_FALSE(exporter.Export(aquarium, filename, 100));
+    ASSERT_TRUE(exporter.IsCancelled());
+    ASSERT_EQ(4, calls);
+
+    // The frames rendered before the cancel are still written
+    ASSERT_EQ(4, exporter.GetFrames());
+    ASSERT_NEAR(4.0 / 25, aquarium.GetTime(), 0.000001);
+}
@@ -0,0 +1,66 @@
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Viewport.h>
+
+TEST(ViewportTest, Identity)
+{
+    Viewport viewport;
+    viewport.SetSize(1000, 800);
+
+    ASSERT_TRUE(viewport.IsIdentity());
+    ASSERT_NEAR(100, viewport.ToAquariumX(100), 0.0001);
+    ASSERT_NEAR(200, viewport.ToScreenY(200), 0.0001);
+    ASSERT_NEAR(1000, viewport.GetRight(), 0.0001);
+    ASSERT_NEAR(800, viewport.GetBottom(), 0.0001);
+}
+
+TEST(ViewportTest, ZoomAboutPoint)
+{
+    Viewport viewport;
+    viewport.SetSize(1000, 800);
+
+    // The aquarium point under the mouse stays under the mouse
+    double x = viewport.ToAquariumX(300);
+    double y = viewport.ToAquariumY(200);
+    viewport.SetZoom(0.25, 300, 200);
+
+    ASSERT_FALSE(viewport.IsIdentity());
+    ASSERT_NEAR(x, viewport.ToAquariumX(300), 0.0001);
+    ASSERT_NEAR(y, viewport.ToAquariumY(200), 0.0001);
+    ASSERT_NEAR(4000, viewport.GetRight() - viewport.GetLeft(), 0.0001);
+
+    // Zoom is clamped
+    viewport.SetZoom(1000, 0, 0);
+    ASSERT_NEAR(Viewport::MaxZoom, viewport.GetZoom(), 0.0001);
+    viewport.SetZoom(0, 0, 0);
+    ASSERT_NEAR(Viewport::MinZoom, viewport.GetZoom(), 0.0001);
+}
+
+TEST(ViewportTest, Pan)
+{
+    Viewport viewport;
+    viewport.SetSize(1000, 800);
+    viewport.SetZoom(2, 0, 0);
+
+    // Dragging the picture right by 100 screen pixels shows 50 aquarium pixels further left
+    viewport.Pan(100, 0);
+    ASSERT_NEAR(-50, viewport.GetLeft(), 0.0001);
+    ASSERT_NEAR(0, viewport.ToScreenX(-50), 0.0001);
+
+    viewport.Reset();
+    ASSERT_TRUE(viewport.IsIdentity());
+}
+
+TEST(ViewportTest, Culling)
+{
+    Viewport viewport;
+    viewport.SetSize(1000, 800);
+    viewport.Pan(-500, -500);
+
+    // The view now covers 500..1500 by 500..1300
+    ASSERT_TRUE(viewport.IsVisible(600, 600, 700, 700));
+    ASSERT_TRUE(viewport.IsVisible(400, 400, 510, 510)) << "Partly visible";
+    ASSERT_FALSE(viewport.IsVisible(100, 100, 200, 200));
+    ASSERT_FALSE(viewport.IsVisible(1600, 600, 1700, 700));
+    ASSERT_FALSE(viewport.IsVisible(600, 1400, 700, 1500));
+}
@@ -0,0 +1,11 @@
+/**
+ * @file main.cpp
+ * @author Ismail Abdi
+ *
+ * Application entry point.
+ */
+
+#include <pch.h>
+#include "AquariumApp.h"
+
+wxIMPLEMENT_APP(AquariumApp);